@@ -0,0 +1,77 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <map>
+#include <ctime>
+
+#include "RadixTree.hpp"
+#include "GlobMask.hpp"
+#include "TimerWheel.hpp"
+
+#define BANS_FILE "bans.conf"
+#define BAN_KLINE 'K'
+#define BAN_DLINE 'D'
+
+typedef struct {
+	char		type;		// BAN_KLINE (user@host) or BAN_DLINE (ip/cidr)
+	std::string	mask;
+	std::string	reason;
+	std::string	setter;
+	time_t		setAt;
+	time_t		expires;	// 0 = permanent
+}				t_ban;
+
+// A K-line with its compiled user mask
+typedef struct {
+	t_ban		ban;
+	GlobMask	user;
+	GlobMask	host;
+	int			hostIndex;	// where the host part is indexed
+}				t_banentry;
+
+/*
+ * Server bans: D-lines (IP/CIDR) in a radix tree, checked at accept;
+ * K-lines (user@host masks) indexed by host, checked at registration.
+ * Expiries go through a timer wheel, the bans are kept in a file.
+ */
+class BanEngine
+{
+private:
+	std::map<int, t_banentry>					entries;
+	std::map<std::string, int>					ids;		// "K user@host" -> id
+	int											nextId;
+
+	RadixTree									dlines;
+	std::map<std::string, std::vector<int> >	exactHosts;
+	std::map<std::string, std::vector<int> >	hostSuffixes;
+	std::vector<int>							wildHosts;
+	TimerWheel									wheel;
+
+	static std::string	key(char type, const std::string &mask);
+	static void			dropId(std::vector<int> &list, int id);
+	void				index(int id);
+	void				unindex(int id);
+	bool				matchKline(const t_banentry &entry, const std::string &user,
+							const std::string &host, unsigned int addr) const;
+
+public:
+	BanEngine();
+	BanEngine(const BanEngine &src);
+	BanEngine &operator=(const BanEngine &src);
+	~BanEngine();
+
+	static bool	normalize(t_ban &ban);
+
+	bool		add(const t_ban &ban);
+	bool		remove(char type, const std::string &mask);
+	const t_ban	*findDline(unsigned int addr) const;
+	const t_ban	*findKline(const std::string &user, const std::string &host, unsigned int addr) const;
+	void		expire(time_t now, std::vector<t_ban> &expired);
+
+	bool		load(const std::string &path, size_t &added, size_t &removed);
+	bool		save(const std::string &path) const;
+	void		list(char type, std::vector<t_ban> &bans) const;
+
+	size_t		size() const {return (this->entries.size());};
+};
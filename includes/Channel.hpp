@@ -3,9 +3,13 @@
 #include <iostream>
 #include <string>
 #include <set>
+#include <map>
 #include <vector>
 #include <ctime>
 
+#include "MaskList.hpp"
+#include "NamesCache.hpp"
+
 class Channel
 {
 private:
@@ -15,16 +19,30 @@ private:
 	bool			topic_op_only;
 	bool			has_key;
 	int				user_limit;
+	bool			auditorium;		// +u: members only see the operators
 
 	std::string		topic;
 	std::string		topicSetter;
 	time_t			topicTimeSet;
+	time_t			createdAt;
 
 	int				host;
 	std::set<int>	operators;
 	std::set<int>	users;
 	std::set<int>	invited;
 
+	// +b, +e and +I lists
+	MaskList		bans;
+	MaskList		excepts;
+	MaskList		invexes;
+	// Ban state of the members, valid while the generation has not moved
+	unsigned int	banGeneration;
+	mutable std::map<int, std::pair<unsigned int, bool> >	banCache;
+	// Pre-chunked RPL_NAMREPLY payload, patched as members change
+	NamesCache		names;
+
+	MaskList		*maskList(char mode);
+
 public:
 	Channel();
 	Channel(const std::string &name, int creatorFd);
@@ -34,8 +52,9 @@ public:
 
 
 
-	bool	canJoin(int fd, const std::string &key, std::string &reason) const;
-	bool	addMember(int fd);
+	bool	canJoin(int fd, const std::string &hostmask, const std::string &key, char &mode) const;
+	bool	addMember(int fd, const std::string &nick);
+	void	renameMember(int fd, const std::string &nick);
 	bool	removeMember(int fd);
 	bool	isMember(int fd) const;
 	bool	isEmpty() const;
@@ -48,6 +67,7 @@ public:
 
 	void	setInviteOnly(bool on);
 	void	setTopicOpOnly(bool on);
+	void	setAuditorium(bool on);
 	void	setKey(const std::string &key);
 	void	clearKey();
 	void	setUserLimit(int limit);
@@ -60,12 +80,26 @@ public:
 	bool	isInvited(int fd) const;
 	void	clearInvite(int fd);
 
+	const MaskList	*getMaskList(char mode) const;
+	bool	addMask(char mode, const std::string &mask, const std::string &setter);
+	bool	removeMask(char mode, const std::string &mask);
+	bool	isBanned(int fd, const std::string &hostmask) const;
+	bool	isInviteExempt(const std::string &hostmask) const;
+	void	forgetBanState(int fd);
+
 	const std::string	&getName() const;
+	NamesCache			&getNames() {return (this->names);};
 	std::vector<int>	getAllMembers() const;
+	const std::set<int>	&getMemberSet() const {return (this->users);};
+	const std::set<int>	&getAudience(int fd) const;
+	bool				canSee(int viewer, int member) const;
+	size_t				getMemberCount() const {return (this->users.size());};
+	time_t				getCreated() const {return (this->createdAt);};
 	const int 			&getHost() const;
 
 	bool	getInviteOnly() const;
 	bool	getTopicOpOnly() const;
+	bool	getAuditorium() const {return (this->auditorium);};
 	bool	getHasKey() const;
 	int		getUserLimit() const;
 	const std::string &getKey() const;
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <string>
+#include <map>
+#include <ctime>
+
+#include "Channel.hpp"
+
+// Position of a channel in the LIST order
+typedef struct {
+	size_t		members;
+	time_t		created;
+	std::string	name;
+}				t_listkey;
+
+// What LIST shows of a channel besides its key
+typedef struct {
+	std::string	topic;
+	time_t		topicTime;	// 0 if no topic was ever set
+}				t_listtopic;
+
+// Most members first, then oldest first, then by name
+struct ListOrder
+{
+	bool	operator()(const t_listkey &a, const t_listkey &b) const;
+};
+
+/*
+ * Every channel, ordered by population then creation time, with what
+ * LIST prints about it. Kept up to date on join, part, kick, quit and
+ * topic changes so that LIST never scans channelList, and a filter on
+ * member count starts and stops at the right place.
+ */
+class ChannelIndex
+{
+public:
+	typedef std::map<t_listkey, t_listtopic, ListOrder>	t_entries;
+	typedef t_entries::const_iterator					const_iterator;
+
+private:
+	t_entries							entries;
+	std::map<std::string, t_listkey>	keys;		// channel name -> key
+
+public:
+	ChannelIndex();
+	ChannelIndex(const ChannelIndex &src);
+	ChannelIndex &operator=(const ChannelIndex &src);
+	~ChannelIndex();
+
+	void			update(const Channel &channel);
+	void			remove(const std::string &name);
+
+	const_iterator	find(const std::string &name) const;
+	const_iterator	after(const t_listkey &key) const;
+	const_iterator	atMost(size_t members) const;
+
+	const_iterator	begin() const {return (this->entries.begin());};
+	const_iterator	end() const {return (this->entries.end());};
+	size_t			size() const {return (this->entries.size());};
+};
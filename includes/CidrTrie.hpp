@@ -0,0 +1,33 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#define CIDR_MAX_BITS 32
+
+typedef struct {
+	int					child[2];
+	std::vector<int>	values;
+}						t_trienode;
+
+/*
+ * Longest-prefix matching of IPv4 addresses against CIDR ranges.
+ * Nodes live in one vector and point to their children by index.
+ */
+class CidrTrie
+{
+private:
+	std::vector<t_trienode>	nodes;
+
+public:
+	CidrTrie();
+	CidrTrie(const CidrTrie &src);
+	CidrTrie &operator=(const CidrTrie &src);
+	~CidrTrie();
+
+	static bool	parse(const std::string &cidr, unsigned int &addr, int &length);
+
+	void	clear();
+	bool	insert(const std::string &cidr, int value);
+	void	lookup(unsigned int addr, std::vector<int> &matches) const;
+};
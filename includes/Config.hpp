@@ -0,0 +1,30 @@
+#pragma once
+
+#include <string>
+#include <map>
+
+#define CONFIG_FILE "server.conf"
+
+class Config
+{
+private:
+	std::string							path;
+	std::map<std::string, std::string>	values;
+
+public:
+	Config();
+	Config(const Config &src);
+	Config &operator=(const Config &src);
+	~Config();
+
+	bool	load(const std::string &path);
+	bool	reload();
+
+	bool				has(const std::string &key) const;
+	const std::string	get(const std::string &key, const std::string &fallback) const;
+	long				getLong(const std::string &key, long fallback) const;
+	bool				getBool(const std::string &key, bool fallback) const;
+
+	const std::string &getPath() const {return (this->path);};
+	const std::map<std::string, std::string> &getValues() const {return (this->values);};
+};
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+/*
+ * IRC mask ('*' and '?' wildcards) compiled once into its literal parts,
+ * then matched case-insensitively against any number of strings.
+ */
+class GlobMask
+{
+private:
+	std::vector<std::string>	parts;
+	size_t						minLength;
+	bool						wildcard;
+
+	static bool	matchAt(const std::string &part, const std::string &text, size_t pos);
+
+public:
+	GlobMask();
+	GlobMask(const std::string &mask);
+	GlobMask(const GlobMask &src);
+	GlobMask &operator=(const GlobMask &src);
+	~GlobMask();
+
+	void	compile(const std::string &mask);
+	bool	match(const std::string &text) const;
+	bool	isWildcard() const {return (this->wildcard);};
+};
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#define HH_DEPTH 4
+#define HH_WIDTH 2048
+#define HH_TOP_SIZE 10
+#define HH_DECAY_INTERVAL 60
+
+typedef struct {
+	std::string		key;
+	unsigned long	count;
+}					t_hitter;
+
+/*
+ * Streaming heavy-hitter detection with bounded memory:
+ * a Count-Min sketch estimates the count of any key, and only the
+ * top-k keys by estimate are remembered by name.
+ */
+class HeavyHitters
+{
+private:
+	std::vector<unsigned long>	sketch;
+	std::vector<t_hitter>		top;
+	size_t						topSize;
+	unsigned long				total;
+
+	static unsigned long	hash(const std::string &key, unsigned long seed);
+
+public:
+	HeavyHitters();
+	HeavyHitters(const HeavyHitters &src);
+	HeavyHitters &operator=(const HeavyHitters &src);
+	~HeavyHitters();
+
+	void			add(const std::string &key, unsigned long weight);
+	unsigned long	estimate(const std::string &key) const;
+	void			decay();
+
+	std::vector<t_hitter>	getTop() const;
+	unsigned long			getTotal() const {return (this->total);};
+};
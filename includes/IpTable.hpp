@@ -0,0 +1,55 @@
+#pragma once
+
+#include <ctime>
+#include <cstddef>
+#include <vector>
+
+#define IPTABLE_MIN_BITS 8
+#define IPTABLE_NPOS ((size_t)-1)
+#define IPTABLE_FORGET 0.05
+#define IPTABLE_PURGE_INTERVAL 60
+
+typedef struct {
+	bool			used;
+	unsigned int	addr;
+	unsigned int	connections;
+	double			score;
+	time_t			stamp;
+	unsigned int	failures;	// failed PASS/OPER attempts
+	time_t			failStamp;	// time of the last failure
+}					t_ipentry;
+
+/*
+ * Open-addressed hash table of the client addresses: open connections
+ * and a time-decayed count of the recent connection attempts.
+ */
+class IpTable
+{
+private:
+	std::vector<t_ipentry>	entries;
+	unsigned int			bits;
+	size_t					count;
+
+	size_t	home(unsigned int addr) const;
+	size_t	find(unsigned int addr) const;
+	size_t	insert(unsigned int addr, time_t now);
+	void	erase(size_t i);
+	void	grow();
+	static void	decay(t_ipentry &entry, time_t now, long halflife);
+
+public:
+	IpTable();
+	IpTable(const IpTable &src);
+	IpTable &operator=(const IpTable &src);
+	~IpTable();
+
+	const t_ipentry	&attempt(unsigned int addr, time_t now, long halflife);
+	void			connected(unsigned int addr);
+	void			disconnected(unsigned int addr);
+	unsigned int	connections(unsigned int addr) const;
+	unsigned int	fail(unsigned int addr, time_t now, long forget);
+	void			clearFailures(unsigned int addr);
+	void			purge(time_t now, long halflife, long forget);
+
+	size_t	size() const {return (this->count);};
+};
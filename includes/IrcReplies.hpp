@@ -23,6 +23,13 @@
 #define CMD_VERSION "VERSION"
 #define CMD_TIME "TIME"
 #define CMD_PONG "PONG"
+#define CMD_STATS "STATS"
+#define CMD_LUSERS "LUSERS"
+#define CMD_USERS "USERS"
+#define CMD_KLINE "KLINE"
+#define CMD_DLINE "DLINE"
+#define CMD_UNKLINE "UNKLINE"
+#define CMD_UNDLINE "UNDLINE"
 
 // Command lengths
 #define OPER_CMD_LENGTH 5
@@ -37,6 +44,7 @@
 #define WHOIS_CMD_LENGTH 6
 #define VERSION_CMD_LENGTH 8
 #define TIME_CMD_LENGTH 5
+#define STATS_CMD_LENGTH 5
 
 // Server name
 #ifndef SERVER_NAME
@@ -52,25 +60,63 @@
 #define RPL_YOURHOST 002
 #define RPL_CREATED 003
 #define RPL_MYINFO 004
+#define RPL_ISUPPORT 005
 
 // 200-399: Command responses
+#define RPL_STATSLINKINFO 211
+#define RPL_STATSKLINE 216
+#define RPL_STATSDLINE 225
+#define RPL_ENDOFSTATS 219
+#define RPL_UMODEIS 221
+#define RPL_STATSUPTIME 242
+#define RPL_STATSDEBUG 249
+#define RPL_LUSERCLIENT 251
+#define RPL_LUSEROP 252
+#define RPL_LUSERUNKNOWN 253
+#define RPL_LUSERCHANNELS 254
+#define RPL_LUSERME 255
+#define RPL_ADMINME 256
+#define RPL_ADMINLOC1 257
+#define RPL_ADMINLOC2 258
+#define RPL_ADMINEMAIL 259
+#define RPL_LOCALUSERS 265
+#define RPL_GLOBALUSERS 266
 #define RPL_AWAY 301
+#define RPL_USERHOST 302
+#define RPL_ISON 303
 #define RPL_UNAWAY 305
 #define RPL_NOWAWAY 306
 #define RPL_WHOISUSER 311
 #define RPL_WHOISSERVER 312
 #define RPL_WHOISOPERATOR 313
+#define RPL_WHOWASUSER 314
+#define RPL_ENDOFWHO 315
 #define RPL_ENDOFWHOIS 318
 #define RPL_WHOISCHANNELS 319
+#define RPL_LISTSTART 321
 #define RPL_LIST 322
 #define RPL_LISTEND 323
 #define RPL_CHANNELMODEIS 324
 #define RPL_NOTOPIC 331
 #define RPL_TOPIC 332
 #define RPL_INVITING 341
+#define RPL_INVITELIST 346
+#define RPL_ENDOFINVITELIST 347
+#define RPL_EXCEPTLIST 348
+#define RPL_ENDOFEXCEPTLIST 349
 #define RPL_VERSION 351
+#define RPL_WHOREPLY 352
 #define RPL_NAMREPLY 353
+#define RPL_WHOSPCRPL 354
 #define RPL_ENDOFNAMES 366
+#define RPL_INFO 371
+#define RPL_MOTD 372
+#define RPL_ENDOFINFO 374
+#define RPL_MOTDSTART 375
+#define RPL_ENDOFMOTD 376
+#define RPL_BANLIST 367
+#define RPL_ENDOFBANLIST 368
+#define RPL_ENDOFWHOWAS 369
 #define RPL_YOUREOPER 381
 #define RPL_REHASHING 382
 #define RPL_TIME 391
@@ -82,14 +128,19 @@
 // 400-599: Error replies
 #define ERR_NOSUCHNICK 401
 #define ERR_NOSUCHCHANNEL 403
+#define ERR_WASNOSUCHNICK 406
+#define ERR_TOOMANYTARGETS 407
 #define ERR_NOSUCHSERVER 402
+#define ERR_CANNOTSENDTOCHAN 404
 #define ERR_NOORIGIN 409
 #define ERR_NORECIPIENT 411
 #define ERR_NOTEXTTOSEND 412
+#define ERR_NOMOTD 422
 #define ERR_NONICKNAMEGIVEN 431
 #define ERR_ERRONEUSNICKNAME 432
 #define ERR_INVALIDUSERNAME 432
 #define ERR_NICKNAMEINUSE 433
+#define ERR_BANNICKCHANGE 435
 #define ERR_USERONCHANNEL 443
 #define ERR_USERNOTINCHANNEL 441
 #define ERR_NOTONCHANNEL 442
@@ -97,30 +148,45 @@
 #define ERR_NEEDMOREPARAMS 461
 #define ERR_ALREADYREGISTRED 462
 #define ERR_PASSWDMISMATCH 464
+#define ERR_YOUREBANNEDCREEP 465
 #define ERR_CHANNELISFULL 471
 #define ERR_UNKNOWNMODE 472
 #define ERR_INVITEONLYCHAN 473
 #define ERR_BANNEDFROMCHAN 474
 #define ERR_BADCHANNELKEY 475
 #define ERR_BADCHANMASK 476
+#define ERR_BANLISTFULL 478
 #define ERR_NOPRIVILEGES 481
 #define ERR_CHANOPRIVSNEEDED 482
 #define ERR_CANTKILLSERVER 483
 #define ERR_NOOPERHOST 491
 
+// IRCv3 MONITOR
+#define RPL_MONONLINE 730
+#define RPL_MONOFFLINE 731
+#define RPL_MONLIST 732
+#define RPL_ENDOFMONLIST 733
+#define ERR_MONLISTFULL 734
+
 // ============================================================================
 //                          ERROR MESSAGES
 // ============================================================================
 
 #define MSG_ERR_NOSUCHNICK "No such nick/channel"
 #define MSG_ERR_NOSUCHSERVER "No such server"
+#define MSG_ERR_WASNOSUCHNICK "There was no such nickname"
+#define MSG_ERR_TOOMANYTARGETS "Too many targets. Message not delivered"
+#define MSG_ERR_CANNOTSENDTOCHAN "Cannot send to channel"
+#define MSG_ERR_UNKNOWNMODE "is unknown mode char to me"
 #define MSG_ERR_NOORIGIN "No origin specified"
 #define MSG_ERR_NORECIPIENT "No recipient given"
 #define MSG_ERR_NOTEXTTOSEND "No text to send"
+#define MSG_ERR_NOMOTD "MOTD File is missing"
 #define MSG_ERR_NONICKNAMEGIVEN "No nickname given"
 #define MSG_ERR_ERRONEUSNICKNAME "Erroneous nickname"
 #define MSG_ERR_INVALIDNICK "Erroneous nickname"
 #define MSG_ERR_NICKNAMEINUSE "Nickname is already in use"
+#define MSG_ERR_BANNICKCHANGE "Cannot change nickname while banned on channel"
 #define MSG_ERR_WRONGUSER "Invalid username"
 #define MSG_ERR_USERNOTINCHANNEL "They aren't on that channel"
 #define MSG_ERR_USERONCHANNEL "is already on channel"
@@ -129,15 +195,20 @@
 #define MSG_ERR_NEEDMOREPARAMS "Not enough parameters"
 #define MSG_ERR_ALREADYREGISTRED "You may not reregister"
 #define MSG_ERR_PASSWDMISMATCH "Password incorrect"
+#define MSG_ERR_YOUREBANNEDCREEP "You are banned from this server"
 #define MSG_ERR_CHANNELISFULL "Cannot join channel (+l)"
 #define MSG_ERR_INVITEONLYCHAN "Cannot join channel (+i)"
 #define MSG_ERR_BANNEDFROMCHAN "Cannot join channel (+b)"
 #define MSG_ERR_BADCHANNELKEY "Cannot join channel (+k)"
 #define MSG_ERR_BADCHANMASK "Bad Channel Mask"
+#define MSG_ERR_BANLISTFULL "Channel list is full"
 #define MSG_ERR_NOPRIVILEGES "Permission Denied- You're not an IRC operator"
 #define MSG_ERR_CHANOPRIVSNEEDED "You're not channel operator"
 #define MSG_ERR_CANTKILLSERVER "You can't kill a server!"
 #define MSG_ERR_NOOPERHOST "No O-lines for your host"
+#define MSG_ERR_MONLISTFULL "Monitor list is full"
+#define MSG_ERR_UMODEUNKNOWNFLAG "Unknown MODE flag"
+#define MSG_ERR_USERSDONTMATCH "Cannot change mode for other users"
 #define MSG_ERR_SINGLE_SERVER_CONNECT "CONNECT not available in single-server mode"
 #define MSG_ERR_SINGLE_SERVER_SQUIT "Cannot SQUIT this server (single-server mode)"
 
@@ -149,9 +220,22 @@
 #define MSG_RPL_NOWAWAY "You have been marked as being away"
 #define MSG_RPL_YOUREOPER "You are now an IRC operator"
 #define MSG_RPL_REHASHING "Rehashing"
+#define MSG_RPL_ENDOFINFO "End of /INFO list"
+#define MSG_RPL_ENDOFMOTD "End of /MOTD command"
 #define MSG_RPL_ENDOFWHOIS "End of /WHOIS list"
+#define MSG_RPL_ENDOFSTATS "End of /STATS report"
+#define MSG_RPL_LUSEROP "operator(s) online"
+#define MSG_RPL_LUSERUNKNOWN "unknown connection(s)"
+#define MSG_RPL_LUSERCHANNELS "channels formed"
+#define MSG_RPL_LISTSTART "Users  Name"
 #define MSG_RPL_LISTEND "End of /LIST"
+#define MSG_RPL_ENDOFWHO "End of /WHO list"
+#define MSG_RPL_ENDOFWHOWAS "End of WHOWAS"
+#define MSG_RPL_ENDOFMONLIST "End of MONITOR list"
 #define MSG_RPL_ENDOFNAMES "End of /NAMES list"
+#define MSG_RPL_ENDOFBANLIST "End of Channel Ban List"
+#define MSG_RPL_ENDOFEXCEPTLIST "End of Channel Exception List"
+#define MSG_RPL_ENDOFINVITELIST "End of Channel Invite List"
 #define MSG_ERR_NOSUCHCHANNEL "No such channel"
 #define MSG_NOTOPIC "No topic is set"
 #define RPL_TOPICWHOTIME 333
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <map>
+#include <ctime>
+
+#include "GlobMask.hpp"
+
+// Longest list a channel accepts for each of +b, +e and +I
+#define MASKLIST_MAX_ENTRIES 4096
+
+typedef struct {
+	std::string	mask;		// normalized nick!user@host
+	std::string	setter;
+	time_t		setAt;
+}				t_listmask;
+
+// A list mask with its compiled matcher
+typedef struct {
+	t_listmask	info;
+	GlobMask	compiled;
+	int			bucket;		// which index holds it
+	std::string	key;		// its key in that index
+}				t_maskentry;
+
+/*
+ * Channel mask list (+b, +e, +I): nick!user@host masks compiled once and
+ * bucketed on their literal host or nick, so that a check only runs the
+ * few masks that can match instead of the whole list.
+ */
+class MaskList
+{
+private:
+	std::map<int, t_maskentry>					entries;	// by id, in insertion order
+	std::map<std::string, int>					ids;		// lowercase mask -> id
+	int											nextId;
+
+	std::map<std::string, std::vector<int> >	exactHosts;
+	std::map<std::string, std::vector<int> >	hostSuffixes;
+	std::map<std::string, std::vector<int> >	hostPrefixes;
+	std::map<std::string, std::vector<int> >	nicks;
+	std::vector<int>							wild;
+
+	static void	dropId(std::vector<int> &list, int id);
+	void		index(int id);
+	void		unindex(int id);
+	bool		matchAny(const std::vector<int> &list, const std::string &hostmask) const;
+	bool		matchBucket(const std::map<std::string, std::vector<int> > &table,
+							const std::string &key, const std::string &hostmask) const;
+
+public:
+	MaskList();
+	MaskList(const MaskList &src);
+	MaskList &operator=(const MaskList &src);
+	~MaskList();
+
+	static std::string	normalize(const std::string &mask);
+
+	bool	add(const std::string &mask, const std::string &setter, time_t setAt);
+	bool	remove(const std::string &mask);
+	bool	match(const std::string &hostmask) const;
+	void	list(std::vector<t_listmask> &masks) const;
+
+	size_t	size() const {return (this->entries.size());};
+	bool	empty() const {return (this->entries.empty());};
+};
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <string>
+#include <set>
+#include <map>
+
+/*
+ * MONITOR watch lists, kept from both ends: the clients watching each
+ * case-folded nick, so a nick coming or going reaches its watchers with
+ * one lookup, and the nicks each client watches (as it typed them), for
+ * MONITOR L / S and to drop them when it leaves.
+ */
+class MonitorIndex
+{
+private:
+	std::map<std::string, std::set<int> >					watchers;	// nick key -> clients
+	std::map<int, std::map<std::string, std::string> >		targets;	// client -> key -> nick
+
+public:
+	MonitorIndex();
+	MonitorIndex(const MonitorIndex &src);
+	MonitorIndex &operator=(const MonitorIndex &src);
+	~MonitorIndex();
+
+	static std::string	key(const std::string &nick);
+
+	bool	add(int fd, const std::string &nick);
+	void	remove(int fd, const std::string &nick);
+	void	clear(int fd);
+
+	size_t										count(int fd) const;
+	const std::set<int>							*watchersOf(const std::string &nick) const;
+	const std::map<std::string, std::string>	*targetsOf(int fd) const;
+};
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <map>
+
+typedef struct {
+	std::string	nick;
+	bool		op;
+	size_t		chunk;		// index of the chunk holding the token
+}				t_namesentry;
+
+/*
+ * RPL_NAMREPLY payload of a channel: the "@nick" tokens of the members,
+ * already split in chunks that fit one 353 line each. Built on the first
+ * NAMES after it was dropped, then patched in place on join, part, nick
+ * and op changes so that a JOIN only gathers the chunks.
+ */
+class NamesCache
+{
+private:
+	std::vector<std::string>		chunks;
+	std::map<int, t_namesentry>		entries;	// by member fd
+	std::string						header;		// " = <channel> :"
+	size_t							budget;		// longest chunk
+	size_t							bytes;		// tokens and separators
+	bool							built;
+
+	static std::string	token(const t_namesentry &entry);
+	void				place(t_namesentry &entry);
+	void				erase(const t_namesentry &entry);
+
+public:
+	NamesCache();
+	NamesCache(const NamesCache &src);
+	NamesCache &operator=(const NamesCache &src);
+	~NamesCache();
+
+	void	build(const std::string &channel);
+	void	clear();
+	void	add(int fd, const std::string &nick, bool op);
+	void	remove(int fd);
+	void	rename(int fd, const std::string &nick);
+	void	setOperator(int fd, bool op);
+
+	bool							isBuilt() const {return (this->built);};
+	const std::string				&getHeader() const {return (this->header);};
+	const std::vector<std::string>	&getChunks() const {return (this->chunks);};
+};
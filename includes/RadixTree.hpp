@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#define RADIX_BITS 32
+
+typedef struct {
+	unsigned int	key;
+	int				len;
+	int				child[2];
+	int				value;
+}					t_radixnode;
+
+/*
+ * Path-compressed radix tree of IPv4 prefixes, one int value per prefix,
+ * with longest-prefix match. Nodes live in one vector, linked by index.
+ */
+class RadixTree
+{
+private:
+	std::vector<t_radixnode>	nodes;
+	std::vector<int>			freeNodes;
+	int							root;
+	size_t						count;
+
+	static unsigned int	mask(int len);
+	static int			bitAt(unsigned int key, int pos);
+	static int			commonLength(unsigned int a, unsigned int b);
+	int					newNode(unsigned int key, int len, int value);
+	void				link(int parent, int side, int node);
+
+public:
+	RadixTree();
+	RadixTree(const RadixTree &src);
+	RadixTree &operator=(const RadixTree &src);
+	~RadixTree();
+
+	void	insert(unsigned int key, int len, int value);
+	bool	remove(unsigned int key, int len);
+	int		lookup(unsigned int addr) const;
+	int		find(unsigned int key, int len) const;
+	void	clear();
+
+	size_t	size() const {return (this->count);};
+};
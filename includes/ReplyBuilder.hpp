@@ -0,0 +1,57 @@
+#pragma once
+
+#include <string>
+#include <cstddef>
+
+#include "Utils.hpp"
+#include "IrcReplies.hpp"
+
+// Longest line body, the CRLF takes the last two bytes of the 512
+#define REPLY_MAX_BODY (IRC_MAX_MESSAGE_LENGTH - 2)
+
+// ":<server> <code> " rendered by the preprocessor (code expanded first)
+#define REPLY_PREFIX(code) REPLY_PREFIX_(code)
+#define REPLY_PREFIX_(code) {code, ":" SERVER_NAME " " #code " ", sizeof(":" SERVER_NAME " " #code " ") - 1}
+
+typedef struct {
+	int			code;
+	const char	*prefix;	// ":<server> <code> "
+	size_t		length;
+}				t_numericprefix;
+
+/*
+ * Numeric reply composed in a fixed 512-byte line: the ":server NNN "
+ * prefix comes from a table rendered at compile time, the target, the
+ * params and the trailing text are copied behind it, and the result is
+ * handed to sendToClient() as is. Nothing is allocated; anything past
+ * 510 bytes is cut so the CRLF always fits. size() only counts a
+ * finished line.
+ */
+class ReplyBuilder
+{
+private:
+	char	line[IRC_MAX_MESSAGE_LENGTH + 1];
+	size_t	used;
+	bool	finished;	// CRLF written, nothing more is appended
+
+	static const t_numericprefix	*findPrefix(int code);
+
+	ReplyBuilder(const ReplyBuilder &src);
+	ReplyBuilder &operator=(const ReplyBuilder &src);
+
+public:
+	ReplyBuilder();
+	~ReplyBuilder();
+
+	ReplyBuilder	&start(int code);
+	ReplyBuilder	&start(int code, const std::string &target);
+	ReplyBuilder	&append(const char *data, size_t size);
+	ReplyBuilder	&append(const std::string &data) {return (append(data.data(), data.size()));};
+	ReplyBuilder	&param(const std::string &value);
+	ReplyBuilder	&trailing(const std::string &text);
+	const char		*finish();
+
+	const char	*data() const {return (this->line);};
+	size_t		length() const {return (this->used);};
+	size_t		size() const {return (this->finished ? this->used : 0);};
+};
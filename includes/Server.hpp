@@ -13,6 +13,7 @@
 #include <map>
 #include <fcntl.h>
 #include <vector>
+#include <list>
 #include <fstream>
 #include <cstdlib>
 
@@ -20,9 +21,65 @@
 #include "Channel.hpp"
 #include "Utils.hpp"
 #include "IrcReplies.hpp"
+#include "Config.hpp"
+#include "Watchdog.hpp"
+#include "HeavyHitters.hpp"
+#include "CidrTrie.hpp"
+#include "IpTable.hpp"
+#include "BanEngine.hpp"
+#include "ReplyBuilder.hpp"
+#include "StaticReply.hpp"
+#include "ChannelIndex.hpp"
+#include "GlobMask.hpp"
+#include "UserIndex.hpp"
+#include "MonitorIndex.hpp"
+#include "WhowasHistory.hpp"
 
 #define MAX_USER 1024
 #define MAX_EVENTS 10
+#define THROTTLE_POLL_MS 10
+
+// Penalty (fake lag) defaults, overridable in server.conf
+#define PENALTY_CPU_FACTOR 10
+#define PENALTY_SEND_USEC 10
+#define PENALTY_LOOKUP_USEC 1000
+#define PENALTY_THRESHOLD_MS 2000
+#define PENALTY_DISCONNECT_MS 30000
+
+// Default connection class, overridable in server.conf
+#define CLASS_DEFAULT "default"
+#define FLOOD_BURST 10
+#define FLOOD_RATE 2
+#define CLASS_SENDQ 1048576
+#define CLASS_RECVQ 8192
+#define CLASS_MAX_PER_IP 10
+#define CLASS_PING_FREQ 120
+#define CLASS_BUDGET 1
+#define CLASS_CONNECT_BURST 10
+#define CLASS_REGISTER_TIMEOUT 30
+#define CLASS_MONITOR 100
+
+// WHOWAS: records kept, and records answered per nick at most
+#define WHOWAS_SIZE 1000
+#define WHOWAS_MAX_REPLIES 20
+
+// Targets of one PRIVMSG or NOTICE (TARGMAX)
+#define MAX_TARGETS 4
+// Channel broadcasts to this many members or more are queued, and the
+// SendQs written in one pass at the end of the loop iteration
+#define FANOUT_BATCH_MEMBERS 1000
+#define CONNECT_HALFLIFE 30
+
+// Failed PASS/OPER lockout defaults
+#define AUTH_MAX_FAILURES 5
+#define AUTH_BACKOFF_MS 1000
+#define AUTH_BACKOFF_MAX_MS 300000
+#define AUTH_FORGET 600
+
+// Pre-rendered replies defaults
+#define MOTD_FILE "ircd.motd"
+#define ADMIN_LOCATION "ft_irc server"
+#define ADMIN_EMAIL "admin@ircserv"
 
 typedef struct {
 	std::string	dcc;
@@ -34,17 +91,271 @@ typedef struct {
 	uint16_t	realPort;
 }				t_dcc;
 
+typedef struct {
+	std::string	username;
+	std::string	password;
+}				OperParams;
+
+typedef struct {
+	std::string	target;
+	std::string	reason;
+}				KillParams;
+
+// Parsed KLINE/DLINE command
+typedef struct {
+	long		duration;	// minutes, 0 = permanent
+	std::string	mask;
+	std::string	reason;
+}				t_banrequest;
+
+// Cost of a command: handler time * cpuFactor + messages caused * sendUsec
+// + nicks looked up * lookupUsec
+typedef struct {
+	long	cpuFactor;
+	long	sendUsec;
+	long	lookupUsec;
+	long	thresholdUsec;
+	long	disconnectUsec;
+}			t_penalty;
+
+// Connection class, picked at accept time by source CIDR and listener port
+typedef struct {
+	std::string		name;
+	long			port;		// 0 = any listener
+	unsigned long	sendq;		// max bytes waiting to be written
+	unsigned long	recvq;		// max bytes of unprocessed input
+	long			floodBurst;	// token bucket size in lines
+	long			floodRate;	// token bucket refill in lines per second
+	long			maxClients;
+	long			maxPerIp;
+	long			pingFreq;	// seconds of silence before a PING
+	long			budget;		// multiplier of the fake lag allowance
+	long			connectBurst;		// max decayed connection attempts per IP
+	long			registerTimeout;	// seconds to complete registration
+	long			monitor;			// max MONITOR targets per client
+	long			clients;
+}					t_connclass;
+
+// Failed authentication policy: the n-th failure holds the input for
+// backoffMs * 2^(n-1) (at most backoffMaxMs), maxFailures disconnects
+typedef struct {
+	long	maxFailures;
+	long	backoffMs;
+	long	backoffMaxMs;
+	long	forget;		// seconds without failure before the count resets
+}			t_lockout;
+
+// Failures against one OPER account
+typedef struct {
+	unsigned int	count;
+	time_t			stamp;
+}					t_failures;
+
+// Global counters for LUSERS, updated at every state transition
+typedef struct {
+	int	unknown;
+	int	registered;
+	int	invisible;
+	int	opers;
+	int	channels;
+	int	localMax;
+	int	globalMax;
+}		t_lusers;
+
+class Server;
+
+// Channel mode types, as advertised in CHANMODES=A,B,C,D
+#define MODE_TYPE_A 'A'		// list: parameter to change, none to list
+#define MODE_TYPE_B 'B'		// parameter both ways
+#define MODE_TYPE_C 'C'		// parameter only when set
+#define MODE_TYPE_D 'D'		// flag, no parameter
+
+#define MODE_PRIV_ANY 0
+#define MODE_PRIV_CHANOP 1
+
+// Mode parameters per broadcast line, under the 15 parameters of RFC 1459
+#define MODE_LINE_PARAMS 12
+
+// Applies one mode change, may rewrite the parameter shown in the
+// broadcast; returns true if the channel changed
+typedef bool (Server::*t_modeapply)(Channel &chan, const int &clientFd, char letter,
+									bool adding, std::string &param);
+
+typedef struct {
+	char		letter;
+	char		type;		// MODE_TYPE_*
+	int			setPriv;	// needed to change it
+	int			listPriv;	// needed to list it (type A)
+	t_modeapply	apply;
+}				t_chanmode;
+
+typedef struct {
+	char		sign;
+	char		letter;
+	std::string	param;
+}				t_modechange;
+
+// Mode changes of one source on one channel, broadcast together
+typedef struct {
+	std::string					source;
+	std::vector<t_modechange>	changes;
+}				t_modebatch;
+
+// LIST streaming: lines sent and index entries looked at per client and
+// loop iteration, and the part of its SendQ a listing may fill
+#define LIST_BATCH 100
+#define LIST_SCAN 2000
+#define LIST_SENDQ_SHARE 4
+
+// A LIST in progress, with its ELIST filters (times are absolute, 0 = unset)
+typedef struct {
+	size_t						minMembers;		// >N
+	size_t						maxMembers;		// <N
+	time_t						createdAfter;	// C<N
+	time_t						createdBefore;	// C>N
+	time_t						topicAfter;		// T<N
+	time_t						topicBefore;	// T>N
+	std::vector<GlobMask>		masks;
+	std::vector<GlobMask>		notMasks;		// !mask
+	std::vector<std::string>	names;			// exact channel names
+	size_t						nextName;
+	t_listkey					last;			// last index entry gone through
+	bool						started;
+}				t_listcursor;
+
+// WHO streaming: lines sent and candidates looked at per client and loop
+// iteration, and the part of its SendQ a reply may fill
+#define WHO_BATCH 100
+#define WHO_SCAN 2000
+#define WHO_SENDQ_SHARE 4
+
+// Fields a WHO mask is tried on (WHOX n, u, h, i, s and r flags)
+#define WHO_MATCH_NICK 0x01
+#define WHO_MATCH_USER 0x02
+#define WHO_MATCH_HOST 0x04
+#define WHO_MATCH_IP 0x08
+#define WHO_MATCH_SERVER 0x10
+#define WHO_MATCH_REALNAME 0x20
+#define WHO_MATCH_DEFAULT (WHO_MATCH_NICK | WHO_MATCH_USER | WHO_MATCH_HOST \
+                           | WHO_MATCH_SERVER | WHO_MATCH_REALNAME)
+
+// A WHO in progress: candidates from the indexes, matched when sent
+typedef struct {
+	std::string			mask;			// echoed in RPL_ENDOFWHO
+	GlobMask			glob;
+	bool				matchAll;		// no mask, "0" or "*"
+	std::string			channel;		// channel target, empty otherwise
+	bool				member;			// requester is on that channel
+	unsigned int		fields;			// WHO_MATCH_*
+	bool				opersOnly;		// 'o' flag
+	std::string			select;			// WHOX fields after '%', empty for 352
+	std::string			token;			// WHOX query type
+	std::set<int>		neighbours;		// share a channel with the requester
+	std::vector<int>	fds;
+	size_t				next;
+}				t_whocursor;
+
 class Server
 {
 private:
 	int			port;
 	int			socketfd;
 	std::string	password;
-	std::vector<Channel>	channelList;
+	// A list so that creating or dropping a channel never moves the others:
+	// the slots and the Channel references held by callers stay valid
+	std::list<Channel>	channelList;
+	std::map<std::string, std::list<Channel>::iterator>	channelSlots;	// channel name -> its node
 	int			epollFd;
 	epoll_event	event;
 	epoll_event	events[MAX_EVENTS];
 	std::map<int, User>	Users;
+	Config		config;
+	Watchdog	watchdog;
+	t_lusers	lusers;
+	time_t		startTime;
+
+	// Heavy hitters: top talkers by client, source IP and channel
+	HeavyHitters	clientBytes;
+	HeavyHitters	clientLines;
+	HeavyHitters	ipBytes;
+	HeavyHitters	ipLines;
+	HeavyHitters	channelFanout;
+	time_t			lastDecay;
+	unsigned long	lastConnId;		// the client hitters are keyed by connection id
+	std::map<std::string, int>	connFds;	// connection id -> fd of the live clients
+
+	// Per-connection accounting and fake lag
+	t_penalty		penalty;
+	unsigned long	dispatchSends;
+	unsigned long	dispatchLookups;
+
+	// Recipients of a multi-target broadcast are reached once: each one
+	// is stamped (by fd) with the epoch of the last broadcast it got
+	unsigned long				broadcastEpoch;
+	std::vector<unsigned long>	recipientEpochs;
+
+	// Clients whose SendQ was filled by a batched broadcast and has not
+	// been written yet (see FANOUT_BATCH_MEMBERS)
+	size_t						fanoutBatchMembers;
+	std::vector<int>			pendingOutput;
+	std::set<int>	throttled;
+
+	// Connection classes, selected through a CIDR trie at accept time
+	std::vector<t_connclass>	classes;
+	CidrTrie					classTrie;
+	time_t						lastPingCheck;
+
+	// Per-IP open connections and recent connection attempts
+	IpTable						ipTable;
+	long						connectHalflife;
+	time_t						lastPurge;
+
+	// Failed PASS/OPER tracking (per IP in ipTable, per account here)
+	t_lockout							lockout;
+	std::map<std::string, t_failures>	accountFailures;
+
+	// Secret of the host cloaks, hosts are shown as addresses without it
+	std::string					cloakKey;
+
+	// K-lines and D-lines, kept in the bans file
+	BanEngine					bans;
+	std::string					bansPath;
+
+	// Clients to drop once the current iteration is over
+	std::map<int, std::string>	pendingDisconnect;
+
+	// Lowercase nickname -> fd, for every client with a nickname
+	std::map<std::string, int>	nickIndex;
+	std::string					lookupKey;		// reused by findOnlineUser()
+	std::string					lookupReply;	// ISON/USERHOST lines
+
+	// Channel mode table, and the broadcasts held until the end of a
+	// run of MODE commands, by channel name
+	static const t_chanmode				chanModes[];
+	std::map<std::string, t_modebatch>	modeBatches;
+
+	// Replies rendered at startup and on REHASH, sent with one writev()
+	StaticReply					welcomeReply;
+	StaticReply					motdReply;
+	StaticReply					versionReply;
+	StaticReply					infoReply;
+	StaticReply					adminReply;
+	std::vector<struct iovec>	replyIov;
+
+	// Channels in LIST order, and the listings being streamed by fd
+	ChannelIndex					listIndex;
+	std::map<int, t_listcursor>		listCursors;
+
+	// Registered clients by nick, user, host and realname, and the WHO
+	// replies being streamed by fd
+	UserIndex						userIndex;
+	std::map<int, t_whocursor>		whoCursors;
+
+	// Who watches which nick with MONITOR
+	MonitorIndex					monitors;
+
+	// Nicknames given up, for WHOWAS
+	WhowasHistory					whowas;
 public:
 	Server();
 	Server(const Server &src);
@@ -55,13 +366,19 @@ public:
 	void	initSocket();
 	void	initEpoll();
 	void	initServer(const int &port, const std::string &password);
+	bool	loadConfig();
 	void	runServer();
+	void	checkTimers();
 	static void	signalHandler(int signum);
 
 	// Helper functions for NICK command
 	bool	isValidNickname(const std::string &nickname);
 	bool	isNicknameTaken(const std::string &nickname, const int &clientFd);
-	void	broadcastNickChange(const int &clientFd, const std::string &oldNick, const std::string &newNick);
+	void	broadcastNickChange(const int &clientFd, const std::string &oldPrefix, const std::string &newNick);
+	bool	isNickChangeBanned(const int &clientFd, const std::string &newNick);
+	int		findUserByNickname(const std::string &nickname) const;
+	const User	*findOnlineUser(const char *nickname, size_t length);
+	void	indexNickname(const int &clientFd, const std::string &oldNick, const std::string &newNick);
 	void	checkUserRegistration(const int &clientFd);
 
 	int 			findIdByName(const std::string &name) const;
@@ -70,11 +387,43 @@ public:
 
 	void	acceptUser();
 	void	parseInput(int userFd);
+	void	processInput(int userFd);
+	void	processThrottled();
+	bool	isThrottled(const User &user) const;
+	void	chargeCommand(const int &clientFd, long usec);
+	void	beginBroadcast();
+	bool	firstDelivery(int fd);
+	void	sendToClient(const int &clientFd, const std::string &message);
+	void	sendToClient(const int &clientFd, const char *data, size_t length);
+	void	sendToClient(const int &clientFd, const struct iovec *iov, size_t count);
+	void	sendToClient(const int &clientFd, ReplyBuilder &reply);
+	void	queueToClient(const int &clientFd, const std::string &message);
+	bool	batchFanout(size_t members) const;
+	void	flushPendingOutput();
+	void	flushSendQueue(const int &clientFd);
+	void	watchOutput(const int &clientFd, bool enable);
+	void	scheduleDisconnect(const int &clientFd, const std::string &reason);
+	void	reapClients();
+
+	// Connection classes
+	void	loadClasses();
+	void	readClass(t_connclass &cls, const std::string &prefix, const t_connclass &base);
+	int		findClass(unsigned int addr) const;
+	bool	admitConnection(const int &clientFd, unsigned int addr, const std::string &ip);
+	void	refuseConnection(const int &clientFd, const std::string &ip, const std::string &reason);
+	void	releaseConnection(const User &user);
+	void	checkPings(time_t now);
+	const t_connclass	&getClass(const User &user) const;
+	void	disconnectUser(const int &clientFd, const std::string &reason);
 
 	void	handleCap(const int &clientFd, const std::string &line);
 	void	handleNick(const int &clientFd, const std::string &line);
 	void	handleUsername(const int &clientFd, const std::string &line);
 	void	handleLine(const int &clientFd, const std::string &line);
+	void	dispatchCommand(const int &clientFd, const std::string &cmdName, const std::string &command);
+	void	reportStall(const std::string &kind, const t_stall &stall);
+	void	sendServerNotice(const std::string &message);
+	void	sendNotice(const int &clientFd, const std::string &message);
 	void	handleJoin(const int &clientFd, const std::string &line);
 	void	handlePass(const int &clientFd, const std::string &line);
 	void	handleTopic(const int &clientFd, const std::string &line);
@@ -83,10 +432,116 @@ public:
 	void	handleInvite(const int &clientFd, const std::string &line);
 	void	handlePart(const int &clientFd, const std::string &line);
 	void	handleMode(const int & clientFd, const std::string &line);
+	void	handleUserMode(const int &clientFd, const std::string &target, const std::string &modeStr);
+	void	sendMaskList(const int &clientFd, const Channel &channel, char mode);
+	void	sendChannelModes(const int &clientFd, const Channel &channel);
+	const t_chanmode	*findChanMode(char letter) const;
+	void	applyChannelModes(const int &clientFd, Channel &chan, const std::string &modeStr,
+							  const std::vector<std::string> &args);
+	bool	modeFlag(Channel &chan, const int &clientFd, char letter, bool adding, std::string &param);
+	bool	modeKey(Channel &chan, const int &clientFd, char letter, bool adding, std::string &param);
+	bool	modeLimit(Channel &chan, const int &clientFd, char letter, bool adding, std::string &param);
+	bool	modeOperator(Channel &chan, const int &clientFd, char letter, bool adding, std::string &param);
+	bool	modeList(Channel &chan, const int &clientFd, char letter, bool adding, std::string &param);
+	void	queueModeChanges(const int &clientFd, const Channel &chan, const std::vector<t_modechange> &changes);
+	void	broadcastModeChanges(const std::string &channelName, const t_modebatch &batch);
+	void	flushModeBatches();
 
 	
 	// Query commands
 	void	handleWho(const int &clientFd, const std::string &line);
+	void	handleIson(const int &clientFd, const std::string &line);
+	void	handleUserhost(const int &clientFd, const std::string &line);
+	void	handleMonitor(const int &clientFd, const std::string &line);
+	void	handleWhowas(const int &clientFd, const std::string &line);
+	void	sendMonitorItems(const int &clientFd, int code, const std::vector<std::string> &items);
+	void	sendMonitorStatus(const int &clientFd, const std::vector<std::string> &nicks);
+	void	notifyMonitors(const std::string &nick, const std::string &hostmask);
+	void	parseWhoFlags(const std::string &flags, t_whocursor &cursor, bool oper) const;
+	void	collectWho(const int &clientFd, t_whocursor &cursor) const;
+	bool	whoMatches(const t_whocursor &cursor, const User &requester, int targetFd, const User &target) const;
+	void	renderWho(ReplyBuilder &reply, const t_whocursor &cursor, const User &requester,
+			          int targetFd, const User &target, const Channel *channel) const;
+	bool	continueWho(const int &clientFd, t_whocursor &cursor);
+	bool	continueWhos();
+	void	handleStats(const int &clientFd, const std::string &line);
+	void	sendStatsSlowest(const int &clientFd);
+	void	sendStatsUptime(const int &clientFd);
+	void	sendStatsHeavyHitters(const int &clientFd);
+	void	sendStatsConnections(const int &clientFd);
+	void	sendStatsHitters(const int &clientFd, const std::string &title, const HeavyHitters &hitters, bool isClient);
+	void	countChannelFanout(const std::string &channelName, size_t recipients);
+	void	broadcastMembership(const Channel &chan, int fd, const std::string &message);
+	std::list<Channel>::iterator			findChannel(const std::string &name);
+	std::list<Channel>::const_iterator	findChannel(const std::string &name) const;
+	Channel									&addChannel(const Channel &channel);
+	std::list<Channel>::iterator			eraseChannel(std::list<Channel>::iterator channel);
+	void	handleLusers(const int &clientFd, const std::string &line);
+	void	sendLusers(const int &clientFd);
+	void	handleUsers(const int &clientFd, const std::string &line);
+	void	sendLocalGlobalUsers(const int &clientFd);
+	bool	isLocalServerTarget(const int &clientFd, const std::string &line);
+	std::vector<std::string>	parseNamesCommand(const std::string &line);
+	void	handleNames(const int &clientFd, const std::string &line);
+	void	handleList(const int &clientFd, const std::string &line);
+	void	parseListFilter(const std::string &filter, t_listcursor &cursor) const;
+	bool	listMatches(const t_listcursor &cursor, const t_listkey &key, const t_listtopic &topic) const;
+	bool	continueListing(const int &clientFd, t_listcursor &cursor);
+	bool	continueListings();
+	void	handleMotd(const int &clientFd, const std::string &line);
+	void	handleVersion(const int &clientFd, const std::string &line);
+	void	handleInfo(const int &clientFd, const std::string &line);
+	void	handleAdmin(const int &clientFd, const std::string &line);
+
+	// Pre-rendered replies
+	void	renderStaticReplies();
+	void	renderWelcome(StaticReply &reply) const;
+	bool	renderMotd(StaticReply &reply, const std::string &path) const;
+	void	renderVersion(StaticReply &reply) const;
+	void	renderInfo(StaticReply &reply) const;
+	void	renderAdmin(StaticReply &reply) const;
+	void	sendStaticReply(const int &clientFd, const StaticReply &reply);
+
+	// QUIT command
+	std::string	parseQuitMessage(const std::string &line);
+	void		broadcastQuit(const int &clientFd, const std::string &quitMsg);
+	void		removeFromAllChannels(const int &clientFd);
+	void		handleQuit(const int &clientFd, const std::string &line);
+
+	// OPER command
+	OperParams	parseOperCommand(const std::string &line);
+	bool		validateOperCredentials(const std::string &username, const std::string &password);
+	void		handleOper(const int &clientFd, const std::string &line);
+
+	// Failed PASS/OPER lockout
+	long	authBackoffMs(unsigned int failures) const;
+	void	authFailed(const int &clientFd, const std::string &account);
+	void	authSucceeded(const int &clientFd, const std::string &account);
+	bool	isAccountLocked(const std::string &account, time_t now) const;
+	void	purgeAccountFailures(time_t now);
+
+	// KILL command
+	KillParams	parseKillCommand(const std::string &line);
+	void		handleKill(const int &clientFd, const std::string &line);
+
+	// REHASH command
+	bool	reloadConfiguration();
+	void	handleRehash(const int &clientFd, const std::string &line);
+
+	// KLINE / DLINE commands
+	t_banrequest	parseBanCommand(int cmdLength, const std::string &line);
+	void	addBan(const int &clientFd, char type, const std::string &command, const std::string &line);
+	void	removeBan(const int &clientFd, char type, const std::string &command, const std::string &line);
+	const t_ban	*findKline(const User &user) const;
+	void	enforceBan(const t_ban &ban);
+	void	handleKline(const int &clientFd, const std::string &line);
+	void	handleDline(const int &clientFd, const std::string &line);
+	void	handleUnkline(const int &clientFd, const std::string &line);
+	void	handleUndline(const int &clientFd, const std::string &line);
+	bool	loadBans();
+	void	saveBans();
+	void	expireBans(time_t now);
+	void	sendStatsBans(const int &clientFd, char type);
 
 	// KICK
 	const	std::string getUserToKick(const std::string &line) const;
@@ -105,6 +560,8 @@ public:
 
 
 	void		handlePrivateMessage(int clientFd, const std::string &line);
+	void		relayMessage(const int &clientFd, const std::string &command, const std::string &targets,
+				             const std::string &text);
 	void		sendPrivateMessage(const std::string &targetNick, const std::string &message, int senderFd);
 
 	void 		execMode(int clientFd, const std::string &channelName, const std::string &mode, std::string arg);
@@ -127,11 +584,13 @@ public:
 	void	sendRPL_TOPIC(const int &clientFd, const Channel &channel);
 	void	sendRPL_NOTOPIC(const int &clientFd, const Channel &channel);
 	void	sendRPL_INVITED(const int &clientFd, const std::string &toInvite, const Channel &channel);
-	void	sendRPL_NAMEREPLY(const int &clientFd, Channel &channel);
+	void	sendNames(const int &clientFd, Channel &channel);
+	void	sendAuditoriumNames(const int &clientFd, const Channel &channel);
 	void	sendRPL_ENDOFNAMES(const int &clientFd, Channel &channel);
 
 	// IrcReplies.hpp - Error and reply functions
 	void sendNumericReply(const int &clientFd, int code, const std::string &params, const std::string &message);
+	void sendNumericReply(const int &clientFd, int code, const std::string &param, const std::string &param2, const std::string &message);
 	void sendERR_NOSUCHNICK(const int &clientFd, const std::string &nickname);
 	void sendERR_NOSUCHSERVER(const int &clientFd, const std::string &servername);
 	void sendERR_NOSUCHCHANNEL(const int &clientFd, const std::string &channel);
@@ -145,7 +604,6 @@ public:
 	void sendERR_NOTOPLEVEL(const int &clientFd, const std::string &mask);
 	void sendERR_WILDTOPLEVEL(const int &clientFd, const std::string &mask);
 	void sendERR_UNKNOWNCOMMAND(const int &clientFd, const std::string &command);
-	void sendERR_NOMOTD(const int &clientFd);
 	void sendERR_NOADMININFO(const int &clientFd, const std::string &server);
 	void sendERR_FILEERROR(const int &clientFd, const std::string &fileop, const std::string &file);
 	void sendERR_NONICKNAMEGIVEN(const int &clientFd);
@@ -167,6 +625,8 @@ public:
 	void sendERR_UNKNOWNMODE(const int &clientFd, char c);
 	void sendERR_INVITEONLYCHAN(const int &clientFd, const std::string &channel);
 	void sendERR_BANNEDFROMCHAN(const int &clientFd, const std::string &channel);
+	void sendERR_BANLISTFULL(const int &clientFd, const std::string &channel, const std::string &mask);
+	void sendERR_BANNICKCHANGE(const int &clientFd, const std::string &nick, const std::string &channel);
 	void sendERR_BADCHANNELKEY(const int &clientFd, const std::string &channel);
 	void sendERR_NOPRIVILEGES(const int &clientFd);
 	void sendERR_CHANOPRIVSNEEDED(const int &clientFd, const std::string &channel);
@@ -189,15 +649,22 @@ public:
 	void sendRPL_LISTSTART(const int &clientFd);
 	void sendRPL_LIST(const int &clientFd, const std::string &channel, int visible, const std::string &topic);
 	void sendRPL_LISTEND(const int &clientFd);
+	void sendRPL_ENDOFWHO(const int &clientFd, const std::string &mask);
 	void sendRPL_CHANNELMODEIS(const int &clientFd, const std::string &channel, const std::string &mode, const std::string &mode_params);
 	void sendRPL_NOTOPIC(const int &clientFd, const std::string &channel);
-	void sendRPL_VERSION(const int &clientFd, const std::string &version, const std::string &debuglevel, const std::string &server, const std::string &comments);
 	void sendRPL_TIME(const int &clientFd, const std::string &server, const std::string &timestr);
 	
 	void sendERR_NEEDMOREPARAMS(const int &clientFd, const std::string &command);
 	void sendERR_BADCHANMASK(const int &clientFd, const std::string &channel);
 	void sendRPL_YOUREOPER(const int &clientFd);
 	void sendRPL_REHASHING(const int &clientFd);
+	void sendRPL_UMODEIS(const int &clientFd, const std::string &modes);
+	void sendERR_YOUREBANNEDCREEP(const int &clientFd, const std::string &reason);
+	void sendRPL_STATSLINKINFO(const int &clientFd, const std::string &link, const std::string &info);
+	void sendRPL_STATSDEBUG(const int &clientFd, const std::string &text);
+	void sendRPL_ENDOFSTATS(const int &clientFd, const std::string &query);
+	void sendRPL_MASKLIST(const int &clientFd, const std::string &channel, char mode, const t_listmask &entry);
+	void sendRPL_ENDOFMASKLIST(const int &clientFd, const std::string &channel, char mode);
 	void sendError(const int &clientFd, const std::string &message);
 
 	// AWAY command
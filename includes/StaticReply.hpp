@@ -0,0 +1,31 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <sys/uio.h>
+
+/*
+ * Multi-line reply rendered once (welcome burst, MOTD, VERSION, INFO,
+ * ADMIN) with holes where the recipient's nickname goes. Sending it
+ * only gathers iovecs over the shared text and the nickname, it is
+ * never formatted again until the next REHASH replaces it.
+ */
+class StaticReply
+{
+private:
+	std::string			text;	// every line, nicknames left out
+	std::vector<size_t>	holes;	// offsets in text where the nickname goes
+
+public:
+	StaticReply();
+	StaticReply(const StaticReply &src);
+	StaticReply &operator=(const StaticReply &src);
+	~StaticReply();
+
+	void	addLine(int code, const std::string &params, const std::string &trailing, bool nickInTrailing = false);
+	void	fill(std::vector<struct iovec> &iov, const std::string &nick) const;
+	void	swap(StaticReply &other);
+
+	bool	empty() const {return (this->text.empty());};
+	size_t	size() const {return (this->text.size());};
+};
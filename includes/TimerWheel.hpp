@@ -0,0 +1,37 @@
+#pragma once
+
+#include <ctime>
+#include <cstddef>
+#include <vector>
+
+#define WHEEL_SLOTS 512
+
+typedef struct {
+	time_t	when;
+	int		id;
+}			t_timer;
+
+/*
+ * Hashed timing wheel with a one-second resolution, for expiries that
+ * can be far away (bans): a timer stays in its slot for as many rounds
+ * as needed.
+ */
+class TimerWheel
+{
+private:
+	std::vector<std::vector<t_timer> >	slots;
+	time_t								current;
+	size_t								count;
+
+public:
+	TimerWheel();
+	TimerWheel(const TimerWheel &src);
+	TimerWheel &operator=(const TimerWheel &src);
+	~TimerWheel();
+
+	void	schedule(time_t when, int id);
+	void	advance(time_t now, std::vector<int> &fired);
+	void	clear();
+
+	size_t	size() const {return (this->count);};
+};
@@ -2,22 +2,65 @@
 
 #include <iostream>
 #include <unistd.h>
+#include <ctime>
+#include <set>
+
+#define FLOOD_TOKEN_UNIT 1000
 
 class User
 {
 private:
 	std::string	nickname;
 	std::string	username;
+	std::string	realname;
 	int			fd;
+	std::string	connId;		// never reused, unlike the fd
 	std::string	ip;
+	unsigned int	addr;
+
+	// Shown host (address or cloak) and the prefix built from it, rebuilt
+	// only when the nick, username or host change
+	std::string	host;
+	std::string	hostmask;	// nick!user@host
+	std::string	prefix;		// ":nick!user@host", spliced into every message
+
+	void	updatePrefix();
 
 	std::string	buffer;
 	bool		hasNickname;
 	bool		hasUsername;
 	bool		hasPass;
 	bool		isRegister;
+	bool		isOper;
+	bool		serverNotices;
+	bool		invisible;
 
 	bool		welcomeMessage;
+	std::string	awayMessage;	// empty when not away
+
+	// Channels joined, by name, so that QUIT and NICK only visit those
+	std::set<std::string>	channels;
+
+	// CPU accounting: handler time and messages caused, turned into fake lag
+	long			cpuUsec;
+	unsigned long	sends;
+	unsigned long	commands;
+	long			lagUntil;
+
+	// Flood control: token bucket on inbound lines (in 1/1000 of a line)
+	long			floodTokens;
+	long			floodStamp;
+
+	// Connection class and output buffer (SendQ)
+	int				connClass;
+	std::string		sendQueue;
+	time_t			lastActivity;
+	bool			pingSent;
+	time_t			signonTime;
+
+	// Failed PASS/OPER attempts; nothing is read from the socket before holdUntil
+	unsigned int	authFailures;
+	long			holdUntil;
 public:
 	User();
 	User(const User &src);
@@ -32,22 +75,64 @@ public:
 	void closeConnection();
 	const std::string &getNickname() const {return (nickname);};
 	const std::string &getUsername() const {return (username);};
+	const std::string &getRealname() const {return (realname);};
+	void setRealname(const std::string &realname) {this->realname = realname;};
 	const std::string &getIp() const {return (ip);};
+	const std::string &getHost() const {return (host);};
+	const std::string &getHostmask() const {return (hostmask);};
+	const std::string &getPrefix() const {return (prefix);};
+	void setHost(const std::string &host);
 	const std::string &getBuffer() const {return (buffer);};
 	std::string &getBufferRef() {return (buffer);};
 	void addToBuffer(const std::string &toAdd) {this->buffer += toAdd;};
 	void clearBuffer() {this->buffer = "";};
 	const int &getFd() const {return (fd);};
+	const std::string &getConnId() const {return (connId);};
+	void setConnId(const std::string &id) {this->connId = id;};
 	const bool &getIsRegister() const {return (isRegister);};
 	void setHasNickname (const bool boolean) {this->hasNickname = boolean;};
 	void setHasUsername() {this->hasUsername = true;};
 	void setHasPass() {this->hasPass = true;};
 	void setHasRegister(const bool boolean) {this->isRegister = boolean;};
 	void setIp(const std::string &ip) {this->ip = ip;};
+	unsigned int getAddr() const {return (this->addr);};
+	void setAddr(const unsigned int addr) {this->addr = addr;};
+	time_t getSignonTime() const {return (this->signonTime);};
+	unsigned int addAuthFailure() {return (++this->authFailures);};
+	void clearAuthFailures() {this->authFailures = 0;};
+	long getHoldUntil() const {return (this->holdUntil);};
+	void holdInput(const long until) {if (until > this->holdUntil) this->holdUntil = until;};
 	const bool &getHasNickname() {return (this->hasNickname);};
 	const bool &getHasUsername() {return (this->hasUsername);};
 	const bool &getHasPass() {return (this->hasPass);};
 	const bool &getWelcomeMessage() {return (this->welcomeMessage);};
 	void tryRegisterUser();
 	void hasWelcomeMessage() {this->welcomeMessage = true;};
+	bool isOperator() const {return (this->isOper);};
+	void setOperator(const bool boolean) {this->isOper = boolean;};
+	bool getServerNotices() const {return (this->serverNotices);};
+	void setServerNotices(const bool boolean) {this->serverNotices = boolean;};
+	bool isInvisible() const {return (this->invisible);};
+	bool isAway() const {return (!this->awayMessage.empty());};
+	const std::string &getAwayMessage() const {return (this->awayMessage);};
+	void setAwayMessage(const std::string &message) {this->awayMessage = message;};
+	void setInvisible(const bool boolean) {this->invisible = boolean;};
+	const std::set<std::string> &getChannels() const {return (this->channels);};
+	void joinChannel(const std::string &name) {this->channels.insert(name);};
+	void leaveChannel(const std::string &name) {this->channels.erase(name);};
+	void leaveAllChannels() {this->channels.clear();};
+	void charge(long now, long usec, unsigned long sends, long penalty);
+	long getLag(long now) const {return (this->lagUntil > now ? this->lagUntil - now : 0);};
+	long getCpuUsec() const {return (this->cpuUsec);};
+	unsigned long getSends() const {return (this->sends);};
+	unsigned long getCommands() const {return (this->commands);};
+	bool takeToken(long now, long burst, long rate);
+	int getConnClass() const {return (this->connClass);};
+	void setConnClass(const int connClass) {this->connClass = connClass;};
+	std::string &getSendQueueRef() {return (this->sendQueue);};
+	size_t getSendQueueSize() const {return (this->sendQueue.size());};
+	time_t getLastActivity() const {return (this->lastActivity);};
+	void setActivity(const time_t now) {this->lastActivity = now; this->pingSent = false;};
+	bool getPingSent() const {return (this->pingSent);};
+	void setPingSent() {this->pingSent = true;};
 };
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <string>
+#include <set>
+#include <vector>
+#include <utility>
+
+#include "User.hpp"
+
+// Fields of a registered client that WHO can search
+enum e_whofield
+{
+	WHO_NICK,
+	WHO_USER,
+	WHO_HOST,
+	WHO_REALNAME,
+	WHO_FIELDS
+};
+
+/*
+ * Every registered client, sorted once per searchable field by the
+ * lowercase value and by the lowercase value read backwards. A mask
+ * with a literal prefix ("nick*", "192.168.*") is a range of the first
+ * order, one with a literal suffix ("*.isp.net") a range of the second,
+ * so WHO only looks at the clients that can match.
+ */
+class UserIndex
+{
+private:
+	typedef std::set<std::pair<std::string, int> >	t_keys;
+
+	t_keys	forward[WHO_FIELDS];
+	t_keys	reversed[WHO_FIELDS];
+
+	static std::string	value(const User &user, int field);
+	static void			range(const t_keys &keys, const std::string &literal, bool exact, std::vector<int> &fds);
+
+public:
+	UserIndex();
+	UserIndex(const UserIndex &src);
+	UserIndex &operator=(const UserIndex &src);
+	~UserIndex();
+
+	void	add(int fd, const User &user);
+	void	remove(int fd, const User &user);
+
+	void	collect(int field, const std::string &mask, std::vector<int> &fds) const;
+	void	all(std::vector<int> &fds) const;
+	size_t	size() const {return (this->forward[WHO_NICK].size());};
+};
@@ -52,6 +52,7 @@
 // Server Info
 #define SERV_NAME "ircserv"
 #define SERVER_NAME "ircserv" // Alias if needed
+#define SERVER_VERSION "ft_irc-1.0.0"
 #define LIST_CAP "CAP * LS :"
 
 // Error Codes (Numeric) - Moved to IrcReplies.hpp
@@ -62,7 +63,6 @@
 #define MSG_NEED_NICK "You need to set a nickname"
 #define MSG_NEED_USER "You need to set a username"
 #define MSG_ERR_UNKNOWNCOMMAND "Unknown command"
-#define MSG_ERR_YOUWILLBEBANNED "Too many attempts, you will be banned"
 #define MSG_ERR_NOORIGIN "No origin specified"
 #define MSG_ERR_NICKCOLLISION "Nickname collision"
 
@@ -73,10 +73,13 @@
 #define ERR_NOCHANMODES 477
 #define ERR_UMODEUNKNOWNFLAG 501
 #define ERR_USERSDONTMATCH 502
-#define ERR_YOUWILLBEBANNED 465
 #define MSG_RPL_INVITED "You have been invited"
 
 const std::string getParam(int cmdLength, const std::string &line);
 const std::string getChannelName(const std::string &line);
+const std::string getTargetChannel(const std::string &line);
+const std::string toString(long number);
+long	getTimeUsec();
+const std::string cloakAddress(const std::string &ip, const std::string &key);
 
 #endif
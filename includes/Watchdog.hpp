@@ -0,0 +1,49 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <ctime>
+
+#define WATCHDOG_COMMAND_THRESHOLD_MS 50
+#define WATCHDOG_LOOP_THRESHOLD_MS 100
+#define WATCHDOG_TOP_SIZE 10
+
+typedef struct {
+	long		usec;
+	int			fd;
+	std::string	command;
+	std::string	channel;
+	time_t		when;
+}				t_stall;
+
+class Watchdog
+{
+private:
+	long					commandThreshold;
+	long					loopThreshold;
+	size_t					topSize;
+
+	long					loopStart;
+	t_stall					loopWorst;
+	std::vector<t_stall>	slowest;
+	unsigned long			commandStalls;
+	unsigned long			loopStalls;
+
+	void	recordSlowest(const t_stall &sample);
+
+public:
+	Watchdog();
+	Watchdog(const Watchdog &src);
+	Watchdog &operator=(const Watchdog &src);
+	~Watchdog();
+
+	void	configure(long commandThresholdMs, long loopThresholdMs, size_t topSize);
+
+	void	beginLoop();
+	bool	endLoop(t_stall &stall);
+	bool	recordCommand(int fd, const std::string &command, const std::string &channel, long usec, t_stall &stall);
+
+	const std::vector<t_stall>	&getSlowest() const {return (this->slowest);};
+	unsigned long				getCommandStalls() const {return (this->commandStalls);};
+	unsigned long				getLoopStalls() const {return (this->loopStalls);};
+};
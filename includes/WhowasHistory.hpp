@@ -0,0 +1,53 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <ctime>
+
+#include "User.hpp"
+
+// One nickname given up, by a NICK change or a disconnect
+typedef struct {
+	std::string	nick;
+	std::string	user;
+	std::string	host;
+	std::string	realname;
+	time_t		signoff;
+	size_t		bucket;
+	int			newer;		// next record of the same bucket, -1 if none
+	int			older;
+}				t_whowas;
+
+/*
+ * WHOWAS history: a ring of a fixed number of records, the oldest one
+ * overwritten by the next nick given up, and a hash of the case-folded
+ * nicks whose buckets chain their records newest first. The strings of
+ * a slot keep their capacity from one round to the next, so recording a
+ * nick seldom allocates, and the slot being overwritten is always the
+ * tail of its bucket chain.
+ */
+class WhowasHistory
+{
+private:
+	std::vector<t_whowas>	ring;
+	std::vector<int>		buckets;	// newest record of each bucket, -1 if none
+	size_t					next;		// slot overwritten by the next record
+	size_t					used;
+
+	static size_t	hash(const std::string &nick);
+	static bool		sameNick(const std::string &a, const std::string &b);
+	void			unlink(size_t slot);
+
+public:
+	WhowasHistory();
+	WhowasHistory(const WhowasHistory &src);
+	WhowasHistory &operator=(const WhowasHistory &src);
+	~WhowasHistory();
+
+	void	resize(size_t capacity);
+	void	record(const User &user, time_t when);
+
+	size_t	find(const std::string &nick, const t_whowas **found, size_t max) const;
+	size_t	size() const {return (this->used);};
+	size_t	capacity() const {return (this->ring.size());};
+};
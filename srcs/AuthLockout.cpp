@@ -0,0 +1,131 @@
+/* ************************************************************************** */
+/*                                                                          */
+/*                                                        :::      ::::::::   */
+/*   AuthLockout.cpp                                    :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: adrien <adrien@student.42.fr>              +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/19 15:48:17 by adrien            #+#    #+#             */
+/*   Updated: 2026/10/19 15:48:17 by adrien           ###   ########.fr       */
+/*                                                                          */
+/* ************************************************************************** */
+
+/*
+** ============================================================================
+**                           AUTHENTICATION LOCKOUT
+** ============================================================================
+**
+**  Every failed PASS or OPER is counted three times:
+**  - on the connection (User): auth_max_failures disconnects it
+**  - on the source address (IpTable): auth_max_failures locks the address,
+**    its new connections are refused right after accept
+**  - on the OPER account: while locked, OPER for it fails without even
+**    checking the password
+**
+**  Backoff: the n-th failure holds the input of the connection for
+**           auth_backoff_ms * 2^(n-1), capped at auth_backoff_max_ms;
+**           the socket is not read meanwhile, so guesses queue up in the
+**           client's TCP buffers instead of reaching the command path
+**  Counts are forgotten after auth_forget seconds without failure.
+**
+** ============================================================================
+*/
+
+#include "../includes/Server.hpp"
+
+/*
+ * Delay imposed after a number of failures
+ * @param failures the number of recent failures
+ * @return the delay in milliseconds
+ */
+long Server::authBackoffMs(unsigned int failures) const
+{
+	if (failures == 0)
+		return (0);
+
+	long delay = lockout.backoffMs;
+	for (unsigned int i = 1; i < failures && delay < lockout.backoffMaxMs; i++)
+		delay *= 2;
+	return (delay < lockout.backoffMaxMs ? delay : lockout.backoffMaxMs);
+}
+
+/*
+ * Check if an OPER account is locked by recent failures
+ * @param account the OPER username
+ * @param now the current time
+ * @return true while the account backoff is running
+ */
+bool Server::isAccountLocked(const std::string &account, time_t now) const
+{
+	std::map<std::string, t_failures>::const_iterator it = accountFailures.find(account);
+	if (it == accountFailures.end() || now - it->second.stamp > lockout.forget)
+		return (false);
+	return (it->second.count >= (unsigned int)lockout.maxFailures
+	        && (now - it->second.stamp) * 1000 < authBackoffMs(it->second.count));
+}
+
+/*
+ * Record a failed PASS or OPER: hold the connection input for the
+ * backoff of the worst counter, disconnect past the limit
+ * @param clientFd the client file descriptor
+ * @param account the OPER account targeted ("" for PASS)
+ * @return void
+ */
+void Server::authFailed(const int &clientFd, const std::string &account)
+{
+	User &user = Users[clientFd];
+	const time_t now = time(NULL);
+
+	const unsigned int userFailures = user.addAuthFailure();
+	const unsigned int ipFailures = ipTable.fail(user.getAddr(), now, lockout.forget);
+	unsigned int worst = userFailures > ipFailures ? userFailures : ipFailures;
+
+	// Only real accounts are tracked, made-up names cannot grow the map
+	if (!account.empty() && account == config.get("oper_user", "admin"))
+	{
+		t_failures &failures = accountFailures[account];
+		if (now - failures.stamp > lockout.forget)
+			failures.count = 0;
+		failures.stamp = now;
+		if (++failures.count > worst)
+			worst = failures.count;
+		sendServerNotice("Failed OPER attempt for [" + account + "] by " + user.getNickname()
+		                 + " (" + user.getIp() + "), " + toString(failures.count) + " in a row");
+	}
+
+	user.holdInput(getTimeUsec() + authBackoffMs(worst) * 1000L);
+	if (userFailures >= (unsigned int)lockout.maxFailures
+		|| ipFailures >= (unsigned int)lockout.maxFailures)
+		scheduleDisconnect(clientFd, "Too many failed login attempts");
+}
+
+/*
+ * Reset the counters of a connection (and account) after a success
+ * @param clientFd the client file descriptor
+ * @param account the OPER account ("" for PASS)
+ * @return void
+ */
+void Server::authSucceeded(const int &clientFd, const std::string &account)
+{
+	Users[clientFd].clearAuthFailures();
+	ipTable.clearFailures(Users[clientFd].getAddr());
+	if (!account.empty())
+		accountFailures.erase(account);
+}
+
+/*
+ * Forget the account counters that have not moved for a while
+ * @param now the current time
+ * @return void
+ */
+void Server::purgeAccountFailures(time_t now)
+{
+	std::map<std::string, t_failures>::iterator it = accountFailures.begin();
+	while (it != accountFailures.end())
+	{
+		if (now - it->second.stamp > lockout.forget)
+			accountFailures.erase(it++);
+		else
+			++it;
+	}
+}
@@ -0,0 +1,495 @@
+/* ************************************************************************** */
+/*                                                                          */
+/*                                                        :::      ::::::::   */
+/*   BanEngine.cpp                                      :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: adrien <adrien@student.42.fr>              +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/19 14:45:30 by adrien            #+#    #+#             */
+/*   Updated: 2026/10/20 11:43:27 by adrien           ###   ########.fr       */
+/*                                                                          */
+/* ************************************************************************** */
+
+/*
+** ============================================================================
+**                           BAN ENGINE
+** ============================================================================
+**
+**  D-line "1.2.3.0/24":  radix tree, longest prefix match at accept time
+**  K-line "user@host":   user part always matched by a compiled glob,
+**                        host part indexed by shape:
+**                        - no wildcard ("1.2.3.4", "host.net") → exact map
+**                        - "*.suffix" → suffix map, probed once per dot
+**                          of the client host
+**                        - CIDR ("1.2.3.0/24") or other wildcards → short
+**                          list checked one by one
+**  Lookups stay logarithmic in the number of bans: only the last kind
+**  is scanned, and it is rare in practice.
+**
+**  Expiry:  each temporary ban is scheduled on the timer wheel by id; a
+**           fired id whose ban was removed or changed is ignored
+**  File:    one ban per line: <K|D> <mask> <expires> <setAt> <setter> :<reason>
+**  load():  diff against the bans in memory, only the changed entries
+**           are added to or removed from the indexes
+**
+** ============================================================================
+*/
+
+#include "../includes/BanEngine.hpp"
+#include "../includes/CidrTrie.hpp"
+#include <fstream>
+#include <sstream>
+#include <cctype>
+
+#define HOST_EXACT 0
+#define HOST_SUFFIX 1
+#define HOST_WILD 2
+#define HOST_CIDR 3
+
+/*
+ * Default constructor
+ */
+BanEngine::BanEngine() : nextId(0) {}
+
+/*
+ * Copy constructor
+ * @param src the engine to copy
+ */
+BanEngine::BanEngine(const BanEngine &src)
+{
+	*this = src;
+}
+
+/*
+ * Assignment operator
+ * @param src the engine to copy
+ * @return reference to this engine
+ */
+BanEngine &BanEngine::operator=(const BanEngine &src)
+{
+	if (this != &src)
+	{
+		this->entries = src.entries;
+		this->ids = src.ids;
+		this->nextId = src.nextId;
+		this->dlines = src.dlines;
+		this->exactHosts = src.exactHosts;
+		this->hostSuffixes = src.hostSuffixes;
+		this->wildHosts = src.wildHosts;
+		this->wheel = src.wheel;
+	}
+	return (*this);
+}
+
+/*
+ * Destructor
+ */
+BanEngine::~BanEngine() {}
+
+/*
+ * Lowercase a string (hosts and masks are case-insensitive)
+ */
+static std::string lower(const std::string &text)
+{
+	std::string result = text;
+
+	for (size_t i = 0; i < result.length(); i++)
+		result[i] = std::tolower(result[i]);
+	return (result);
+}
+
+/*
+ * Key of a ban in the id map
+ * @param type the ban type
+ * @param mask the normalized mask
+ * @return the key
+ */
+std::string BanEngine::key(char type, const std::string &mask)
+{
+	return (std::string(1, type) + " " + mask);
+}
+
+/*
+ * Check and normalize the mask of a ban
+ * D-line: valid IPv4 CIDR, host bits cleared ("1.2.3.4/24" → "1.2.3.0/24")
+ * K-line: lowercase "user@host", a bare host becomes "*@host"
+ * @param ban the ban to normalize
+ * @return false if the mask is invalid
+ */
+bool BanEngine::normalize(t_ban &ban)
+{
+	if (ban.type == BAN_DLINE)
+	{
+		unsigned int addr;
+		int len;
+		if (ban.mask == "*" || !CidrTrie::parse(ban.mask, addr, len))
+			return (false);
+		if (len < 32)
+			addr &= 0xFFFFFFFFU << (32 - len);
+		std::ostringstream oss;
+		oss << (addr >> 24) << "." << ((addr >> 16) & 0xFF) << "."
+		    << ((addr >> 8) & 0xFF) << "." << (addr & 0xFF);
+		if (len < 32)
+			oss << "/" << len;
+		ban.mask = oss.str();
+		return (true);
+	}
+	if (ban.type != BAN_KLINE || ban.mask.empty() || ban.mask.find(' ') != std::string::npos)
+		return (false);
+	ban.mask = lower(ban.mask);
+	if (ban.mask.find('@') == std::string::npos)
+		ban.mask = "*@" + ban.mask;
+	const size_t at = ban.mask.find('@');
+	return (at > 0 && at + 1 < ban.mask.length() && ban.mask.find('@', at + 1) == std::string::npos);
+}
+
+/*
+ * Remove one id from an index list
+ * @param list the list
+ * @param id the id to remove
+ * @return void
+ */
+void BanEngine::dropId(std::vector<int> &list, int id)
+{
+	for (size_t i = 0; i < list.size(); i++)
+	{
+		if (list[i] == id)
+		{
+			list[i] = list.back();
+			list.pop_back();
+			return;
+		}
+	}
+}
+
+/*
+ * Add a ban to the lookup structure matching its kind
+ * @param id the ban id
+ * @return void
+ */
+void BanEngine::index(int id)
+{
+	t_banentry &entry = this->entries[id];
+	const std::string &mask = entry.ban.mask;
+
+	if (entry.ban.type == BAN_DLINE)
+	{
+		unsigned int addr;
+		int len;
+		CidrTrie::parse(mask, addr, len);
+		this->dlines.insert(addr, len, id);
+		return;
+	}
+
+	const size_t at = mask.find('@');
+	const std::string host = mask.substr(at + 1);
+	entry.user.compile(mask.substr(0, at));
+	entry.host.compile(host);
+
+	unsigned int addr;
+	int len;
+	if (host.find('/') != std::string::npos && CidrTrie::parse(host, addr, len))
+	{
+		entry.hostIndex = HOST_CIDR;
+		this->wildHosts.push_back(id);
+	}
+	else if (host.find_first_of("*?") == std::string::npos)
+	{
+		entry.hostIndex = HOST_EXACT;
+		this->exactHosts[host].push_back(id);
+	}
+	else if (host.length() > 2 && host[0] == '*' && host[1] == '.'
+			 && host.find_first_of("*?", 1) == std::string::npos)
+	{
+		entry.hostIndex = HOST_SUFFIX;
+		this->hostSuffixes[host.substr(1)].push_back(id);
+	}
+	else
+	{
+		entry.hostIndex = HOST_WILD;
+		this->wildHosts.push_back(id);
+	}
+}
+
+/*
+ * Remove a ban from its lookup structure
+ * @param id the ban id
+ * @return void
+ */
+void BanEngine::unindex(int id)
+{
+	const t_banentry &entry = this->entries[id];
+	const std::string &mask = entry.ban.mask;
+
+	if (entry.ban.type == BAN_DLINE)
+	{
+		unsigned int addr;
+		int len;
+		CidrTrie::parse(mask, addr, len);
+		this->dlines.remove(addr, len);
+		return;
+	}
+
+	const std::string host = mask.substr(mask.find('@') + 1);
+	std::map<std::string, std::vector<int> > *table = NULL;
+	std::string hostKey = host;
+	if (entry.hostIndex == HOST_EXACT)
+		table = &this->exactHosts;
+	else if (entry.hostIndex == HOST_SUFFIX)
+	{
+		table = &this->hostSuffixes;
+		hostKey = host.substr(1);
+	}
+	else
+	{
+		dropId(this->wildHosts, id);
+		return;
+	}
+
+	std::map<std::string, std::vector<int> >::iterator it = table->find(hostKey);
+	if (it == table->end())
+		return;
+	dropId(it->second, id);
+	if (it->second.empty())
+		table->erase(it);
+}
+
+/*
+ * Add a ban, replacing the ban with the same type and mask
+ * @param ban the ban (must be normalized)
+ * @return false if the same ban is already set
+ */
+bool BanEngine::add(const t_ban &ban)
+{
+	const std::string k = key(ban.type, ban.mask);
+	std::map<std::string, int>::iterator it = this->ids.find(k);
+
+	if (it != this->ids.end())
+	{
+		const t_ban &old = this->entries[it->second].ban;
+		if (old.reason == ban.reason && old.expires == ban.expires)
+			return (false);
+		unindex(it->second);
+		this->entries.erase(it->second);
+		this->ids.erase(it);
+	}
+
+	const int id = this->nextId++;
+	this->entries[id].ban = ban;
+	this->ids[k] = id;
+	index(id);
+	if (ban.expires > 0)
+		this->wheel.schedule(ban.expires, id);
+	return (true);
+}
+
+/*
+ * Remove a ban
+ * @param type the ban type
+ * @param mask the normalized mask
+ * @return false if there was no such ban
+ */
+bool BanEngine::remove(char type, const std::string &mask)
+{
+	std::map<std::string, int>::iterator it = this->ids.find(key(type, mask));
+	if (it == this->ids.end())
+		return (false);
+
+	unindex(it->second);
+	this->entries.erase(it->second);
+	this->ids.erase(it);
+	return (true);
+}
+
+/*
+ * Find the D-line covering an address (most specific one)
+ * @param addr the address in host byte order
+ * @return the ban, NULL if the address is not banned
+ */
+const t_ban *BanEngine::findDline(unsigned int addr) const
+{
+	const int id = this->dlines.lookup(addr);
+	if (id < 0)
+		return (NULL);
+	return (&this->entries.find(id)->second.ban);
+}
+
+/*
+ * Match a K-line against a client
+ * @param entry the K-line
+ * @param user the client username (lowercase)
+ * @param host the client host (lowercase)
+ * @param addr the client address in host byte order
+ * @return true if the client is covered
+ */
+bool BanEngine::matchKline(const t_banentry &entry, const std::string &user,
+						   const std::string &host, unsigned int addr) const
+{
+	if (!entry.user.match(user))
+		return (false);
+	if (entry.hostIndex != HOST_CIDR)
+		return (entry.host.match(host));
+
+	unsigned int net;
+	int len;
+	CidrTrie::parse(entry.ban.mask.substr(entry.ban.mask.find('@') + 1), net, len);
+	return (len == 0 || (addr >> (32 - len)) == (net >> (32 - len)));
+}
+
+/*
+ * Find a K-line covering a client
+ * @param user the client username
+ * @param host the client host (its IP, hostname or cloak)
+ * @param addr the client address in host byte order
+ * @return the ban, NULL if the client is not banned
+ */
+const t_ban *BanEngine::findKline(const std::string &user, const std::string &host,
+								  unsigned int addr) const
+{
+	const std::string lowUser = lower(user);
+	const std::string lowHost = lower(host);
+	std::vector<const std::vector<int> *> candidates;
+
+	std::map<std::string, std::vector<int> >::const_iterator it = this->exactHosts.find(lowHost);
+	if (it != this->exactHosts.end())
+		candidates.push_back(&it->second);
+	for (size_t dot = lowHost.find('.'); dot != std::string::npos; dot = lowHost.find('.', dot + 1))
+	{
+		it = this->hostSuffixes.find(lowHost.substr(dot));
+		if (it != this->hostSuffixes.end())
+			candidates.push_back(&it->second);
+	}
+	candidates.push_back(&this->wildHosts);
+
+	for (size_t i = 0; i < candidates.size(); i++)
+	{
+		const std::vector<int> &list = *candidates[i];
+		for (size_t j = 0; j < list.size(); j++)
+		{
+			const t_banentry &entry = this->entries.find(list[j])->second;
+			if (matchKline(entry, lowUser, lowHost, addr))
+				return (&entry.ban);
+		}
+	}
+	return (NULL);
+}
+
+/*
+ * Remove the bans whose expiry time has come
+ * @param now the current time
+ * @param expired filled with the removed bans
+ * @return void
+ */
+void BanEngine::expire(time_t now, std::vector<t_ban> &expired)
+{
+	std::vector<int> fired;
+
+	expired.clear();
+	this->wheel.advance(now, fired);
+	for (size_t i = 0; i < fired.size(); i++)
+	{
+		std::map<int, t_banentry>::iterator it = this->entries.find(fired[i]);
+		// Removed or replaced since it was scheduled
+		if (it == this->entries.end() || it->second.ban.expires == 0 || it->second.ban.expires > now)
+			continue;
+		expired.push_back(it->second.ban);
+		remove(it->second.ban.type, it->second.ban.mask);
+	}
+}
+
+/*
+ * List the bans of one type
+ * @param type the ban type
+ * @param bans filled with the bans, in creation order
+ * @return void
+ */
+void BanEngine::list(char type, std::vector<t_ban> &bans) const
+{
+	bans.clear();
+	for (std::map<int, t_banentry>::const_iterator it = this->entries.begin();
+		 it != this->entries.end(); ++it)
+	{
+		if (it->second.ban.type == type)
+			bans.push_back(it->second.ban);
+	}
+}
+
+/*
+ * Write every ban to the bans file (through a temporary file + rename)
+ * @param path the bans file
+ * @return false if the file could not be written
+ */
+bool BanEngine::save(const std::string &path) const
+{
+	const std::string tmp = path + ".tmp";
+	std::ofstream file(tmp.c_str());
+	if (!file.is_open())
+		return (false);
+
+	file << "# <K|D> <mask> <expires> <set at> <setter> :<reason>" << std::endl;
+	for (std::map<int, t_banentry>::const_iterator it = this->entries.begin();
+		 it != this->entries.end(); ++it)
+	{
+		const t_ban &ban = it->second.ban;
+		file << ban.type << " " << ban.mask << " " << ban.expires << " " << ban.setAt
+		     << " " << ban.setter << " :" << ban.reason << "\n";
+	}
+	file.close();
+	return (!file.fail() && std::rename(tmp.c_str(), path.c_str()) == 0);
+}
+
+/*
+ * Load the bans file, applying only the differences with the bans in
+ * memory (the indexes are updated, not rebuilt)
+ * @param path the bans file
+ * @param added set to the number of bans added or changed
+ * @param removed set to the number of bans removed
+ * @return false if the file could not be read (the bans are kept)
+ */
+bool BanEngine::load(const std::string &path, size_t &added, size_t &removed)
+{
+	added = 0;
+	removed = 0;
+
+	std::ifstream file(path.c_str());
+	if (!file.is_open())
+		return (false);
+
+	std::map<std::string, t_ban> wanted;
+	const time_t now = time(NULL);
+	std::string line;
+	while (std::getline(file, line))
+	{
+		if (line.empty() || line[0] == '#')
+			continue;
+
+		std::istringstream iss(line);
+		std::string type;
+		t_ban ban;
+		if (!(iss >> type >> ban.mask >> ban.expires >> ban.setAt >> ban.setter) || type.length() != 1)
+			continue;
+		ban.type = type[0];
+		std::getline(iss, ban.reason);
+		const size_t colon = ban.reason.find(':');
+		ban.reason = (colon == std::string::npos) ? "" : ban.reason.substr(colon + 1);
+		if (!normalize(ban) || (ban.expires != 0 && ban.expires <= now))
+			continue;
+		wanted[key(ban.type, ban.mask)] = ban;
+	}
+
+	std::vector<std::pair<char, std::string> > stale;
+	for (std::map<std::string, int>::const_iterator it = this->ids.begin(); it != this->ids.end(); ++it)
+	{
+		if (wanted.find(it->first) == wanted.end())
+		{
+			const t_ban &ban = this->entries[it->second].ban;
+			stale.push_back(std::make_pair(ban.type, ban.mask));
+		}
+	}
+	for (size_t i = 0; i < stale.size(); i++)
+		removed += remove(stale[i].first, stale[i].second);
+
+	for (std::map<std::string, t_ban>::const_iterator it = wanted.begin(); it != wanted.end(); ++it)
+		added += add(it->second);
+	return (true);
+}
@@ -6,7 +6,7 @@
 /*   By: hdelacou <hdelacou@student.42.fr>          +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/12/16 05:19:55 by hdelacou          #+#    #+#             */
-/*   Updated: 2025/12/16 06:22:36 by hdelacou         ###   ########.fr       */
+/*   Updated: 2026/10/19 23:31:26 by adrien           ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -16,10 +16,19 @@
 ** ============================================================================
 **
 **  Modes: +i (invite-only) | +t (topic-op-only) | +k (key) | +l (limit)
+**         +u (auditorium: members only see the operators and themselves)
+**  Lists: +b (bans) | +e (ban exceptions) | +I (invite exceptions)
 **
-**  canJoin() checks: invited? → key match? → under limit?
+**  canJoin() checks: banned (not excepted, not invited)? → invited or
+**                    +I? → key match? → under limit?
+**  Ban state of members is cached per fd and dropped when the +b/+e lists
+**  change (banGeneration) or the member changes nick
 **  First member becomes host & operator
+**  The NAMES cache is patched by the member and operator changes here,
+**  nick changes come through renameMember()
 **  Operators control: topic (+t), MODE changes, KICK, INVITE
+**  getAudience() gives who hears about a member (join, part, quit, nick,
+**  messages): everyone, or only the operators of a +u channel
 **
 ** ============================================================================
 */
@@ -32,10 +41,14 @@
  */
 Channel::Channel()
 {
+	this->topicTimeSet = 0;
+	this->createdAt = 0;
+	this->banGeneration = 0;
 	this->invite_only = false;
 	this->topic_op_only = false;
 	this->has_key = false;
 	this->user_limit = 0;
+	this->auditorium = false;
 }
 
 /*
@@ -47,10 +60,14 @@ Channel::Channel()
 Channel::Channel(const std::string &name, int creator)
 {
 	this->name = name;
+	this->topicTimeSet = 0;
+	this->createdAt = time(NULL);
+	this->banGeneration = 0;
 	this->invite_only = false;
 	this->topic_op_only = false;
 	this->has_key = false;
 	this->user_limit = 0;
+	this->auditorium = false;
 	this->host = creator;
 	this->users.insert(creator);
 	this->operators.insert(creator);
@@ -84,11 +101,19 @@ Channel &Channel::operator=(const Channel &src)
 	this->topic_op_only = src.topic_op_only;
 	this->has_key = src.has_key;
 	this->user_limit = src.user_limit;
+	this->auditorium = src.auditorium;
 	this->operators = src.operators;
 	this->users = src.users;
 	this->invited = src.invited;
 	this->topicSetter = src.topicSetter;
 	this->topicTimeSet = src.topicTimeSet;
+	this->createdAt = src.createdAt;
+	this->bans = src.bans;
+	this->excepts = src.excepts;
+	this->invexes = src.invexes;
+	this->banGeneration = src.banGeneration;
+	this->banCache = src.banCache;
+	this->names = src.names;
 
 	return (*this);
 }
@@ -106,28 +131,38 @@ Channel::~Channel()
 
 /*
  * Checks if a client can join the channel
+ * An INVITE overrides +b and +i, a +I mask overrides +i
  * @param fd the client file descriptor
+ * @param hostmask the client nick!user@host
  * @param key the channel key
- * @param reason the reason for the join failure
+ * @param mode set to the mode refusing the client ('b', 'i', 'k' or 'l')
  * @return true if the client can join, false otherwise
  */
-bool Channel::canJoin(int fd, const std::string &key, std::string &reason) const
+bool Channel::canJoin(int fd, const std::string &hostmask, const std::string &key, char &mode) const
 {
-	if (this->invite_only && this->invited.find(fd) == this->invited.end())
+	const bool invitedFd = this->invited.find(fd) != this->invited.end();
+
+	if (!invitedFd && isBanned(fd, hostmask))
+	{
+		mode = 'b';
+		return (false);
+	}
+
+	if (this->invite_only && !invitedFd && !isInviteExempt(hostmask))
 	{
-		reason = "You cannot join channel because you have not been invited";
+		mode = 'i';
 		return (false);
 	}
 
 	if (this->has_key && key != this->key)
 	{
-		reason = "You cannot join channel because the password is incorrect";
+		mode = 'k';
 		return (false);
 	}
 
 	if (this->user_limit > 0 && (int)this->users.size() >= this->user_limit)
 	{
-		reason = "You cannot join channel because it has reach its limit of users";
+		mode = 'l';
 		return (false);
 	}
 
@@ -137,11 +172,26 @@ bool Channel::canJoin(int fd, const std::string &key, std::string &reason) const
 /*
  * Adds a client to the channel
  * @param fd the client file descriptor
+ * @param nick the client nickname, for the NAMES cache
  * @return true if the client was added, false otherwise
  */
-bool Channel::addMember(int fd)
+bool Channel::addMember(int fd, const std::string &nick)
+{
+	if (!this->users.insert(fd).second)
+		return (false);
+	this->names.add(fd, nick, isOperator(fd));
+	return (true);
+}
+
+/*
+ * Updates the nickname of a member in the NAMES cache
+ * @param fd the member file descriptor
+ * @param nick the new nickname
+ * @return void
+ */
+void Channel::renameMember(int fd, const std::string &nick)
 {
-	return this->users.insert(fd).second;
+	this->names.rename(fd, nick);
 }
 
 /*
@@ -153,6 +203,8 @@ bool Channel::removeMember(int fd)
 {
 	this->operators.erase(fd);
 	this->invited.erase(fd);
+	this->banCache.erase(fd);
+	this->names.remove(fd);
 
 	return this->users.erase(fd) > 0;
 }
@@ -196,7 +248,10 @@ bool Channel::addOperator(int fd)
 	if (!this->isMember(fd))
 		return (false);
 
-	return this->operators.insert(fd).second;
+	if (!this->operators.insert(fd).second)
+		return (false);
+	this->names.setOperator(fd, true);
+	return (true);
 }
 
 /*
@@ -206,7 +261,10 @@ bool Channel::addOperator(int fd)
  */
 bool Channel::removeOperator(int fd)
 {
-	return this->operators.erase(fd) > 0;
+	if (this->operators.erase(fd) == 0)
+		return (false);
+	this->names.setOperator(fd, false);
+	return (true);
 }
 
 /*
@@ -227,6 +285,43 @@ void Channel::setTopicOpOnly(bool on)
 	this->topic_op_only = on;
 }
 
+/*
+ * Sets the channel auditorium mode
+ * @param on true to enable auditorium mode, false to disable it
+ */
+void Channel::setAuditorium(bool on)
+{
+	this->auditorium = on;
+}
+
+/*
+ * Gets who is told about what a member does on the channel
+ * In a +u channel the members only see the operators, so what a regular
+ * member does only reaches the operators, never its own client
+ * @param fd the member file descriptor
+ * @return the operators, or every member
+ */
+const std::set<int> &Channel::getAudience(int fd) const
+{
+	if (this->auditorium && !isOperator(fd))
+		return (this->operators);
+	return (this->users);
+}
+
+/*
+ * Checks if a member is shown to another client
+ * @param viewer the client looking
+ * @param member the member looked at
+ * @return false only for a regular member of a +u channel looked at by
+ * another regular member or an outsider
+ */
+bool Channel::canSee(int viewer, int member) const
+{
+	if (!this->auditorium || viewer == member)
+		return (true);
+	return (isOperator(viewer) || isOperator(member));
+}
+
 /*
  * Sets the channel key
  * @param key the channel key
@@ -320,6 +415,112 @@ void Channel::clearInvite(int fd)
 	this->invited.erase(fd);
 }
 
+/*
+ * Gets one of the mask lists
+ * @param mode 'b' (bans), 'e' (exceptions) or 'I' (invite exceptions)
+ * @return the list, NULL for any other mode
+ */
+const MaskList *Channel::getMaskList(char mode) const
+{
+	if (mode == 'b')
+		return (&this->bans);
+	if (mode == 'e')
+		return (&this->excepts);
+	if (mode == 'I')
+		return (&this->invexes);
+	return (NULL);
+}
+
+/*
+ * Gets one of the mask lists for a change
+ * @param mode 'b', 'e' or 'I'
+ * @return the list, NULL for any other mode
+ */
+MaskList *Channel::maskList(char mode)
+{
+	if (mode == 'b')
+		return (&this->bans);
+	if (mode == 'e')
+		return (&this->excepts);
+	if (mode == 'I')
+		return (&this->invexes);
+	return (NULL);
+}
+
+/*
+ * Adds a mask to a list
+ * @param mode 'b', 'e' or 'I'
+ * @param mask the mask, normalized with MaskList::normalize()
+ * @param setter the prefix of who set it
+ * @return false if the mask is already listed or the list is full
+ */
+bool Channel::addMask(char mode, const std::string &mask, const std::string &setter)
+{
+	MaskList *list = maskList(mode);
+	if (!list || !list->add(mask, setter, time(NULL)))
+		return (false);
+	if (mode != 'I')
+		this->banGeneration++;
+	return (true);
+}
+
+/*
+ * Removes a mask from a list
+ * @param mode 'b', 'e' or 'I'
+ * @param mask the mask, normalized with MaskList::normalize()
+ * @return false if the mask was not listed
+ */
+bool Channel::removeMask(char mode, const std::string &mask)
+{
+	MaskList *list = maskList(mode);
+	if (!list || !list->remove(mask))
+		return (false);
+	if (mode != 'I')
+		this->banGeneration++;
+	return (true);
+}
+
+/*
+ * Checks if a client is banned (+b without matching +e)
+ * The answer is cached for members until the lists or their nick change
+ * @param fd the client file descriptor
+ * @param hostmask the client nick!user@host
+ * @return true if the client is banned
+ */
+bool Channel::isBanned(int fd, const std::string &hostmask) const
+{
+	if (this->bans.empty())
+		return (false);
+
+	std::map<int, std::pair<unsigned int, bool> >::iterator cached = this->banCache.find(fd);
+	if (cached != this->banCache.end() && cached->second.first == this->banGeneration)
+		return (cached->second.second);
+
+	const bool banned = this->bans.match(hostmask) && !this->excepts.match(hostmask);
+	if (isMember(fd))
+		this->banCache[fd] = std::make_pair(this->banGeneration, banned);
+	return (banned);
+}
+
+/*
+ * Checks if a client matches the invite exceptions (+I)
+ * @param hostmask the client nick!user@host
+ * @return true if the client may join while the channel is +i
+ */
+bool Channel::isInviteExempt(const std::string &hostmask) const
+{
+	return (this->invexes.match(hostmask));
+}
+
+/*
+ * Drops the cached ban state of a member (its nick or host changed)
+ * @param fd the client file descriptor
+ */
+void Channel::forgetBanState(int fd)
+{
+	this->banCache.erase(fd);
+}
+
 /*
  * Gets the channel name
  * @return the channel name
@@ -0,0 +1,138 @@
+/* ************************************************************************** */
+/*                                                                          */
+/*                                                        :::      ::::::::   */
+/*   ChannelIndex.cpp                                   :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: adrien <adrien@student.42.fr>              +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/19 20:17:45 by adrien            #+#    #+#             */
+/*   Updated: 2026/10/19 20:17:45 by adrien           ###   ########.fr       */
+/*                                                                          */
+/* ************************************************************************** */
+
+/*
+** ============================================================================
+**                         CHANNEL INDEX (LIST)
+** ============================================================================
+**
+**  entries: (members desc, created asc, name) → topic, topic time
+**  keys:    name → its current key, to move a channel when it changes
+**  A LIST cursor remembers the last key it sent and resumes right after
+**  it (upper_bound), so channels created, emptied or reordered while a
+**  listing is streaming never invalidate it. "<N" filters start at
+**  atMost(N - 1), ">N" filters stop at the first channel with N members.
+**
+** ============================================================================
+*/
+
+#include "../includes/ChannelIndex.hpp"
+
+bool ListOrder::operator()(const t_listkey &a, const t_listkey &b) const
+{
+	if (a.members != b.members)
+		return (a.members > b.members);
+	if (a.created != b.created)
+		return (a.created < b.created);
+	return (a.name < b.name);
+}
+
+ChannelIndex::ChannelIndex()
+{
+}
+
+ChannelIndex::ChannelIndex(const ChannelIndex &src)
+{
+	*this = src;
+}
+
+ChannelIndex &ChannelIndex::operator=(const ChannelIndex &src)
+{
+	if (this != &src)
+	{
+		this->entries = src.entries;
+		this->keys = src.keys;
+	}
+	return (*this);
+}
+
+ChannelIndex::~ChannelIndex()
+{
+}
+
+/*
+ * This function indexes a channel again after its members or topic changed
+ * @param channel the channel
+ * @return void
+ */
+void ChannelIndex::update(const Channel &channel)
+{
+	t_listkey key;
+	key.members = channel.getMemberCount();
+	key.created = channel.getCreated();
+	key.name = channel.getName();
+
+	std::map<std::string, t_listkey>::iterator old = this->keys.find(key.name);
+	if (old != this->keys.end())
+	{
+		this->entries.erase(old->second);
+		old->second = key;
+	}
+	else
+		this->keys[key.name] = key;
+
+	t_listtopic &topic = this->entries[key];
+	topic.topic = channel.getTopic();
+	topic.topicTime = channel.getTopic().empty() ? 0 : channel.getTopicTime();
+}
+
+/*
+ * This function forgets a deleted channel
+ * @param name the channel name
+ * @return void
+ */
+void ChannelIndex::remove(const std::string &name)
+{
+	std::map<std::string, t_listkey>::iterator it = this->keys.find(name);
+	if (it == this->keys.end())
+		return;
+	this->entries.erase(it->second);
+	this->keys.erase(it);
+}
+
+/*
+ * This function finds a channel by name
+ * @param name the channel name
+ * @return its entry, end() if there is no such channel
+ */
+ChannelIndex::const_iterator ChannelIndex::find(const std::string &name) const
+{
+	std::map<std::string, t_listkey>::const_iterator it = this->keys.find(name);
+	if (it == this->keys.end())
+		return (this->entries.end());
+	return (this->entries.find(it->second));
+}
+
+/*
+ * This function gives the entry following a key, the key itself may be
+ * gone from the index
+ * @param key the last key a cursor went through
+ * @return the next entry in LIST order
+ */
+ChannelIndex::const_iterator ChannelIndex::after(const t_listkey &key) const
+{
+	return (this->entries.upper_bound(key));
+}
+
+/*
+ * This function gives the first channel with at most a number of members
+ * @param members the member count
+ * @return the first entry with members or fewer
+ */
+ChannelIndex::const_iterator ChannelIndex::atMost(size_t members) const
+{
+	t_listkey key;
+	key.members = members;
+	key.created = 0;
+	key.name = "";
+	return (this->entries.lower_bound(key));
+}
@@ -0,0 +1,164 @@
+/* ************************************************************************** */
+/*                                                                          */
+/*                                                        :::      ::::::::   */
+/*   CidrTrie.cpp                                       :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: adrien <adrien@student.42.fr>              +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/19 12:40:05 by adrien            #+#    #+#             */
+/*   Updated: 2026/10/19 13:20:14 by adrien           ###   ########.fr       */
+/*                                                                          */
+/* ************************************************************************** */
+
+/*
+** ============================================================================
+**                           CIDR PREFIX TRIE
+** ============================================================================
+**
+**  Binary trie over IPv4 address bits, most significant bit first.
+**  insert("10.0.0.0/8", v): walks/creates 8 nodes, stores v at the last one
+**  lookup(addr):            walks at most 32 nodes, collecting the values
+**                           met on the way (shortest prefix first)
+**
+**  Lookup cost is O(prefix length), whatever the number of entries.
+**
+** ============================================================================
+*/
+
+#include "../includes/CidrTrie.hpp"
+#include <arpa/inet.h>
+#include <cstdlib>
+
+/*
+ * Default constructor, creates the root node (the 0.0.0.0/0 prefix)
+ */
+CidrTrie::CidrTrie()
+{
+	clear();
+}
+
+/*
+ * Copy constructor
+ * @param src the trie to copy
+ */
+CidrTrie::CidrTrie(const CidrTrie &src)
+{
+	*this = src;
+}
+
+/*
+ * Assignment operator
+ * @param src the trie to copy
+ * @return reference to this trie
+ */
+CidrTrie &CidrTrie::operator=(const CidrTrie &src)
+{
+	if (this != &src)
+		this->nodes = src.nodes;
+	return (*this);
+}
+
+/*
+ * Destructor
+ */
+CidrTrie::~CidrTrie() {}
+
+/*
+ * Remove every prefix, only the root is left
+ * @return void
+ */
+void CidrTrie::clear()
+{
+	t_trienode root;
+
+	root.child[0] = -1;
+	root.child[1] = -1;
+	this->nodes.clear();
+	this->nodes.push_back(root);
+}
+
+/*
+ * Parse an IPv4 CIDR ("10.0.0.0/8", a bare address is a /32, "*" is /0)
+ * @param cidr the text to parse
+ * @param addr the address in host byte order
+ * @param length the prefix length
+ * @return true if the CIDR is valid
+ */
+bool CidrTrie::parse(const std::string &cidr, unsigned int &addr, int &length)
+{
+	if (cidr == "*")
+	{
+		addr = 0;
+		length = 0;
+		return (true);
+	}
+
+	const size_t slash = cidr.find('/');
+	struct in_addr in;
+	if (inet_pton(AF_INET, cidr.substr(0, slash).c_str(), &in) != 1)
+		return (false);
+	addr = ntohl(in.s_addr);
+	length = CIDR_MAX_BITS;
+
+	if (slash != std::string::npos)
+	{
+		const std::string bits = cidr.substr(slash + 1);
+		char *end = NULL;
+		length = std::strtol(bits.c_str(), &end, 10);
+		if (bits.empty() || *end != '\0' || length < 0 || length > CIDR_MAX_BITS)
+			return (false);
+	}
+	return (true);
+}
+
+/*
+ * Attach a value to a prefix
+ * @param cidr the prefix ("10.0.0.0/8")
+ * @param value the value to store
+ * @return false if the CIDR is invalid
+ */
+bool CidrTrie::insert(const std::string &cidr, int value)
+{
+	unsigned int addr;
+	int length;
+	if (!parse(cidr, addr, length))
+		return (false);
+
+	int node = 0;
+	for (int i = 0; i < length; i++)
+	{
+		const int bit = (addr >> (CIDR_MAX_BITS - 1 - i)) & 1;
+		if (this->nodes[node].child[bit] < 0)
+		{
+			t_trienode next;
+			next.child[0] = -1;
+			next.child[1] = -1;
+			this->nodes.push_back(next);
+			this->nodes[node].child[bit] = this->nodes.size() - 1;
+		}
+		node = this->nodes[node].child[bit];
+	}
+	this->nodes[node].values.push_back(value);
+	return (true);
+}
+
+/*
+ * Collect the values of every prefix containing an address
+ * @param addr the address in host byte order
+ * @param matches filled with the values, shortest prefix first
+ * @return void
+ */
+void CidrTrie::lookup(unsigned int addr, std::vector<int> &matches) const
+{
+	int node = 0;
+
+	matches.clear();
+	for (int i = 0; node >= 0; i++)
+	{
+		const std::vector<int> &values = this->nodes[node].values;
+		matches.insert(matches.end(), values.begin(), values.end());
+		if (i == CIDR_MAX_BITS)
+			break;
+		node = this->nodes[node].child[(addr >> (CIDR_MAX_BITS - 1 - i)) & 1];
+	}
+}
@@ -0,0 +1,178 @@
+/* ************************************************************************** */
+/*                                                                          */
+/*                                                        :::      ::::::::   */
+/*   Config.cpp                                         :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: adrien <adrien@student.42.fr>              +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/19 09:12:40 by adrien            #+#    #+#             */
+/*   Updated: 2026/10/19 09:12:40 by adrien           ###   ########.fr       */
+/*                                                                          */
+/* ************************************************************************** */
+
+/*
+** ============================================================================
+**                           SERVER CONFIGURATION
+** ============================================================================
+**
+**  Format: one "key = value" directive per line, '#' starts a comment
+**
+**  load(): Parses the file into a key → value map (missing file = defaults)
+**  get*(): Typed lookups with a fallback, so every setting is optional
+**  reload(): Re-reads the same file (REHASH)
+**
+** ============================================================================
+*/
+
+#include "../includes/Config.hpp"
+#include <fstream>
+#include <cstdlib>
+
+/*
+ * Trim leading and trailing whitespace
+ * @param str the string to trim
+ * @return the trimmed string
+ */
+static std::string trim(const std::string &str)
+{
+	const size_t start = str.find_first_not_of(" \t\r\n");
+	if (start == std::string::npos)
+		return ("");
+	const size_t end = str.find_last_not_of(" \t\r\n");
+	return (str.substr(start, end - start + 1));
+}
+
+/*
+ * Default constructor for Config class
+ */
+Config::Config() : path(CONFIG_FILE) {}
+
+/*
+ * Copy constructor for Config class
+ * @param src the Config object to copy from
+ */
+Config::Config(const Config &src)
+{
+	*this = src;
+}
+
+/*
+ * Assignment operator for Config class
+ * @param src the Config object to copy from
+ * @return reference to this Config object
+ */
+Config &Config::operator=(const Config &src)
+{
+	if (this == &src)
+		return (*this);
+	this->path = src.path;
+	this->values = src.values;
+	return (*this);
+}
+
+/*
+ * Destructor for Config class
+ */
+Config::~Config() {}
+
+/*
+ * Load a configuration file
+ * The previous values are only replaced if the file could be opened
+ * @param path the path of the configuration file
+ * @return true if the file was read, false otherwise
+ */
+bool Config::load(const std::string &path)
+{
+	this->path = path;
+
+	std::ifstream file(path.c_str());
+	if (!file.is_open())
+		return (false);
+
+	std::map<std::string, std::string> parsed;
+	std::string line;
+	while (std::getline(file, line))
+	{
+		const size_t comment = line.find('#');
+		if (comment != std::string::npos)
+			line.erase(comment);
+
+		const size_t equal = line.find('=');
+		if (equal == std::string::npos)
+			continue;
+
+		const std::string key = trim(line.substr(0, equal));
+		if (!key.empty())
+			parsed[key] = trim(line.substr(equal + 1));
+	}
+	this->values = parsed;
+	return (true);
+}
+
+/*
+ * Reload the configuration file that was last loaded
+ * @return true if the file was read, false otherwise
+ */
+bool Config::reload()
+{
+	return (load(this->path));
+}
+
+/*
+ * Check if a directive is set
+ * @param key the directive name
+ * @return true if the directive is set, false otherwise
+ */
+bool Config::has(const std::string &key) const
+{
+	return (this->values.find(key) != this->values.end());
+}
+
+/*
+ * Get a directive as a string
+ * @param key the directive name
+ * @param fallback the value to use if the directive is not set
+ * @return the directive value
+ */
+const std::string Config::get(const std::string &key, const std::string &fallback) const
+{
+	std::map<std::string, std::string>::const_iterator it = this->values.find(key);
+	if (it == this->values.end())
+		return (fallback);
+	return (it->second);
+}
+
+/*
+ * Get a directive as a number
+ * @param key the directive name
+ * @param fallback the value to use if the directive is not set or invalid
+ * @return the directive value
+ */
+long Config::getLong(const std::string &key, long fallback) const
+{
+	std::map<std::string, std::string>::const_iterator it = this->values.find(key);
+	if (it == this->values.end() || it->second.empty())
+		return (fallback);
+
+	char *end = NULL;
+	const long value = std::strtol(it->second.c_str(), &end, 10);
+	if (*end != '\0')
+		return (fallback);
+	return (value);
+}
+
+/*
+ * Get a directive as a boolean (yes/no, true/false, on/off, 1/0)
+ * @param key the directive name
+ * @param fallback the value to use if the directive is not set or invalid
+ * @return the directive value
+ */
+bool Config::getBool(const std::string &key, bool fallback) const
+{
+	const std::string value = get(key, "");
+	if (value == "yes" || value == "true" || value == "on" || value == "1")
+		return (true);
+	if (value == "no" || value == "false" || value == "off" || value == "0")
+		return (false);
+	return (fallback);
+}
@@ -0,0 +1,272 @@
+/* ************************************************************************** */
+/*                                                                          */
+/*                                                        :::      ::::::::   */
+/*   ConnectionClass.cpp                                :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: adrien <adrien@student.42.fr>              +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/19 12:52:37 by adrien            #+#    #+#             */
+/*   Updated: 2026/10/20 11:45:52 by adrien           ###   ########.fr       */
+/*                                                                          */
+/* ************************************************************************** */
+
+/*
+** ============================================================================
+**                           CONNECTION CLASSES
+** ============================================================================
+**
+**  server.conf:  classes = internal bouncers         (declared classes)
+**                class.internal.cidr = 10.0.0.0/8 192.168.0.0/16
+**                class.internal.port = 6667          (optional)
+**                class.internal.flood_rate = 100     (other keys optional)
+**
+**  The "default" class is built from the top-level keys and catches every
+**  connection no declared class matches. A declared class inherits any
+**  key it does not set from the default class.
+**
+**  Accept: D-lines (BanEngine) → CIDR trie lookup (O(prefix length)) →
+**          longest prefix whose port matches → max clients / max per IP /
+**          connect rate checks
+**          against the per-IP table (IpTable), before any User exists
+**  Limits: SendQ, RecvQ, flood bucket, fake lag budget, ping frequency,
+**          registration timeout
+**
+** ============================================================================
+*/
+
+#include "../includes/Server.hpp"
+#include <sstream>
+
+/*
+ * Read the settings of one class, missing keys come from the base class
+ * @param cls the class to fill
+ * @param prefix the key prefix ("" for the default class)
+ * @param base the class providing the fallback values
+ * @return void
+ */
+void Server::readClass(t_connclass &cls, const std::string &prefix, const t_connclass &base)
+{
+	cls.port = config.getLong(prefix + "port", base.port);
+	cls.sendq = config.getLong(prefix + "sendq", base.sendq);
+	cls.recvq = config.getLong(prefix + "recvq", base.recvq);
+	cls.floodBurst = config.getLong(prefix + "flood_burst", base.floodBurst);
+	cls.floodRate = config.getLong(prefix + "flood_rate", base.floodRate);
+	cls.maxClients = config.getLong(prefix + "max_clients", base.maxClients);
+	cls.maxPerIp = config.getLong(prefix + "max_per_ip", base.maxPerIp);
+	cls.pingFreq = config.getLong(prefix + "ping_freq", base.pingFreq);
+	cls.budget = config.getLong(prefix + "budget", base.budget);
+	cls.connectBurst = config.getLong(prefix + "connect_burst", base.connectBurst);
+	cls.registerTimeout = config.getLong(prefix + "register_timeout", base.registerTimeout);
+	cls.monitor = config.getLong(prefix + "monitor", base.monitor);
+	cls.clients = 0;
+
+	if (cls.floodBurst < 1)
+		cls.floodBurst = 1;
+	if (cls.floodRate < 1)
+		cls.floodRate = 1;
+	if (cls.budget < 1)
+		cls.budget = 1;
+}
+
+/*
+ * Build the connection classes and their CIDR trie from the configuration
+ * Connected users are moved to the class they would get now
+ * @return void
+ */
+void Server::loadClasses()
+{
+	t_connclass builtin;
+	builtin.name = CLASS_DEFAULT;
+	builtin.port = 0;
+	builtin.sendq = CLASS_SENDQ;
+	builtin.recvq = CLASS_RECVQ;
+	builtin.floodBurst = FLOOD_BURST;
+	builtin.floodRate = FLOOD_RATE;
+	builtin.maxClients = MAX_USER;
+	builtin.maxPerIp = CLASS_MAX_PER_IP;
+	builtin.pingFreq = CLASS_PING_FREQ;
+	builtin.budget = CLASS_BUDGET;
+	builtin.connectBurst = CLASS_CONNECT_BURST;
+	builtin.registerTimeout = CLASS_REGISTER_TIMEOUT;
+	builtin.monitor = CLASS_MONITOR;
+
+	t_connclass defaults;
+	defaults.name = CLASS_DEFAULT;
+	readClass(defaults, "", builtin);
+	defaults.port = 0;
+
+	connectHalflife = config.getLong("connect_halflife", CONNECT_HALFLIFE);
+
+	classes.clear();
+	classTrie.clear();
+	classes.push_back(defaults);
+
+	std::istringstream names(config.get("classes", ""));
+	std::string name;
+	while (names >> name)
+	{
+		const std::string prefix = "class." + name + ".";
+		t_connclass cls;
+		cls.name = name;
+		readClass(cls, prefix, defaults);
+		classes.push_back(cls);
+
+		std::istringstream ranges(config.get(prefix + "cidr", "*"));
+		std::string cidr;
+		while (ranges >> cidr)
+		{
+			if (!classTrie.insert(cidr, classes.size() - 1))
+				std::cerr << "[IRC] Class " << name << ": invalid CIDR " << cidr << std::endl;
+		}
+	}
+
+	for (std::map<int, User>::iterator it = Users.begin(); it != Users.end(); ++it)
+	{
+		const int id = findClass(it->second.getAddr());
+		it->second.setConnClass(id);
+		classes[id].clients++;
+	}
+}
+
+/*
+ * Find the class of a connection: longest matching prefix whose port
+ * matches the listener, the default class otherwise
+ * @param addr the source address in host byte order
+ * @return the index of the class
+ */
+int Server::findClass(unsigned int addr) const
+{
+	std::vector<int> matches;
+	classTrie.lookup(addr, matches);
+
+	for (size_t i = matches.size(); i > 0; i--)
+	{
+		const t_connclass &cls = classes[matches[i - 1]];
+		if (cls.port == 0 || cls.port == port)
+			return (matches[i - 1]);
+	}
+	return (0);
+}
+
+/*
+ * Get the class of a connected user
+ * @param user the user
+ * @return the connection class
+ */
+const t_connclass &Server::getClass(const User &user) const
+{
+	return (classes[user.getConnClass()]);
+}
+
+/*
+ * Close a connection refused at accept time
+ * @param clientFd the accepted socket
+ * @param ip the source address as text
+ * @param reason the reason sent in the ERROR line
+ * @return void
+ */
+void Server::refuseConnection(const int &clientFd, const std::string &ip, const std::string &reason)
+{
+	const std::string error = "ERROR :Closing Link: " + ip + " (" + reason + ")" + IRC_CRLF;
+
+	send(clientFd, error.c_str(), error.length(), MSG_NOSIGNAL);
+	close(clientFd);
+	std::cout << "[IRC] Refused " << ip << ": " << reason << std::endl;
+}
+
+/*
+ * Check the limits of a new connection and account for it
+ * Runs right after accept(): a refused connection never gets a User
+ * @param clientFd the accepted socket
+ * @param addr the source address in host byte order
+ * @param ip the source address as text
+ * @return false if the connection was refused (the socket is closed)
+ */
+bool Server::admitConnection(const int &clientFd, unsigned int addr, const std::string &ip)
+{
+	const int id = findClass(addr);
+	t_connclass &cls = classes[id];
+
+	// Every attempt counts, refused ones included
+	const t_ipentry &entry = ipTable.attempt(addr, time(NULL), connectHalflife);
+	const t_ban *ban = bans.findDline(addr);
+	const time_t now = time(NULL);
+	// Milliseconds left of the failed authentication backoff
+	const long backoff = authBackoffMs(entry.failures) - (now - entry.failStamp) * 1000L;
+	const bool locked = entry.failures >= (unsigned int)lockout.maxFailures && backoff > 0;
+
+	if (ban)
+		refuseConnection(clientFd, ip, "D-lined (" + ban->reason + ")");
+	else if (cls.clients >= cls.maxClients)
+		refuseConnection(clientFd, ip, "No more connections allowed in your connection class");
+	else if (entry.connections >= cls.maxPerIp)
+		refuseConnection(clientFd, ip, "Too many host connections (local)");
+	else if (entry.score > cls.connectBurst)
+		refuseConnection(clientFd, ip, "Reconnecting too fast, throttled");
+	else if (locked)
+		refuseConnection(clientFd, ip, "Too many failed login attempts");
+	else
+	{
+		cls.clients++;
+		ipTable.connected(addr);
+
+		User newUser;
+		Users[clientFd] = newUser;
+		Users[clientFd].setConnId(toString(++lastConnId));
+		connFds[Users[clientFd].getConnId()] = clientFd;
+		Users[clientFd].setIp(ip);
+		Users[clientFd].setHost(cloakKey.empty() ? ip : cloakAddress(ip, cloakKey));
+		Users[clientFd].setAddr(addr);
+		Users[clientFd].setConnClass(id);
+		// A fresh connection does not reset the address backoff
+		if (backoff > 0)
+			Users[clientFd].holdInput(getTimeUsec() + backoff * 1000L);
+		return (true);
+	}
+	return (false);
+}
+
+/*
+ * Give back the class and per-IP slots and the connection id of a leaving user
+ * @param user the user being disconnected
+ * @return void
+ */
+void Server::releaseConnection(const User &user)
+{
+	classes[user.getConnClass()].clients--;
+	ipTable.disconnected(user.getAddr());
+	connFds.erase(user.getConnId());
+}
+
+/*
+ * PING the clients silent for longer than their class ping frequency,
+ * drop the ones that did not answer within another period and the ones
+ * still not registered after their class registration timeout
+ * @param now the current time
+ * @return void
+ */
+void Server::checkPings(time_t now)
+{
+	for (std::map<int, User>::iterator it = Users.begin(); it != Users.end(); ++it)
+	{
+		const long freq = getClass(it->second).pingFreq;
+		const long idle = now - it->second.getLastActivity();
+
+		if (!it->second.getIsRegister()
+			&& now - it->second.getSignonTime() >= getClass(it->second).registerTimeout)
+		{
+			scheduleDisconnect(it->first, "Registration timed out");
+			continue;
+		}
+
+		if (freq <= 0 || idle < freq)
+			continue;
+		if (!it->second.getPingSent())
+		{
+			sendToClient(it->first, std::string("PING :") + SERVER_NAME + IRC_CRLF);
+			it->second.setPingSent();
+		}
+		else if (idle >= 2 * freq)
+			scheduleDisconnect(it->first, "Ping timeout: " + toString(idle) + " seconds");
+	}
+}
@@ -0,0 +1,153 @@
+/* ************************************************************************** */
+/*                                                                          */
+/*                                                        :::      ::::::::   */
+/*   GlobMask.cpp                                       :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: adrien <adrien@student.42.fr>              +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/19 14:24:09 by adrien            #+#    #+#             */
+/*   Updated: 2026/10/19 15:26:03 by adrien           ###   ########.fr       */
+/*                                                                          */
+/* ************************************************************************** */
+
+/*
+** ============================================================================
+**                           COMPILED GLOB MASK
+** ============================================================================
+**
+**  compile("*!*@*.example.*"): lowercases the mask once and cuts it on '*'
+**      → parts ["", "!", "@", ".example.", ""]
+**  match(text): the first part must match at the start, the last one at
+**      the end, the middle ones are searched left to right (greedy
+**      leftmost is enough without backtracking); '?' matches any char
+**
+**  Matching is case-insensitive (ASCII) and never allocates.
+**
+** ============================================================================
+*/
+
+#include "../includes/GlobMask.hpp"
+#include <cctype>
+
+/*
+ * Default constructor, matches only the empty string
+ */
+GlobMask::GlobMask() : minLength(0), wildcard(false) {}
+
+/*
+ * Constructor compiling a mask
+ * @param mask the glob mask
+ */
+GlobMask::GlobMask(const std::string &mask)
+{
+	compile(mask);
+}
+
+/*
+ * Copy constructor
+ * @param src the mask to copy
+ */
+GlobMask::GlobMask(const GlobMask &src)
+{
+	*this = src;
+}
+
+/*
+ * Assignment operator
+ * @param src the mask to copy
+ * @return reference to this mask
+ */
+GlobMask &GlobMask::operator=(const GlobMask &src)
+{
+	if (this != &src)
+	{
+		this->parts = src.parts;
+		this->minLength = src.minLength;
+		this->wildcard = src.wildcard;
+	}
+	return (*this);
+}
+
+/*
+ * Destructor
+ */
+GlobMask::~GlobMask() {}
+
+/*
+ * Compile a mask
+ * @param mask the glob mask ('*' any sequence, '?' any character)
+ * @return void
+ */
+void GlobMask::compile(const std::string &mask)
+{
+	std::string part;
+
+	this->parts.clear();
+	this->minLength = 0;
+	this->wildcard = false;
+	for (size_t i = 0; i < mask.length(); i++)
+	{
+		if (mask[i] == '*')
+		{
+			this->parts.push_back(part);
+			part.clear();
+			this->wildcard = true;
+			while (i + 1 < mask.length() && mask[i + 1] == '*')
+				i++;
+		}
+		else
+		{
+			part += std::tolower(mask[i]);
+			this->minLength++;
+		}
+	}
+	this->parts.push_back(part);
+}
+
+/*
+ * Compare a part with the text at a position ('?' matches anything)
+ * @param part the mask part
+ * @param text the text
+ * @param pos the position in the text
+ * @return true if the part matches there
+ */
+bool GlobMask::matchAt(const std::string &part, const std::string &text, size_t pos)
+{
+	for (size_t i = 0; i < part.length(); i++)
+	{
+		if (part[i] != '?' && part[i] != std::tolower(text[pos + i]))
+			return (false);
+	}
+	return (true);
+}
+
+/*
+ * Match a text against the mask
+ * @param text the text to test
+ * @return true if the text matches
+ */
+bool GlobMask::match(const std::string &text) const
+{
+	if (text.length() < this->minLength)
+		return (false);
+	if (!this->wildcard)
+		return (text.length() == this->minLength && matchAt(this->parts[0], text, 0));
+
+	const std::string &first = this->parts.front();
+	const std::string &last = this->parts.back();
+	if (!matchAt(first, text, 0) || !matchAt(last, text, text.length() - last.length()))
+		return (false);
+
+	size_t pos = first.length();
+	const size_t end = text.length() - last.length();
+	for (size_t i = 1; i + 1 < this->parts.size(); i++)
+	{
+		const std::string &part = this->parts[i];
+		while (pos + part.length() <= end && !matchAt(part, text, pos))
+			pos++;
+		if (pos + part.length() > end)
+			return (false);
+		pos += part.length();
+	}
+	return (true);
+}
@@ -0,0 +1,182 @@
+/* ************************************************************************** */
+/*                                                                          */
+/*                                                        :::      ::::::::   */
+/*   HeavyHitters.cpp                                   :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: adrien <adrien@student.42.fr>              +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/19 11:20:34 by adrien            #+#    #+#             */
+/*   Updated: 2026/10/19 11:20:34 by adrien           ###   ########.fr       */
+/*                                                                          */
+/* ************************************************************************** */
+
+/*
+** ============================================================================
+**                           HEAVY-HITTER SKETCH
+** ============================================================================
+**
+**  Count-Min: HH_DEPTH rows of HH_WIDTH counters, one hash per row.
+**             estimate = min over rows (never under-counts)
+**  Top-k:     HH_TOP_SIZE keys with the highest estimate, the smallest
+**             is evicted when a bigger key shows up
+**  decay():   Halves everything so the ranking follows recent traffic
+**
+**  Memory is fixed whatever the number of clients, IPs or channels.
+**
+** ============================================================================
+*/
+
+#include "../includes/HeavyHitters.hpp"
+#include <algorithm>
+
+/*
+ * Orders hitters from the biggest count to the smallest
+ */
+static bool compareHitters(const t_hitter &a, const t_hitter &b)
+{
+	return (a.count > b.count);
+}
+
+/*
+ * Default constructor for HeavyHitters class
+ */
+HeavyHitters::HeavyHitters() : sketch(HH_DEPTH * HH_WIDTH, 0), topSize(HH_TOP_SIZE), total(0) {}
+
+/*
+ * Copy constructor for HeavyHitters class
+ * @param src the HeavyHitters object to copy from
+ */
+HeavyHitters::HeavyHitters(const HeavyHitters &src)
+{
+	*this = src;
+}
+
+/*
+ * Assignment operator for HeavyHitters class
+ * @param src the HeavyHitters object to copy from
+ * @return reference to this HeavyHitters object
+ */
+HeavyHitters &HeavyHitters::operator=(const HeavyHitters &src)
+{
+	if (this == &src)
+		return (*this);
+	this->sketch = src.sketch;
+	this->top = src.top;
+	this->topSize = src.topSize;
+	this->total = src.total;
+	return (*this);
+}
+
+/*
+ * Destructor for HeavyHitters class
+ */
+HeavyHitters::~HeavyHitters() {}
+
+/*
+ * Seeded FNV-1a hash, one seed per sketch row
+ * @param key the key to hash
+ * @param seed the row number
+ * @return the hash value
+ */
+unsigned long HeavyHitters::hash(const std::string &key, unsigned long seed)
+{
+	unsigned long h = 2166136261UL ^ (seed * 0x9e3779b9UL);
+
+	for (size_t i = 0; i < key.length(); i++)
+	{
+		h ^= static_cast<unsigned char>(key[i]);
+		h *= 16777619UL;
+	}
+	h ^= h >> 15;
+	return (h);
+}
+
+/*
+ * Count an occurrence of a key
+ * @param key the key (client, IP or channel)
+ * @param weight how much to add (bytes, lines, recipients...)
+ */
+void HeavyHitters::add(const std::string &key, unsigned long weight)
+{
+	unsigned long count = 0;
+
+	this->total += weight;
+	for (unsigned long row = 0; row < HH_DEPTH; row++)
+	{
+		unsigned long &cell = this->sketch[row * HH_WIDTH + hash(key, row) % HH_WIDTH];
+		cell += weight;
+		if (row == 0 || cell < count)
+			count = cell;
+	}
+
+	size_t smallest = 0;
+	for (size_t i = 0; i < this->top.size(); i++)
+	{
+		if (this->top[i].key == key)
+		{
+			this->top[i].count = count;
+			return;
+		}
+		if (this->top[i].count < this->top[smallest].count)
+			smallest = i;
+	}
+
+	t_hitter hitter;
+	hitter.key = key;
+	hitter.count = count;
+	if (this->top.size() < this->topSize)
+		this->top.push_back(hitter);
+	else if (!this->top.empty() && count > this->top[smallest].count)
+		this->top[smallest] = hitter;
+}
+
+/*
+ * Estimate the count of a key (may over-estimate, never under-estimates)
+ * @param key the key to look up
+ * @return the estimated count
+ */
+unsigned long HeavyHitters::estimate(const std::string &key) const
+{
+	unsigned long count = 0;
+
+	for (unsigned long row = 0; row < HH_DEPTH; row++)
+	{
+		const unsigned long cell = this->sketch[row * HH_WIDTH + hash(key, row) % HH_WIDTH];
+		if (row == 0 || cell < count)
+			count = cell;
+	}
+	return (count);
+}
+
+/*
+ * Halve every counter so old traffic fades out of the ranking
+ */
+void HeavyHitters::decay()
+{
+	for (size_t i = 0; i < this->sketch.size(); i++)
+		this->sketch[i] >>= 1;
+	for (size_t i = 0; i < this->top.size(); )
+	{
+		this->top[i].count >>= 1;
+		if (this->top[i].count == 0)
+		{
+			this->top[i] = this->top.back();
+			this->top.pop_back();
+			continue;
+		}
+		i++;
+	}
+	this->total >>= 1;
+}
+
+/*
+ * Get the current top-k keys
+ * @return the heavy hitters, biggest first
+ */
+std::vector<t_hitter> HeavyHitters::getTop() const
+{
+	std::vector<t_hitter> sorted = this->top;
+
+	std::sort(sorted.begin(), sorted.end(), compareHitters);
+	return (sorted);
+}
@@ -0,0 +1,302 @@
+/* ************************************************************************** */
+/*                                                                          */
+/*                                                        :::      ::::::::   */
+/*   IpTable.cpp                                        :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: adrien <adrien@student.42.fr>              +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/19 13:34:52 by adrien            #+#    #+#             */
+/*   Updated: 2026/10/19 15:52:09 by adrien           ###   ########.fr       */
+/*                                                                          */
+/* ************************************************************************** */
+
+/*
+** ============================================================================
+**                           PER-IP TABLE
+** ============================================================================
+**
+**  Open addressing with linear probing over a power-of-two array,
+**  indexed by a multiplicative hash of the IPv4 address.
+**  Entry:  concurrent connections + connect score (+1 per attempt,
+**          halved every `halflife` seconds, computed lazily) + failed
+**          authentications (reset after `forget` seconds without one)
+**  Erase:  backward shift (no tombstones, probe chains stay short)
+**  Size:   doubles above 50% load, purge() drops idle entries
+**
+** ============================================================================
+*/
+
+#include "../includes/IpTable.hpp"
+#include <cmath>
+
+/*
+ * Default constructor
+ */
+IpTable::IpTable() : bits(IPTABLE_MIN_BITS), count(0)
+{
+	this->entries.resize(1UL << this->bits);
+	for (size_t i = 0; i < this->entries.size(); i++)
+		this->entries[i].used = false;
+}
+
+/*
+ * Copy constructor
+ * @param src the table to copy
+ */
+IpTable::IpTable(const IpTable &src)
+{
+	*this = src;
+}
+
+/*
+ * Assignment operator
+ * @param src the table to copy
+ * @return reference to this table
+ */
+IpTable &IpTable::operator=(const IpTable &src)
+{
+	if (this != &src)
+	{
+		this->entries = src.entries;
+		this->bits = src.bits;
+		this->count = src.count;
+	}
+	return (*this);
+}
+
+/*
+ * Destructor
+ */
+IpTable::~IpTable() {}
+
+/*
+ * Home slot of an address (Fibonacci hashing, top bits of the product)
+ * @param addr the address in host byte order
+ * @return the slot index
+ */
+size_t IpTable::home(unsigned int addr) const
+{
+	return ((unsigned int)(addr * 2654435761U) >> (32 - this->bits));
+}
+
+/*
+ * Find the slot of an address
+ * @param addr the address in host byte order
+ * @return the slot index, or IPTABLE_NPOS if the address is unknown
+ */
+size_t IpTable::find(unsigned int addr) const
+{
+	const size_t mask = this->entries.size() - 1;
+
+	for (size_t i = home(addr); this->entries[i].used; i = (i + 1) & mask)
+	{
+		if (this->entries[i].addr == addr)
+			return (i);
+	}
+	return (IPTABLE_NPOS);
+}
+
+/*
+ * Find the slot of an address, creating the entry if needed
+ * @param addr the address in host byte order
+ * @param now the current time
+ * @return the slot index
+ */
+size_t IpTable::insert(unsigned int addr, time_t now)
+{
+	if ((this->count + 1) * 2 > this->entries.size())
+		grow();
+
+	const size_t mask = this->entries.size() - 1;
+	size_t i = home(addr);
+	for (; this->entries[i].used; i = (i + 1) & mask)
+	{
+		if (this->entries[i].addr == addr)
+			return (i);
+	}
+
+	this->entries[i].used = true;
+	this->entries[i].addr = addr;
+	this->entries[i].connections = 0;
+	this->entries[i].score = 0;
+	this->entries[i].stamp = now;
+	this->entries[i].failures = 0;
+	this->entries[i].failStamp = 0;
+	this->count++;
+	return (i);
+}
+
+/*
+ * Remove the entry of a slot, shifting back the entries of its probe chain
+ * @param i the slot index
+ * @return void
+ */
+void IpTable::erase(size_t i)
+{
+	const size_t mask = this->entries.size() - 1;
+
+	this->entries[i].used = false;
+	this->count--;
+	for (size_t j = (i + 1) & mask; this->entries[j].used; j = (j + 1) & mask)
+	{
+		const size_t k = home(this->entries[j].addr);
+		// Move j into the hole if its home slot is not in ]i, j]
+		const bool between = (i <= j) ? (i < k && k <= j) : (i < k || k <= j);
+		if (!between)
+		{
+			this->entries[i] = this->entries[j];
+			this->entries[j].used = false;
+			i = j;
+		}
+	}
+}
+
+/*
+ * Double the table size and reinsert every entry
+ * @return void
+ */
+void IpTable::grow()
+{
+	std::vector<t_ipentry> old;
+	old.swap(this->entries);
+
+	this->bits++;
+	this->entries.resize(1UL << this->bits);
+	for (size_t i = 0; i < this->entries.size(); i++)
+		this->entries[i].used = false;
+
+	const size_t mask = this->entries.size() - 1;
+	for (size_t i = 0; i < old.size(); i++)
+	{
+		if (!old[i].used)
+			continue;
+		size_t j = home(old[i].addr);
+		while (this->entries[j].used)
+			j = (j + 1) & mask;
+		this->entries[j] = old[i];
+	}
+}
+
+/*
+ * Apply the exponential decay to the connect score of an entry
+ * @param entry the entry to update
+ * @param now the current time
+ * @param halflife the seconds it takes for the score to halve
+ * @return void
+ */
+void IpTable::decay(t_ipentry &entry, time_t now, long halflife)
+{
+	if (now > entry.stamp && halflife > 0)
+		entry.score *= std::pow(0.5, (double)(now - entry.stamp) / halflife);
+	entry.stamp = now;
+}
+
+/*
+ * Record a connection attempt
+ * @param addr the address in host byte order
+ * @param now the current time
+ * @param halflife the decay half-life of the connect score in seconds
+ * @return the entry of the address, with its updated score
+ */
+const t_ipentry &IpTable::attempt(unsigned int addr, time_t now, long halflife)
+{
+	t_ipentry &entry = this->entries[insert(addr, now)];
+
+	decay(entry, now, halflife);
+	entry.score += 1;
+	return (entry);
+}
+
+/*
+ * Count an accepted connection
+ * @param addr the address in host byte order
+ * @return void
+ */
+void IpTable::connected(unsigned int addr)
+{
+	const size_t i = find(addr);
+	if (i != IPTABLE_NPOS)
+		this->entries[i].connections++;
+}
+
+/*
+ * Count a closed connection
+ * @param addr the address in host byte order
+ * @return void
+ */
+void IpTable::disconnected(unsigned int addr)
+{
+	const size_t i = find(addr);
+	if (i != IPTABLE_NPOS && this->entries[i].connections > 0)
+		this->entries[i].connections--;
+}
+
+/*
+ * Number of open connections of an address
+ * @param addr the address in host byte order
+ * @return the connection count
+ */
+unsigned int IpTable::connections(unsigned int addr) const
+{
+	const size_t i = find(addr);
+	return (i == IPTABLE_NPOS ? 0 : this->entries[i].connections);
+}
+
+/*
+ * Count a failed authentication (PASS/OPER) from an address
+ * Failures older than `forget` seconds are forgotten first
+ * @param addr the address in host byte order
+ * @param now the current time
+ * @param forget the seconds after which the failures are reset
+ * @return the number of recent failures, this one included
+ */
+unsigned int IpTable::fail(unsigned int addr, time_t now, long forget)
+{
+	t_ipentry &entry = this->entries[insert(addr, now)];
+
+	if (now - entry.failStamp > forget)
+		entry.failures = 0;
+	entry.failStamp = now;
+	return (++entry.failures);
+}
+
+/*
+ * Reset the failed authentications of an address
+ * @param addr the address in host byte order
+ * @return void
+ */
+void IpTable::clearFailures(unsigned int addr)
+{
+	const size_t i = find(addr);
+	if (i != IPTABLE_NPOS)
+		this->entries[i].failures = 0;
+}
+
+/*
+ * Forget the addresses without connections whose score has decayed away
+ * and without recent failed authentications
+ * @param now the current time
+ * @param halflife the decay half-life of the connect score in seconds
+ * @param forget the seconds after which the failures are reset
+ * @return void
+ */
+void IpTable::purge(time_t now, long halflife, long forget)
+{
+	size_t i = 0;
+
+	while (i < this->entries.size())
+	{
+		t_ipentry &entry = this->entries[i];
+		if (entry.used && entry.connections == 0)
+		{
+			decay(entry, now, halflife);
+			if (entry.score < IPTABLE_FORGET
+				&& (entry.failures == 0 || now - entry.failStamp > forget))
+			{
+				erase(i);
+				continue; // another entry may have been shifted here
+			}
+		}
+		i++;
+	}
+}
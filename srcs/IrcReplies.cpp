@@ -6,7 +6,7 @@
 /*   By: adrien <adrien@student.42.fr>              +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/12/16 04:10:00 by hdelacou          #+#    #+#             */
-/*   Updated: 2026/01/21 00:51:49 by adrien           ###   ########.fr       */
+/*   Updated: 2026/10/20 11:03:15 by adrien           ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -27,25 +27,28 @@
 
 #include "../includes/Server.hpp"
 #include "../includes/IrcReplies.hpp"
-#include <sstream>
 
 /* Send a generic numeric reply to a client */
 void Server::sendNumericReply(const int &clientFd, int code,
 							  const std::string &params,
 							  const std::string &message)
 {
-	std::string nick = this->Users[clientFd].getNickname();
-	if (nick.empty())
-		nick = "*";
+	sendNumericReply(clientFd, code, params, "", message);
+}
 
-	std::ostringstream oss;
-	oss << ":" << SERVER_NAME << " " << code << " " << nick;
-	if (!params.empty())
-		oss << " " << params;
-	oss << " :" << message << IRC_CRLF;
+/* Send a numeric reply with two middle parameters, composed in place */
+void Server::sendNumericReply(const int &clientFd, int code,
+							  const std::string &param,
+							  const std::string &param2,
+							  const std::string &message)
+{
+	std::map<int, User>::const_iterator it = this->Users.find(clientFd);
+	if (it == this->Users.end())
+		return;
 
-	std::string response = oss.str();
-	send(clientFd, response.c_str(), response.length(), 0);
+	ReplyBuilder reply;
+	reply.start(code, it->second.getNickname()).param(param).param(param2).trailing(message);
+	sendToClient(clientFd, reply);
 }
 
 /* ERR_NOSUCHNICK (401): No such nick/channel */
@@ -54,6 +57,18 @@ void Server::sendERR_NOSUCHNICK(const int &clientFd, const std::string &nickname
 	sendNumericReply(clientFd, ERR_NOSUCHNICK, nickname, MSG_ERR_NOSUCHNICK);
 }
 
+/* ERR_WASNOSUCHNICK (406): No such nickname in the WHOWAS history */
+void Server::sendERR_WASNOSUCHNICK(const int &clientFd, const std::string &nickname)
+{
+	sendNumericReply(clientFd, ERR_WASNOSUCHNICK, nickname, MSG_ERR_WASNOSUCHNICK);
+}
+
+/* ERR_TOOMANYTARGETS (407): More targets than MAX_TARGETS */
+void Server::sendERR_TOOMANYTARGETS(const int &clientFd, const std::string &target)
+{
+	sendNumericReply(clientFd, ERR_TOOMANYTARGETS, target, MSG_ERR_TOOMANYTARGETS);
+}
+
 /* ERR_NOSUCHSERVER (402): No such server */
 void Server::sendERR_NOSUCHSERVER(const int &clientFd, const std::string &server)
 {
@@ -126,6 +141,18 @@ void Server::sendERR_CHANNELISFULL(const int &clientFd, const std::string &chann
 	sendNumericReply(clientFd, ERR_CHANNELISFULL, channel, MSG_ERR_CHANNELISFULL);
 }
 
+/* ERR_BANLISTFULL (478): Channel list is full */
+void Server::sendERR_BANLISTFULL(const int &clientFd, const std::string &channel, const std::string &mask)
+{
+	sendNumericReply(clientFd, ERR_BANLISTFULL, channel, mask, MSG_ERR_BANLISTFULL);
+}
+
+/* ERR_BANNICKCHANGE (435): Cannot change nickname while banned on channel */
+void Server::sendERR_BANNICKCHANGE(const int &clientFd, const std::string &nick, const std::string &channel)
+{
+	sendNumericReply(clientFd, ERR_BANNICKCHANGE, nick, channel, MSG_ERR_BANNICKCHANGE);
+}
+
 /* ERR_INVITEONLYCHAN (473): Cannot join channel (+i) */
 void Server::sendERR_INVITEONLYCHAN(const int &clientFd, const std::string &channel)
 {
@@ -162,6 +189,13 @@ void Server::sendERR_CHANOPRIVSNEEDED(const int &clientFd, const std::string &ch
 	sendNumericReply(clientFd, ERR_CHANOPRIVSNEEDED, channel, MSG_ERR_CHANOPRIVSNEEDED);
 }
 
+/* ERR_YOUREBANNEDCREEP (465): You are banned from this server */
+void Server::sendERR_YOUREBANNEDCREEP(const int &clientFd, const std::string &reason)
+{
+	sendNumericReply(clientFd, ERR_YOUREBANNEDCREEP, "",
+	                 std::string(MSG_ERR_YOUREBANNEDCREEP) + " - " + reason);
+}
+
 /* ERR_CANTKILLSERVER (483): You can't kill a server! */
 void Server::sendERR_CANTKILLSERVER(const int &clientFd)
 {
@@ -174,6 +208,66 @@ void Server::sendERR_NOOPERHOST(const int &clientFd)
 	sendNumericReply(clientFd, ERR_NOOPERHOST, "", MSG_ERR_NOOPERHOST);
 }
 
+/* ERR_UMODEUNKNOWNFLAG (501): Unknown MODE flag */
+void Server::sendERR_UMODEUNKNOWNFLAG(const int &clientFd)
+{
+	sendNumericReply(clientFd, ERR_UMODEUNKNOWNFLAG, "", MSG_ERR_UMODEUNKNOWNFLAG);
+}
+
+/* ERR_USERSDONTMATCH (502): Cannot change mode for other users */
+void Server::sendERR_USERSDONTMATCH(const int &clientFd)
+{
+	sendNumericReply(clientFd, ERR_USERSDONTMATCH, "", MSG_ERR_USERSDONTMATCH);
+}
+
+/* RPL_STATSLINKINFO (211): One connection in STATS l */
+void Server::sendRPL_STATSLINKINFO(const int &clientFd, const std::string &link, const std::string &info)
+{
+	sendNumericReply(clientFd, RPL_STATSLINKINFO, link, info);
+}
+
+/* RPL_ENDOFSTATS (219): End of STATS report */
+void Server::sendRPL_ENDOFSTATS(const int &clientFd, const std::string &query)
+{
+	sendNumericReply(clientFd, RPL_ENDOFSTATS, query, MSG_RPL_ENDOFSTATS);
+}
+
+/* RPL_BANLIST (367), RPL_EXCEPTLIST (348), RPL_INVITELIST (346): One list entry */
+void Server::sendRPL_MASKLIST(const int &clientFd, const std::string &channel, char mode, const t_listmask &entry)
+{
+	const int code = (mode == 'b') ? RPL_BANLIST : (mode == 'e') ? RPL_EXCEPTLIST : RPL_INVITELIST;
+	sendNumericReply(clientFd, code, channel + " " + entry.mask + " " + entry.setter, toString(entry.setAt));
+}
+
+/* RPL_ENDOFBANLIST (368), RPL_ENDOFEXCEPTLIST (349), RPL_ENDOFINVITELIST (347) */
+void Server::sendRPL_ENDOFMASKLIST(const int &clientFd, const std::string &channel, char mode)
+{
+	if (mode == 'b')
+		sendNumericReply(clientFd, RPL_ENDOFBANLIST, channel, MSG_RPL_ENDOFBANLIST);
+	else if (mode == 'e')
+		sendNumericReply(clientFd, RPL_ENDOFEXCEPTLIST, channel, MSG_RPL_ENDOFEXCEPTLIST);
+	else
+		sendNumericReply(clientFd, RPL_ENDOFINVITELIST, channel, MSG_RPL_ENDOFINVITELIST);
+}
+
+/* RPL_UMODEIS (221): Current user modes */
+void Server::sendRPL_UMODEIS(const int &clientFd, const std::string &modes)
+{
+	std::map<int, User>::const_iterator it = this->Users.find(clientFd);
+	if (it == this->Users.end())
+		return;
+
+	ReplyBuilder reply;
+	reply.start(RPL_UMODEIS, it->second.getNickname()).param(modes);
+	sendToClient(clientFd, reply);
+}
+
+/* RPL_STATSDEBUG (249): Free-form STATS line */
+void Server::sendRPL_STATSDEBUG(const int &clientFd, const std::string &text)
+{
+	sendNumericReply(clientFd, RPL_STATSDEBUG, "", text);
+}
+
 /* RPL_AWAY (301): User is away */
 void Server::sendRPL_AWAY(const int &clientFd, const std::string &nick,
 						  const std::string &awayMsg)
@@ -211,6 +305,24 @@ void Server::sendRPL_ENDOFWHOIS(const int &clientFd, const std::string &nick)
 	sendNumericReply(clientFd, RPL_ENDOFWHOIS, nick, MSG_RPL_ENDOFWHOIS);
 }
 
+/* RPL_ENDOFWHO (315): End of WHO */
+void Server::sendRPL_ENDOFWHO(const int &clientFd, const std::string &mask)
+{
+	sendNumericReply(clientFd, RPL_ENDOFWHO, mask.empty() ? "*" : mask, MSG_RPL_ENDOFWHO);
+}
+
+/* RPL_LISTSTART (321): Start of LIST */
+void Server::sendRPL_LISTSTART(const int &clientFd)
+{
+	sendNumericReply(clientFd, RPL_LISTSTART, "Channel", MSG_RPL_LISTSTART);
+}
+
+/* RPL_LIST (322): One channel of LIST */
+void Server::sendRPL_LIST(const int &clientFd, const std::string &channel, int visible, const std::string &topic)
+{
+	sendNumericReply(clientFd, RPL_LIST, channel, toString(visible), topic);
+}
+
 /* RPL_LISTEND (323): End of LIST */
 void Server::sendRPL_LISTEND(const int &clientFd)
 {
@@ -227,78 +339,48 @@ void Server::sendRPL_ENDOFNAMES(const int &clientFd, Channel &channel)
 void Server::sendError(const int &clientFd, const std::string &message)
 {
 	std::string response = "ERROR :" + message + IRC_CRLF;
-	send(clientFd, response.c_str(), response.length(), 0);
+	sendToClient(clientFd, response);
 }
 
 /* ERR_NOSUCHCHANNEL (403): No such channel */
 void Server::sendERR_NOSUCHCHANNEL(const int &clientFd, const std::string &channel)
 {
-	sendNumericReply(clientFd, 403, channel, "No such channel");
+	sendNumericReply(clientFd, ERR_NOSUCHCHANNEL, channel, MSG_ERR_NOSUCHCHANNEL);
 }
 
 /* ERR_CANNOTSENDTOCHAN (404): Cannot send to channel */
 void Server::sendERR_CANNOTSENDTOCHAN(const int &clientFd, const std::string &channel)
 {
-	sendNumericReply(clientFd, 404, channel, "Cannot send to channel");
+	sendNumericReply(clientFd, ERR_CANNOTSENDTOCHAN, channel, MSG_ERR_CANNOTSENDTOCHAN);
 }
 
 /* ERR_USERNOTINCHANNEL (441): They aren't on that channel */
 void Server::sendERR_USERNOTINCHANNEL(const int &clientFd, const std::string &nick, const std::string &channel)
 {
-	sendNumericReply(clientFd, 441, nick + " " + channel, "They aren't on that channel");
+	sendNumericReply(clientFd, ERR_USERNOTINCHANNEL, nick, channel, MSG_ERR_USERNOTINCHANNEL);
 }
 
 /* ERR_USERONCHANNEL (443): is already on channel */
 void Server::sendERR_USERONCHANNEL(const int &clientFd, const std::string &user, const std::string &channel)
 {
-	sendNumericReply(clientFd, 443, user + " " + channel, "is already on channel");
+	sendNumericReply(clientFd, ERR_USERONCHANNEL, user, channel, MSG_ERR_USERONCHANNEL);
 }
 
 /* ERR_UNKNOWNMODE (472): is unknown mode char to me */
 void Server::sendERR_UNKNOWNMODE(const int &clientFd, char c)
 {
-	std::string charStr(1, c);
-	sendNumericReply(clientFd, 472, charStr, "is unknown mode char to me");
+	const std::string mode(1, c);
+	sendNumericReply(clientFd, ERR_UNKNOWNMODE, mode, MSG_ERR_UNKNOWNMODE);
 }
 
 /* RPL_TOPIC (332): Channel topic */
 void Server::sendRPL_TOPIC(const int &clientFd, const Channel &channel)
 {
-	std::string nick = this->Users[clientFd].getNickname();
-	if (nick.empty()) nick = "*";
-
-	std::string response = ":" + std::string(SERVER_NAME) + " 332 " + nick + " " +
-	                       channel.getName() + " :" + channel.getTopic() + IRC_CRLF;
-	send(clientFd, response.c_str(), response.length(), 0);
+	sendNumericReply(clientFd, RPL_TOPIC, channel.getName(), channel.getTopic());
 }
 
 /* RPL_NOTOPIC (331): No topic is set */
 void Server::sendRPL_NOTOPIC(const int &clientFd, const Channel &channel)
 {
-	std::string nick = this->Users[clientFd].getNickname();
-	if (nick.empty()) nick = "*";
-
-	std::string response = ":" + std::string(SERVER_NAME) + " 331 " + nick + " " +
-	                       channel.getName() + " :No topic is set" + IRC_CRLF;
-	send(clientFd, response.c_str(), response.length(), 0);
-}
-
-/* RPL_NAMREPLY (353): Names list */
-void Server::sendRPL_NAMEREPLY(const int &clientFd, Channel &channel)
-{
-	std::string nick = this->Users[clientFd].getNickname();
-	if (nick.empty()) nick = "*";
-
-	std::string names = "";
-	std::vector<int> members = channel.getAllMembers();
-	for (size_t i = 0; i < members.size(); i++) {
-		if (i > 0) names += " ";
-		if (channel.isOperator(members[i]))
-			names += "@";
-		names += this->Users[members[i]].getNickname();
-	}
-
-	std::string response = ":" + std::string(SERVER_NAME) + " 353 " + nick + " = " +
-	                       channel.getName() + " :" + names + IRC_CRLF;
-	send(clientFd, response.c_str(), response.length(), 0);
+	sendNumericReply(clientFd, RPL_NOTOPIC, channel.getName(), MSG_NOTOPIC);
 }
@@ -0,0 +1,348 @@
+/* ************************************************************************** */
+/*                                                                          */
+/*                                                        :::      ::::::::   */
+/*   MaskList.cpp                                       :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: adrien <adrien@student.42.fr>              +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/19 16:07:31 by adrien            #+#    #+#             */
+/*   Updated: 2026/10/19 16:07:31 by adrien           ###   ########.fr       */
+/*                                                                          */
+/* ************************************************************************** */
+
+/*
+** ============================================================================
+**                           CHANNEL MASK LISTS
+** ============================================================================
+**
+**  Masks are normalized to nick!user@host ("foo" → "foo!*@*",
+**  "*.net" → "*!*@*.net", "u@h" → "*!u@h"), compiled once, and indexed
+**  by the first literal part a client must share with them:
+**  - host without wildcard ("1.2.3.4", "host.net")   → exact host map
+**  - "*.suffix" host                                 → suffix map
+**  - "prefix.*" host ("10.0.*")                      → prefix map
+**  - otherwise, nick without wildcard ("troll!*@*")  → nick map
+**  - anything else                                   → short wild list
+**  match() probes the exact map once, the suffix and prefix maps once
+**  per dot of the client host and the nick map once, then runs the
+**  compiled globs of those buckets only: a 2k-entry ban list costs a
+**  handful of map lookups per check.
+**
+** ============================================================================
+*/
+
+#include "../includes/MaskList.hpp"
+#include <cctype>
+
+#define BUCKET_EXACT 0
+#define BUCKET_SUFFIX 1
+#define BUCKET_PREFIX 2
+#define BUCKET_NICK 3
+#define BUCKET_WILD 4
+
+/*
+ * Default constructor
+ */
+MaskList::MaskList() : nextId(0) {}
+
+/*
+ * Copy constructor
+ * @param src the list to copy
+ */
+MaskList::MaskList(const MaskList &src)
+{
+	*this = src;
+}
+
+/*
+ * Assignment operator
+ * @param src the list to copy
+ * @return reference to this list
+ */
+MaskList &MaskList::operator=(const MaskList &src)
+{
+	if (this != &src)
+	{
+		this->entries = src.entries;
+		this->ids = src.ids;
+		this->nextId = src.nextId;
+		this->exactHosts = src.exactHosts;
+		this->hostSuffixes = src.hostSuffixes;
+		this->hostPrefixes = src.hostPrefixes;
+		this->nicks = src.nicks;
+		this->wild = src.wild;
+	}
+	return (*this);
+}
+
+/*
+ * Destructor
+ */
+MaskList::~MaskList() {}
+
+/*
+ * Lowercase a string (masks are case-insensitive)
+ */
+static std::string lower(const std::string &text)
+{
+	std::string result = text;
+
+	for (size_t i = 0; i < result.length(); i++)
+		result[i] = std::tolower(result[i]);
+	return (result);
+}
+
+/*
+ * Check if a string holds a wildcard
+ */
+static bool hasWildcard(const std::string &text)
+{
+	return (text.find_first_of("*?") != std::string::npos);
+}
+
+/*
+ * Complete a mask to the nick!user@host form, empty parts become '*'
+ * @param mask the mask as given in MODE
+ * @return the normalized mask, "" if it is unusable
+ */
+std::string MaskList::normalize(const std::string &mask)
+{
+	if (mask.empty() || mask.find_first_of(" ,\r\n") != std::string::npos)
+		return ("");
+
+	std::string nick = "*";
+	std::string user = "*";
+	std::string host = "*";
+	const size_t bang = mask.find('!');
+	const size_t at = mask.find('@', bang == std::string::npos ? 0 : bang);
+
+	if (bang == std::string::npos && at == std::string::npos)
+	{
+		// A bare word is a nick, unless it looks like a host
+		if (mask.find_first_of(".:") != std::string::npos)
+			host = mask;
+		else
+			nick = mask;
+	}
+	else
+	{
+		const size_t userStart = (bang == std::string::npos) ? 0 : bang + 1;
+		if (bang != std::string::npos && bang > 0)
+			nick = mask.substr(0, bang);
+		if (at == std::string::npos)
+			user = mask.substr(userStart);
+		else
+		{
+			user = mask.substr(userStart, at - userStart);
+			host = mask.substr(at + 1);
+		}
+	}
+	if (user.empty())
+		user = "*";
+	if (host.empty())
+		host = "*";
+	return (nick + "!" + user + "@" + host);
+}
+
+/*
+ * Remove one id from an index list
+ * @param list the list
+ * @param id the id to remove
+ * @return void
+ */
+void MaskList::dropId(std::vector<int> &list, int id)
+{
+	for (size_t i = 0; i < list.size(); i++)
+	{
+		if (list[i] == id)
+		{
+			list[i] = list.back();
+			list.pop_back();
+			return;
+		}
+	}
+}
+
+/*
+ * Compile a mask and file it in the bucket of its literal part
+ * @param id the mask id
+ * @return void
+ */
+void MaskList::index(int id)
+{
+	t_maskentry &entry = this->entries[id];
+	const std::string mask = lower(entry.info.mask);
+	const std::string nick = mask.substr(0, mask.find('!'));
+	const std::string host = mask.substr(mask.rfind('@') + 1);
+
+	entry.compiled.compile(mask);
+	if (!hasWildcard(host))
+	{
+		entry.bucket = BUCKET_EXACT;
+		entry.key = host;
+		this->exactHosts[host].push_back(id);
+	}
+	else if (host.length() > 2 && host[0] == '*' && host[1] == '.' && !hasWildcard(host.substr(1)))
+	{
+		entry.bucket = BUCKET_SUFFIX;
+		entry.key = host.substr(1);
+		this->hostSuffixes[entry.key].push_back(id);
+	}
+	else if (host.length() > 2 && host[host.length() - 1] == '*' && host[host.length() - 2] == '.'
+			 && !hasWildcard(host.substr(0, host.length() - 1)))
+	{
+		entry.bucket = BUCKET_PREFIX;
+		entry.key = host.substr(0, host.length() - 1);
+		this->hostPrefixes[entry.key].push_back(id);
+	}
+	else if (!hasWildcard(nick))
+	{
+		entry.bucket = BUCKET_NICK;
+		entry.key = nick;
+		this->nicks[nick].push_back(id);
+	}
+	else
+	{
+		entry.bucket = BUCKET_WILD;
+		this->wild.push_back(id);
+	}
+}
+
+/*
+ * Take a mask out of its bucket
+ * @param id the mask id
+ * @return void
+ */
+void MaskList::unindex(int id)
+{
+	const t_maskentry &entry = this->entries[id];
+	std::map<std::string, std::vector<int> > *table;
+
+	if (entry.bucket == BUCKET_EXACT)
+		table = &this->exactHosts;
+	else if (entry.bucket == BUCKET_SUFFIX)
+		table = &this->hostSuffixes;
+	else if (entry.bucket == BUCKET_PREFIX)
+		table = &this->hostPrefixes;
+	else if (entry.bucket == BUCKET_NICK)
+		table = &this->nicks;
+	else
+	{
+		dropId(this->wild, id);
+		return;
+	}
+
+	std::map<std::string, std::vector<int> >::iterator it = table->find(entry.key);
+	if (it == table->end())
+		return;
+	dropId(it->second, id);
+	if (it->second.empty())
+		table->erase(it);
+}
+
+/*
+ * Add a mask
+ * @param mask the mask (normalized with normalize())
+ * @param setter who set it
+ * @param setAt when it was set
+ * @return false if the mask is already listed or the list is full
+ */
+bool MaskList::add(const std::string &mask, const std::string &setter, time_t setAt)
+{
+	const std::string key = lower(mask);
+	if (this->ids.find(key) != this->ids.end() || this->entries.size() >= MASKLIST_MAX_ENTRIES)
+		return (false);
+
+	const int id = this->nextId++;
+	t_maskentry &entry = this->entries[id];
+	entry.info.mask = mask;
+	entry.info.setter = setter;
+	entry.info.setAt = setAt;
+	this->ids[key] = id;
+	index(id);
+	return (true);
+}
+
+/*
+ * Remove a mask
+ * @param mask the mask (normalized with normalize())
+ * @return false if the mask was not listed
+ */
+bool MaskList::remove(const std::string &mask)
+{
+	std::map<std::string, int>::iterator it = this->ids.find(lower(mask));
+	if (it == this->ids.end())
+		return (false);
+
+	unindex(it->second);
+	this->entries.erase(it->second);
+	this->ids.erase(it);
+	return (true);
+}
+
+/*
+ * Run the compiled masks of a bucket
+ * @param list the ids of the bucket
+ * @param hostmask the lowercase nick!user@host
+ * @return true if one of them matches
+ */
+bool MaskList::matchAny(const std::vector<int> &list, const std::string &hostmask) const
+{
+	for (size_t i = 0; i < list.size(); i++)
+	{
+		if (this->entries.find(list[i])->second.compiled.match(hostmask))
+			return (true);
+	}
+	return (false);
+}
+
+/*
+ * Run the compiled masks of one key of an index
+ * @param table the index
+ * @param key the literal part of the client
+ * @param hostmask the lowercase nick!user@host
+ * @return true if one of them matches
+ */
+bool MaskList::matchBucket(const std::map<std::string, std::vector<int> > &table,
+						   const std::string &key, const std::string &hostmask) const
+{
+	std::map<std::string, std::vector<int> >::const_iterator it = table.find(key);
+	return (it != table.end() && matchAny(it->second, hostmask));
+}
+
+/*
+ * Check a client against the list
+ * @param hostmask the client nick!user@host
+ * @return true if one of the masks matches
+ */
+bool MaskList::match(const std::string &hostmask) const
+{
+	if (this->entries.empty())
+		return (false);
+
+	const std::string mask = lower(hostmask);
+	const std::string host = mask.substr(mask.rfind('@') + 1);
+
+	if (matchBucket(this->exactHosts, host, mask))
+		return (true);
+	for (size_t dot = host.find('.'); dot != std::string::npos; dot = host.find('.', dot + 1))
+	{
+		if ((!this->hostSuffixes.empty() && matchBucket(this->hostSuffixes, host.substr(dot), mask))
+			|| (!this->hostPrefixes.empty() && matchBucket(this->hostPrefixes, host.substr(0, dot + 1), mask)))
+			return (true);
+	}
+	return (matchBucket(this->nicks, mask.substr(0, mask.find('!')), mask)
+			|| matchAny(this->wild, mask));
+}
+
+/*
+ * Copy the masks in the order they were set
+ * @param masks the vector to fill
+ * @return void
+ */
+void MaskList::list(std::vector<t_listmask> &masks) const
+{
+	for (std::map<int, t_maskentry>::const_iterator it = this->entries.begin();
+		 it != this->entries.end(); ++it)
+		masks.push_back(it->second.info);
+}
@@ -0,0 +1,161 @@
+/* ************************************************************************** */
+/*                                                                          */
+/*                                                        :::      ::::::::   */
+/*   MonitorIndex.cpp                                   :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: adrien <adrien@student.42.fr>              +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/19 21:46:37 by adrien            #+#    #+#             */
+/*   Updated: 2026/10/19 21:46:37 by adrien           ###   ########.fr       */
+/*                                                                          */
+/* ************************************************************************** */
+
+/*
+** ============================================================================
+**                          MONITOR INDEX
+** ============================================================================
+**
+**  watchers: "bob" → {4, 9}            who to tell when bob comes or goes
+**  targets:  4 → {"bob" → "Bob", ...}  what fd 4 watches, as typed
+**
+**  Both sides change together; a watcher leaving drops its entries from
+**  every watched nick, a nick nobody watches any more is erased.
+**
+** ============================================================================
+*/
+
+#include "../includes/MonitorIndex.hpp"
+#include <cctype>
+
+MonitorIndex::MonitorIndex()
+{
+}
+
+MonitorIndex::MonitorIndex(const MonitorIndex &src)
+{
+	*this = src;
+}
+
+MonitorIndex &MonitorIndex::operator=(const MonitorIndex &src)
+{
+	if (this != &src)
+	{
+		this->watchers = src.watchers;
+		this->targets = src.targets;
+	}
+	return (*this);
+}
+
+MonitorIndex::~MonitorIndex()
+{
+}
+
+/*
+ * This function case-folds a nickname (CASEMAPPING=ascii)
+ * @param nick the nickname
+ * @return its key
+ */
+std::string MonitorIndex::key(const std::string &nick)
+{
+	std::string folded = nick;
+
+	for (size_t i = 0; i < folded.length(); i++)
+		folded[i] = std::tolower(folded[i]);
+	return (folded);
+}
+
+/*
+ * This function adds a nick to the watch list of a client
+ * @param fd the watching client
+ * @param nick the nick as typed
+ * @return false if the client was already watching it
+ */
+bool MonitorIndex::add(int fd, const std::string &nick)
+{
+	const std::string folded = key(nick);
+
+	if (!this->targets[fd].insert(std::make_pair(folded, nick)).second)
+		return (false);
+	this->watchers[folded].insert(fd);
+	return (true);
+}
+
+/*
+ * This function removes a nick from the watch list of a client
+ * @param fd the watching client
+ * @param nick the nick
+ * @return void
+ */
+void MonitorIndex::remove(int fd, const std::string &nick)
+{
+	const std::string folded = key(nick);
+	std::map<int, std::map<std::string, std::string> >::iterator list = this->targets.find(fd);
+
+	if (list == this->targets.end() || !list->second.erase(folded))
+		return;
+	if (list->second.empty())
+		this->targets.erase(list);
+
+	std::map<std::string, std::set<int> >::iterator it = this->watchers.find(folded);
+	it->second.erase(fd);
+	if (it->second.empty())
+		this->watchers.erase(it);
+}
+
+/*
+ * This function empties the watch list of a client
+ * @param fd the watching client
+ * @return void
+ */
+void MonitorIndex::clear(int fd)
+{
+	std::map<int, std::map<std::string, std::string> >::iterator list = this->targets.find(fd);
+
+	if (list == this->targets.end())
+		return;
+	for (std::map<std::string, std::string>::iterator target = list->second.begin();
+	     target != list->second.end(); ++target)
+	{
+		std::map<std::string, std::set<int> >::iterator it = this->watchers.find(target->first);
+		it->second.erase(fd);
+		if (it->second.empty())
+			this->watchers.erase(it);
+	}
+	this->targets.erase(list);
+}
+
+/*
+ * This function gives the size of the watch list of a client
+ * @param fd the watching client
+ * @return the number of nicks it watches
+ */
+size_t MonitorIndex::count(int fd) const
+{
+	std::map<int, std::map<std::string, std::string> >::const_iterator list = this->targets.find(fd);
+
+	return (list == this->targets.end() ? 0 : list->second.size());
+}
+
+/*
+ * This function gives the clients watching a nick
+ * @param nick the nick (any case)
+ * @return the watchers, NULL if nobody watches it
+ */
+const std::set<int> *MonitorIndex::watchersOf(const std::string &nick) const
+{
+	std::map<std::string, std::set<int> >::const_iterator it = this->watchers.find(key(nick));
+
+	return (it == this->watchers.end() ? NULL : &it->second);
+}
+
+/*
+ * This function gives the watch list of a client
+ * @param fd the watching client
+ * @return key -> nick as typed, NULL if it watches nothing
+ */
+const std::map<std::string, std::string> *MonitorIndex::targetsOf(int fd) const
+{
+	std::map<int, std::map<std::string, std::string> >::const_iterator list = this->targets.find(fd);
+
+	return (list == this->targets.end() ? NULL : &list->second);
+}
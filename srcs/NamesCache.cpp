@@ -0,0 +1,217 @@
+/* ************************************************************************** */
+/*                                                                          */
+/*                                                        :::      ::::::::   */
+/*   NamesCache.cpp                                     :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: adrien <adrien@student.42.fr>              +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/19 19:41:08 by adrien            #+#    #+#             */
+/*   Updated: 2026/10/19 19:41:08 by adrien           ###   ########.fr       */
+/*                                                                          */
+/* ************************************************************************** */
+
+/*
+** ============================================================================
+**                             NAMES CACHE
+** ============================================================================
+**
+**  The 353 lines of a channel only differ by the nickname of whoever
+**  asks, so the member list is kept pre-chunked:
+**    chunks  = "@alice bob carol ...", "dave @erin ...", ...
+**    entries = fd → nick, op, chunk holding its token
+**  Each chunk fits in one line with the longest recipient nickname.
+**  - join:       token appended to the last chunk (or a new one)
+**  - part/kick:  token cut out of its chunk
+**  - nick, +o/-o: token cut out, the new one appended
+**  When removals leave more than twice the chunks the members need, the
+**  cache is dropped and rebuilt by the next NAMES.
+**
+** ============================================================================
+*/
+
+#include "../includes/NamesCache.hpp"
+#include "../includes/ReplyBuilder.hpp"
+
+NamesCache::NamesCache() : budget(0), bytes(0), built(false)
+{
+}
+
+NamesCache::NamesCache(const NamesCache &src)
+{
+	*this = src;
+}
+
+NamesCache &NamesCache::operator=(const NamesCache &src)
+{
+	if (this != &src)
+	{
+		this->chunks = src.chunks;
+		this->entries = src.entries;
+		this->header = src.header;
+		this->budget = src.budget;
+		this->bytes = src.bytes;
+		this->built = src.built;
+	}
+	return (*this);
+}
+
+NamesCache::~NamesCache()
+{
+}
+
+/*
+ * This function gives the NAMES token of a member
+ * @param entry the member
+ * @return "@nick" for an operator, "nick" otherwise
+ */
+std::string NamesCache::token(const t_namesentry &entry)
+{
+	return (entry.op ? "@" + entry.nick : entry.nick);
+}
+
+/*
+ * This function appends the token of a member to the last chunk, or to a
+ * new one when it is full
+ * @param entry the member, its chunk is updated
+ * @return void
+ */
+void NamesCache::place(t_namesentry &entry)
+{
+	const std::string name = token(entry);
+
+	if (this->chunks.empty() || this->chunks.back().size() + 1 + name.size() > this->budget)
+		this->chunks.push_back("");
+	std::string &chunk = this->chunks.back();
+	if (!chunk.empty())
+	{
+		chunk += ' ';
+		this->bytes++;
+	}
+	chunk += name;
+	this->bytes += name.size();
+	entry.chunk = this->chunks.size() - 1;
+}
+
+/*
+ * This function cuts the token of a member out of its chunk
+ * @param entry the member
+ * @return void
+ */
+void NamesCache::erase(const t_namesentry &entry)
+{
+	const std::string name = token(entry);
+	std::string &chunk = this->chunks[entry.chunk];
+
+	for (size_t pos = chunk.find(name); pos != std::string::npos; pos = chunk.find(name, pos + 1))
+	{
+		const size_t end = pos + name.size();
+		if ((pos > 0 && chunk[pos - 1] != ' ') || (end < chunk.size() && chunk[end] != ' '))
+			continue;
+		// Take one separator along, the one after unless it is the last token
+		const size_t from = (end < chunk.size() || pos == 0) ? pos : pos - 1;
+		const size_t length = (end < chunk.size()) ? name.size() + 1 : end - from;
+		chunk.erase(from, length);
+		this->bytes -= length;
+		return;
+	}
+}
+
+/*
+ * This function starts a new cache for a channel, members are then added
+ * @param channel the channel name
+ * @return void
+ */
+void NamesCache::build(const std::string &channel)
+{
+	const size_t prefix = sizeof(":" SERVER_NAME " 353 ") - 1 + IRC_MAX_NICKNAME_LENGTH;
+
+	clear();
+	this->header = " = " + channel + " :";
+	this->budget = REPLY_MAX_BODY - prefix - this->header.size();
+	if (prefix + this->header.size() + IRC_MAX_NICKNAME_LENGTH + 1 > REPLY_MAX_BODY)
+		this->budget = IRC_MAX_NICKNAME_LENGTH + 1;
+	this->built = true;
+}
+
+/*
+ * This function drops the cache, the next NAMES builds it again
+ * @return void
+ */
+void NamesCache::clear()
+{
+	this->chunks.clear();
+	this->entries.clear();
+	this->bytes = 0;
+	this->built = false;
+}
+
+/*
+ * This function adds a member
+ * @param fd the member file descriptor
+ * @param nick its nickname
+ * @param op true if it is channel operator
+ * @return void
+ */
+void NamesCache::add(int fd, const std::string &nick, bool op)
+{
+	if (!this->built || this->entries.count(fd))
+		return;
+
+	t_namesentry entry;
+	entry.nick = nick;
+	entry.op = op;
+	place(entry);
+	this->entries[fd] = entry;
+}
+
+/*
+ * This function removes a member, dropping the cache once the chunks
+ * are too sparse
+ * @param fd the member file descriptor
+ * @return void
+ */
+void NamesCache::remove(int fd)
+{
+	std::map<int, t_namesentry>::iterator it = this->entries.find(fd);
+	if (!this->built || it == this->entries.end())
+		return;
+
+	erase(it->second);
+	this->entries.erase(it);
+	if (this->chunks.size() > 2 * (this->bytes / this->budget + 1))
+		clear();
+}
+
+/*
+ * This function changes the nickname of a member
+ * @param fd the member file descriptor
+ * @param nick the new nickname
+ * @return void
+ */
+void NamesCache::rename(int fd, const std::string &nick)
+{
+	std::map<int, t_namesentry>::iterator it = this->entries.find(fd);
+	if (!this->built || it == this->entries.end() || it->second.nick == nick)
+		return;
+
+	erase(it->second);
+	it->second.nick = nick;
+	place(it->second);
+}
+
+/*
+ * This function gives or takes the operator prefix of a member
+ * @param fd the member file descriptor
+ * @param op true if it is now channel operator
+ * @return void
+ */
+void NamesCache::setOperator(int fd, bool op)
+{
+	std::map<int, t_namesentry>::iterator it = this->entries.find(fd);
+	if (!this->built || it == this->entries.end() || it->second.op == op)
+		return;
+
+	erase(it->second);
+	it->second.op = op;
+	place(it->second);
+}
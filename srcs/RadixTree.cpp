@@ -0,0 +1,320 @@
+/* ************************************************************************** */
+/*                                                                          */
+/*                                                        :::      ::::::::   */
+/*   RadixTree.cpp                                      :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: adrien <adrien@student.42.fr>              +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/19 14:10:22 by adrien            #+#    #+#             */
+/*   Updated: 2026/10/19 15:26:03 by adrien           ###   ########.fr       */
+/*                                                                          */
+/* ************************************************************************** */
+
+/*
+** ============================================================================
+**                           IPV4 RADIX TREE
+** ============================================================================
+**
+**  Path-compressed binary trie (PATRICIA): every node holds a whole
+**  prefix (key/len), single-child chains are collapsed, so n prefixes
+**  need at most 2n nodes whatever their length.
+**
+**  Node with value -1: "glue" node, only there to branch two subtrees
+**  lookup(addr): follows the bits of addr from the root, remembers the
+**                deepest node with a value → longest prefix match, at
+**                most 33 steps
+**  remove():     clears the value, then splices out the nodes left with
+**                less than two children; freed nodes are recycled
+**
+** ============================================================================
+*/
+
+#include "../includes/RadixTree.hpp"
+
+/*
+ * Default constructor, empty tree
+ */
+RadixTree::RadixTree() : root(-1), count(0) {}
+
+/*
+ * Copy constructor
+ * @param src the tree to copy
+ */
+RadixTree::RadixTree(const RadixTree &src)
+{
+	*this = src;
+}
+
+/*
+ * Assignment operator
+ * @param src the tree to copy
+ * @return reference to this tree
+ */
+RadixTree &RadixTree::operator=(const RadixTree &src)
+{
+	if (this != &src)
+	{
+		this->nodes = src.nodes;
+		this->freeNodes = src.freeNodes;
+		this->root = src.root;
+		this->count = src.count;
+	}
+	return (*this);
+}
+
+/*
+ * Destructor
+ */
+RadixTree::~RadixTree() {}
+
+/*
+ * Netmask of a prefix length
+ * @param len the prefix length (0 to 32)
+ * @return the mask in host byte order
+ */
+unsigned int RadixTree::mask(int len)
+{
+	return (len == 0 ? 0 : 0xFFFFFFFFU << (RADIX_BITS - len));
+}
+
+/*
+ * Bit of an address at a position (0 is the most significant)
+ * @param key the address
+ * @param pos the bit position
+ * @return 0 or 1
+ */
+int RadixTree::bitAt(unsigned int key, int pos)
+{
+	return ((key >> (RADIX_BITS - 1 - pos)) & 1);
+}
+
+/*
+ * Length of the common prefix of two addresses
+ * @param a the first address
+ * @param b the second address
+ * @return the number of leading bits in common
+ */
+int RadixTree::commonLength(unsigned int a, unsigned int b)
+{
+	unsigned int diff = a ^ b;
+	int len = 0;
+
+	while (len < RADIX_BITS && !(diff & 0x80000000U))
+	{
+		diff <<= 1;
+		len++;
+	}
+	return (len);
+}
+
+/*
+ * Get a node, recycling a freed one when possible
+ * @param key the prefix
+ * @param len the prefix length
+ * @param value the value (-1 for a glue node)
+ * @return the node index
+ */
+int RadixTree::newNode(unsigned int key, int len, int value)
+{
+	t_radixnode node;
+	node.key = key & mask(len);
+	node.len = len;
+	node.child[0] = -1;
+	node.child[1] = -1;
+	node.value = value;
+
+	if (!this->freeNodes.empty())
+	{
+		const int index = this->freeNodes.back();
+		this->freeNodes.pop_back();
+		this->nodes[index] = node;
+		return (index);
+	}
+	this->nodes.push_back(node);
+	return (this->nodes.size() - 1);
+}
+
+/*
+ * Replace the link from parent (or the root) to a node
+ * @param parent the parent index, -1 for the root
+ * @param side the child slot of the parent
+ * @param node the new node index
+ * @return void
+ */
+void RadixTree::link(int parent, int side, int node)
+{
+	if (parent < 0)
+		this->root = node;
+	else
+		this->nodes[parent].child[side] = node;
+}
+
+/*
+ * Set the value of a prefix, replacing any previous one
+ * @param key the prefix in host byte order
+ * @param len the prefix length
+ * @param value the value to store (>= 0)
+ * @return void
+ */
+void RadixTree::insert(unsigned int key, int len, int value)
+{
+	key &= mask(len);
+
+	int parent = -1;
+	int side = 0;
+	int current = this->root;
+	while (current >= 0)
+	{
+		const t_radixnode node = this->nodes[current];
+		int common = commonLength(key, node.key);
+		if (common > len)
+			common = len;
+		if (common > node.len)
+			common = node.len;
+
+		if (common == node.len && common == len)
+		{
+			if (node.value < 0)
+				this->count++;
+			this->nodes[current].value = value;
+			return;
+		}
+		if (common == node.len)
+		{
+			// The node is a prefix of the key: go down
+			parent = current;
+			side = bitAt(key, node.len);
+			current = node.child[side];
+			continue;
+		}
+
+		const int added = newNode(key, len, value);
+		if (common == len)
+		{
+			// The key is a prefix of the node: insert above it
+			this->nodes[added].child[bitAt(node.key, len)] = current;
+			link(parent, side, added);
+		}
+		else
+		{
+			// They diverge: a glue node branches both
+			const int glue = newNode(key, common, -1);
+			this->nodes[glue].child[bitAt(node.key, common)] = current;
+			this->nodes[glue].child[bitAt(key, common)] = added;
+			link(parent, side, glue);
+		}
+		this->count++;
+		return;
+	}
+	link(parent, side, newNode(key, len, value));
+	this->count++;
+}
+
+/*
+ * Remove the value of a prefix and splice out the useless nodes
+ * @param key the prefix in host byte order
+ * @param len the prefix length
+ * @return true if the prefix was in the tree
+ */
+bool RadixTree::remove(unsigned int key, int len)
+{
+	key &= mask(len);
+
+	// Path from the root: node indexes and the side taken to reach them
+	std::vector<int> path;
+	std::vector<int> sides;
+	int side = 0;
+	int current = this->root;
+	while (current >= 0)
+	{
+		const t_radixnode &node = this->nodes[current];
+		if (node.len > len || (key & mask(node.len)) != node.key)
+			return (false);
+		path.push_back(current);
+		sides.push_back(side);
+		if (node.len == len)
+			break;
+		side = bitAt(key, node.len);
+		current = node.child[side];
+	}
+	if (current < 0 || this->nodes[current].value < 0)
+		return (false);
+
+	this->nodes[current].value = -1;
+	this->count--;
+
+	// Splice out valueless nodes with less than two children, bottom-up
+	for (size_t i = path.size(); i > 0; i--)
+	{
+		const int index = path[i - 1];
+		t_radixnode &node = this->nodes[index];
+		if (node.value >= 0 || (node.child[0] >= 0 && node.child[1] >= 0))
+			break;
+
+		const int orphan = (node.child[0] >= 0) ? node.child[0] : node.child[1];
+		link(i > 1 ? path[i - 2] : -1, sides[i - 1], orphan);
+		this->freeNodes.push_back(index);
+		if (orphan >= 0)
+			break;
+	}
+	return (true);
+}
+
+/*
+ * Find the longest prefix containing an address
+ * @param addr the address in host byte order
+ * @return the value of that prefix, -1 if none matches
+ */
+int RadixTree::lookup(unsigned int addr) const
+{
+	int found = -1;
+	int current = this->root;
+
+	while (current >= 0)
+	{
+		const t_radixnode &node = this->nodes[current];
+		if ((addr & mask(node.len)) != node.key)
+			break;
+		if (node.value >= 0)
+			found = node.value;
+		if (node.len == RADIX_BITS)
+			break;
+		current = node.child[bitAt(addr, node.len)];
+	}
+	return (found);
+}
+
+/*
+ * Find the value stored for an exact prefix
+ * @param key the prefix in host byte order
+ * @param len the prefix length
+ * @return the value, -1 if the prefix is not in the tree
+ */
+int RadixTree::find(unsigned int key, int len) const
+{
+	key &= mask(len);
+
+	int current = this->root;
+	while (current >= 0)
+	{
+		const t_radixnode &node = this->nodes[current];
+		if (node.len > len || (key & mask(node.len)) != node.key)
+			return (-1);
+		if (node.len == len)
+			return (node.value);
+		current = node.child[bitAt(key, node.len)];
+	}
+	return (-1);
+}
+
+/*
+ * Remove every prefix
+ * @return void
+ */
+void RadixTree::clear()
+{
+	this->nodes.clear();
+	this->freeNodes.clear();
+	this->root = -1;
+	this->count = 0;
+}
@@ -0,0 +1,281 @@
+/* ************************************************************************** */
+/*                                                                          */
+/*                                                        :::      ::::::::   */
+/*   ReplyBuilder.cpp                                   :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: adrien <adrien@student.42.fr>              +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/19 18:36:12 by adrien            #+#    #+#             */
+/*   Updated: 2026/10/20 11:24:39 by adrien           ###   ########.fr       */
+/*                                                                          */
+/* ************************************************************************** */
+
+/*
+** ============================================================================
+**                         PRECOMPILED NUMERIC REPLIES
+** ============================================================================
+**
+**  Every numeric the server sends has its ":<server> <code> " prefix
+**  rendered by the preprocessor in the table below; a 1000-slot index
+**  built on first use maps a code to its entry. A reply is then:
+**  - start():    prefix copied from the table, then the target nick
+**  - param():    " <value>" for each middle parameter
+**  - trailing(): " :<text>"
+**  - finish():   CRLF, the line is ready for sendToClient()
+**  size() is the length of the finished line and 0 before finish(), so a
+**  line cannot go out without its CRLF; length() measures a line being
+**  composed (room left, or a bare prefix to gather).
+**  all within one stack buffer, with no ostringstream and no std::string.
+**  A code missing from the table still works, its digits are rendered
+**  by hand.
+**
+** ============================================================================
+*/
+
+#include "../includes/ReplyBuilder.hpp"
+#include <cstring>
+
+static const t_numericprefix numericPrefixes[] = {
+	REPLY_PREFIX(RPL_WELCOME),
+	REPLY_PREFIX(RPL_YOURHOST),
+	REPLY_PREFIX(RPL_CREATED),
+	REPLY_PREFIX(RPL_MYINFO),
+	REPLY_PREFIX(RPL_ISUPPORT),
+	REPLY_PREFIX(RPL_STATSLINKINFO),
+	REPLY_PREFIX(RPL_STATSKLINE),
+	REPLY_PREFIX(RPL_ENDOFSTATS),
+	REPLY_PREFIX(RPL_UMODEIS),
+	REPLY_PREFIX(RPL_STATSDLINE),
+	REPLY_PREFIX(RPL_STATSUPTIME),
+	REPLY_PREFIX(RPL_STATSDEBUG),
+	REPLY_PREFIX(RPL_LUSERCLIENT),
+	REPLY_PREFIX(RPL_LUSEROP),
+	REPLY_PREFIX(RPL_LUSERUNKNOWN),
+	REPLY_PREFIX(RPL_LUSERCHANNELS),
+	REPLY_PREFIX(RPL_LUSERME),
+	REPLY_PREFIX(RPL_ADMINME),
+	REPLY_PREFIX(RPL_ADMINLOC1),
+	REPLY_PREFIX(RPL_ADMINLOC2),
+	REPLY_PREFIX(RPL_ADMINEMAIL),
+	REPLY_PREFIX(RPL_LOCALUSERS),
+	REPLY_PREFIX(RPL_GLOBALUSERS),
+	REPLY_PREFIX(RPL_AWAY),
+	REPLY_PREFIX(RPL_USERHOST),
+	REPLY_PREFIX(RPL_ISON),
+	REPLY_PREFIX(RPL_UNAWAY),
+	REPLY_PREFIX(RPL_NOWAWAY),
+	REPLY_PREFIX(RPL_WHOISUSER),
+	REPLY_PREFIX(RPL_WHOISSERVER),
+	REPLY_PREFIX(RPL_WHOISOPERATOR),
+	REPLY_PREFIX(RPL_WHOWASUSER),
+	REPLY_PREFIX(RPL_ENDOFWHO),
+	REPLY_PREFIX(RPL_ENDOFWHOIS),
+	REPLY_PREFIX(RPL_WHOISCHANNELS),
+	REPLY_PREFIX(RPL_LISTSTART),
+	REPLY_PREFIX(RPL_LIST),
+	REPLY_PREFIX(RPL_LISTEND),
+	REPLY_PREFIX(RPL_CHANNELMODEIS),
+	REPLY_PREFIX(RPL_NOTOPIC),
+	REPLY_PREFIX(RPL_TOPIC),
+	REPLY_PREFIX(RPL_TOPICWHOTIME),
+	REPLY_PREFIX(RPL_INVITING),
+	REPLY_PREFIX(RPL_INVITELIST),
+	REPLY_PREFIX(RPL_ENDOFINVITELIST),
+	REPLY_PREFIX(RPL_EXCEPTLIST),
+	REPLY_PREFIX(RPL_ENDOFEXCEPTLIST),
+	REPLY_PREFIX(RPL_VERSION),
+	REPLY_PREFIX(RPL_WHOREPLY),
+	REPLY_PREFIX(RPL_NAMREPLY),
+	REPLY_PREFIX(RPL_WHOSPCRPL),
+	REPLY_PREFIX(RPL_ENDOFNAMES),
+	REPLY_PREFIX(RPL_INFO),
+	REPLY_PREFIX(RPL_MOTD),
+	REPLY_PREFIX(RPL_ENDOFINFO),
+	REPLY_PREFIX(RPL_MOTDSTART),
+	REPLY_PREFIX(RPL_ENDOFMOTD),
+	REPLY_PREFIX(RPL_BANLIST),
+	REPLY_PREFIX(RPL_ENDOFBANLIST),
+	REPLY_PREFIX(RPL_ENDOFWHOWAS),
+	REPLY_PREFIX(RPL_YOUREOPER),
+	REPLY_PREFIX(RPL_REHASHING),
+	REPLY_PREFIX(RPL_TIME),
+	REPLY_PREFIX(ERR_NOSUCHNICK),
+	REPLY_PREFIX(ERR_NOSUCHSERVER),
+	REPLY_PREFIX(ERR_NOSUCHCHANNEL),
+	REPLY_PREFIX(ERR_WASNOSUCHNICK),
+	REPLY_PREFIX(ERR_TOOMANYTARGETS),
+	REPLY_PREFIX(ERR_CANNOTSENDTOCHAN),
+	REPLY_PREFIX(ERR_NOORIGIN),
+	REPLY_PREFIX(ERR_NORECIPIENT),
+	REPLY_PREFIX(ERR_NOTEXTTOSEND),
+	REPLY_PREFIX(ERR_UNKNOWNCOMMAND),
+	REPLY_PREFIX(ERR_NOMOTD),
+	REPLY_PREFIX(ERR_NONICKNAMEGIVEN),
+	REPLY_PREFIX(ERR_ERRONEUSNICKNAME),
+	REPLY_PREFIX(ERR_NICKNAMEINUSE),
+	REPLY_PREFIX(ERR_BANNICKCHANGE),
+	REPLY_PREFIX(ERR_NICKCOLLISION),
+	REPLY_PREFIX(ERR_USERNOTINCHANNEL),
+	REPLY_PREFIX(ERR_NOTONCHANNEL),
+	REPLY_PREFIX(ERR_USERONCHANNEL),
+	REPLY_PREFIX(ERR_NOTREGISTERED),
+	REPLY_PREFIX(ERR_NEEDMOREPARAMS),
+	REPLY_PREFIX(ERR_ALREADYREGISTRED),
+	REPLY_PREFIX(ERR_PASSWDMISMATCH),
+	REPLY_PREFIX(ERR_YOUREBANNEDCREEP),
+	REPLY_PREFIX(ERR_KEYSET),
+	REPLY_PREFIX(ERR_CHANNELISFULL),
+	REPLY_PREFIX(ERR_UNKNOWNMODE),
+	REPLY_PREFIX(ERR_INVITEONLYCHAN),
+	REPLY_PREFIX(ERR_BANNEDFROMCHAN),
+	REPLY_PREFIX(ERR_BADCHANNELKEY),
+	REPLY_PREFIX(ERR_BADCHANMASK),
+	REPLY_PREFIX(ERR_NOCHANMODES),
+	REPLY_PREFIX(ERR_BANLISTFULL),
+	REPLY_PREFIX(ERR_NOPRIVILEGES),
+	REPLY_PREFIX(ERR_CHANOPRIVSNEEDED),
+	REPLY_PREFIX(ERR_CANTKILLSERVER),
+	REPLY_PREFIX(ERR_NOOPERHOST),
+	REPLY_PREFIX(ERR_UMODEUNKNOWNFLAG),
+	REPLY_PREFIX(ERR_USERSDONTMATCH),
+	REPLY_PREFIX(RPL_MONONLINE),
+	REPLY_PREFIX(RPL_MONOFFLINE),
+	REPLY_PREFIX(RPL_MONLIST),
+	REPLY_PREFIX(RPL_ENDOFMONLIST),
+	REPLY_PREFIX(ERR_MONLISTFULL)
+};
+
+#define NUMERIC_PREFIX_COUNT (sizeof(numericPrefixes) / sizeof(numericPrefixes[0]))
+#define NUMERIC_MAX_CODE 1000
+
+ReplyBuilder::ReplyBuilder() : used(0), finished(false)
+{
+	this->line[0] = '\0';
+}
+
+ReplyBuilder::~ReplyBuilder()
+{
+}
+
+/*
+ * This function finds the precompiled prefix of a numeric
+ * @param code the numeric code
+ * @return the table entry, NULL if the code has none
+ */
+const t_numericprefix *ReplyBuilder::findPrefix(int code)
+{
+	static const t_numericprefix	*byCode[NUMERIC_MAX_CODE];
+	static bool						indexed = false;
+
+	if (!indexed)
+	{
+		for (size_t i = 0; i < NUMERIC_PREFIX_COUNT; i++)
+			byCode[numericPrefixes[i].code] = &numericPrefixes[i];
+		indexed = true;
+	}
+	if (code < 0 || code >= NUMERIC_MAX_CODE)
+		return (NULL);
+	return (byCode[code]);
+}
+
+/*
+ * This function starts a new reply line with its ":<server> <code> " prefix
+ * @param code the numeric code
+ * @return the builder
+ */
+ReplyBuilder &ReplyBuilder::start(int code)
+{
+	const t_numericprefix *prefix = findPrefix(code);
+
+	this->used = 0;
+	this->finished = false;
+	if (prefix)
+		append(prefix->prefix, prefix->length);
+	else
+	{
+		char digits[5];
+
+		if (code < 0 || code >= NUMERIC_MAX_CODE)
+			code = 0;
+		digits[0] = ' ';
+		digits[1] = '0' + code / 100;
+		digits[2] = '0' + code / 10 % 10;
+		digits[3] = '0' + code % 10;
+		digits[4] = ' ';
+		append(":" SERVER_NAME, sizeof(":" SERVER_NAME) - 1);
+		append(digits, sizeof(digits));
+	}
+	return (*this);
+}
+
+/*
+ * This function starts a new reply line: prefix and target nickname
+ * @param code the numeric code
+ * @param target the nickname the reply is for, "*" if empty
+ * @return the builder
+ */
+ReplyBuilder &ReplyBuilder::start(int code, const std::string &target)
+{
+	start(code);
+	if (target.empty())
+		return (append("*", 1));
+	return (append(target));
+}
+
+/*
+ * This function copies raw bytes at the end of the line, cut at 510 bytes
+ * Nothing goes after the CRLF of a finished line
+ * @param data the bytes to copy
+ * @param size how many of them
+ * @return the builder
+ */
+ReplyBuilder &ReplyBuilder::append(const char *data, size_t size)
+{
+	if (this->finished)
+		return (*this);
+	if (this->used + size > REPLY_MAX_BODY)
+		size = REPLY_MAX_BODY - this->used;
+	std::memcpy(this->line + this->used, data, size);
+	this->used += size;
+	return (*this);
+}
+
+/*
+ * This function adds a middle parameter (or several, space separated)
+ * @param value the parameter, skipped when empty
+ * @return the builder
+ */
+ReplyBuilder &ReplyBuilder::param(const std::string &value)
+{
+	if (value.empty())
+		return (*this);
+	append(" ", 1);
+	return (append(value));
+}
+
+/*
+ * This function adds the trailing parameter
+ * @param text the trailing text
+ * @return the builder
+ */
+ReplyBuilder &ReplyBuilder::trailing(const std::string &text)
+{
+	append(" :", 2);
+	return (append(text));
+}
+
+/*
+ * This function terminates the line with CRLF, once: calling it again
+ * returns the same line
+ * @return the line, size() bytes long
+ */
+const char *ReplyBuilder::finish()
+{
+	if (this->finished)
+		return (this->line);
+	std::memcpy(this->line + this->used, IRC_CRLF, 2);
+	this->used += 2;
+	this->line[this->used] = '\0';
+	this->finished = true;
+	return (this->line);
+}
@@ -6,7 +6,7 @@
 /*   By: adrien <adrien@student.42.fr>              +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/12/16 04:10:00 by hdelacou          #+#    #+#             */
-/*   Updated: 2026/01/21 00:51:49 by adrien           ###   ########.fr       */
+/*   Updated: 2026/10/20 11:45:52 by adrien           ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -19,12 +19,35 @@
 **
 **  Flow: initSocket() → initEpoll() → runServer() event loop
 **  Events: New connection → acceptUser() | Data ready → parseInput()
-**  Commands: Routed via handleLine() to specific handlers
+**  Fake lag: Each command is charged (handler time + messages caused),
+**            clients over budget keep their commands buffered until
+**            processThrottled() lets them run again
+**  Flood control: token bucket per connection, lines over the limit stay
+**                 buffered and the socket is not read meanwhile
+**  Classes: limits picked by source CIDR at accept (ConnectionClass.cpp)
+**  SendQ: unsent output is buffered per user and flushed on EPOLLOUT
+**  Channels: reached by name through channelSlots, every channel-scoped
+**            command goes straight to its channel whatever their count
+**  Fan-out: broadcasts to big channels only append to the SendQs, which
+**           are written in one pass at the end of the iteration
+**  Commands: Routed via handleLine() → dispatchCommand() to specific handlers
+**  MODE: broadcasts are held while MODE commands follow each other and
+**        flushed before any other command or at the end of the iteration
+**  Watchdog: Every dispatch and loop iteration is timed, stalls are
+**            reported to operators subscribed to server notices (+s)
 **
 ** ============================================================================
 */
 
 #include "../includes/Server.hpp"
+#include <cerrno>
+#include <climits>
+#include <sstream>
+#include <strings.h>
+
+#ifndef IOV_MAX
+# define IOV_MAX 1024
+#endif
 
 bool Server::running = true;
 
@@ -39,6 +62,32 @@ bool Server::running = true;
 Server::Server() : port(0), socketfd(-1), password(""), epollFd(-1)
 {
 	Users = std::map<int, User>();
+	lusers.unknown = 0;
+	lusers.registered = 0;
+	lusers.invisible = 0;
+	lusers.opers = 0;
+	lusers.channels = 0;
+	lusers.localMax = 0;
+	lusers.globalMax = 0;
+	startTime = time(NULL);
+	lastDecay = startTime;
+	lastConnId = 0;
+	penalty.cpuFactor = PENALTY_CPU_FACTOR;
+	penalty.sendUsec = PENALTY_SEND_USEC;
+	penalty.lookupUsec = PENALTY_LOOKUP_USEC;
+	penalty.thresholdUsec = PENALTY_THRESHOLD_MS * 1000L;
+	penalty.disconnectUsec = PENALTY_DISCONNECT_MS * 1000L;
+	dispatchSends = 0;
+	dispatchLookups = 0;
+	broadcastEpoch = 0;
+	fanoutBatchMembers = FANOUT_BATCH_MEMBERS;
+	lastPingCheck = startTime;
+	lastPurge = startTime;
+	connectHalflife = CONNECT_HALFLIFE;
+	lockout.maxFailures = AUTH_MAX_FAILURES;
+	lockout.backoffMs = AUTH_BACKOFF_MS;
+	lockout.backoffMaxMs = AUTH_BACKOFF_MAX_MS;
+	lockout.forget = AUTH_FORGET;
 }
 
 /*
@@ -64,8 +113,57 @@ Server Server::operator=(const Server &src)
 		this->socketfd = src.socketfd;
 		this->password = src.password;
 		this->channelList = src.channelList;
+		this->channelSlots.clear();
+		for (std::list<Channel>::iterator it = this->channelList.begin(); it != this->channelList.end(); ++it)
+			this->channelSlots[it->getName()] = it;
 		this->epollFd = src.epollFd;
 		this->Users = src.Users;
+		this->config = src.config;
+		this->watchdog = src.watchdog;
+		this->lusers = src.lusers;
+		this->startTime = src.startTime;
+		this->clientBytes = src.clientBytes;
+		this->clientLines = src.clientLines;
+		this->ipBytes = src.ipBytes;
+		this->ipLines = src.ipLines;
+		this->channelFanout = src.channelFanout;
+		this->lastDecay = src.lastDecay;
+		this->lastConnId = src.lastConnId;
+		this->connFds = src.connFds;
+		this->penalty = src.penalty;
+		this->dispatchSends = src.dispatchSends;
+		this->dispatchLookups = src.dispatchLookups;
+		this->broadcastEpoch = src.broadcastEpoch;
+		this->recipientEpochs = src.recipientEpochs;
+		this->fanoutBatchMembers = src.fanoutBatchMembers;
+		this->pendingOutput = src.pendingOutput;
+		this->throttled = src.throttled;
+		this->classes = src.classes;
+		this->classTrie = src.classTrie;
+		this->ipTable = src.ipTable;
+		this->connectHalflife = src.connectHalflife;
+		this->lastPurge = src.lastPurge;
+		this->lastPingCheck = src.lastPingCheck;
+		this->pendingDisconnect = src.pendingDisconnect;
+		this->lockout = src.lockout;
+		this->accountFailures = src.accountFailures;
+		this->nickIndex = src.nickIndex;
+		this->lookupKey = src.lookupKey;
+		this->lookupReply = src.lookupReply;
+		this->cloakKey = src.cloakKey;
+		this->modeBatches = src.modeBatches;
+		this->welcomeReply = src.welcomeReply;
+		this->motdReply = src.motdReply;
+		this->versionReply = src.versionReply;
+		this->infoReply = src.infoReply;
+		this->adminReply = src.adminReply;
+		this->replyIov = src.replyIov;
+		this->listIndex = src.listIndex;
+		this->listCursors = src.listCursors;
+		this->userIndex = src.userIndex;
+		this->whoCursors = src.whoCursors;
+		this->monitors = src.monitors;
+		this->whowas = src.whowas;
 	}
 	return *this;
 }
@@ -181,12 +279,52 @@ void Server::initServer(const int &port, const std::string &password)
 	this->port = port;
 	this->password = password;
 
+	loadConfig();
+	if (!loadBans())
+		std::cout << "[IRC] " << bansPath << " not found, no bans" << std::endl;
 	initSocket();
 	initEpoll();
 
 	std::cout << "[IRC] Server initialized successfully" << std::endl;
 }
 
+/*
+ * Load the configuration file and apply its settings
+ * Every directive is optional: a missing file keeps the defaults
+ * (or the previous settings on REHASH)
+ * @return false if the file could not be read
+ */
+bool Server::loadConfig()
+{
+	const bool found = config.load(CONFIG_FILE);
+	if (!found)
+		std::cout << "[IRC] " << CONFIG_FILE << " not found, using defaults" << std::endl;
+
+	watchdog.configure(config.getLong("watchdog_command_ms", WATCHDOG_COMMAND_THRESHOLD_MS),
+	                   config.getLong("watchdog_loop_ms", WATCHDOG_LOOP_THRESHOLD_MS),
+	                   config.getLong("watchdog_top_size", WATCHDOG_TOP_SIZE));
+
+	penalty.cpuFactor = config.getLong("penalty_cpu_factor", PENALTY_CPU_FACTOR);
+	penalty.sendUsec = config.getLong("penalty_send_usec", PENALTY_SEND_USEC);
+	penalty.lookupUsec = config.getLong("penalty_lookup_usec", PENALTY_LOOKUP_USEC);
+	penalty.thresholdUsec = config.getLong("penalty_threshold_ms", PENALTY_THRESHOLD_MS) * 1000L;
+	penalty.disconnectUsec = config.getLong("penalty_disconnect_ms", PENALTY_DISCONNECT_MS) * 1000L;
+
+	lockout.maxFailures = config.getLong("auth_max_failures", AUTH_MAX_FAILURES);
+	lockout.backoffMs = config.getLong("auth_backoff_ms", AUTH_BACKOFF_MS);
+	lockout.backoffMaxMs = config.getLong("auth_backoff_max_ms", AUTH_BACKOFF_MAX_MS);
+	lockout.forget = config.getLong("auth_forget", AUTH_FORGET);
+	cloakKey = config.get("cloak_key", "");
+	const long whowasSize = config.getLong("whowas_size", WHOWAS_SIZE);
+	whowas.resize(whowasSize > 0 ? whowasSize : 0);
+	const long batchMembers = config.getLong("fanout_batch_members", FANOUT_BATCH_MEMBERS);
+	fanoutBatchMembers = batchMembers > 0 ? batchMembers : 0;
+
+	loadClasses();
+	renderStaticReplies();
+	return (found);
+}
+
 /*
  * Run server main loop
  * @return void
@@ -195,9 +333,15 @@ void Server::runServer()
 {
 	std::cout << "[IRC] Server running. Press Ctrl+C to stop." << std::endl;
 
+	bool streaming = false;
 	while (running)
 	{
-		int numEvents = epoll_wait(epollFd, events, MAX_EVENTS, 1000);
+		// Wake up early while some clients have commands held back, and
+		// right away while a LIST or a WHO can go on
+		int timeout = throttled.empty() ? 1000 : THROTTLE_POLL_MS;
+		if (streaming)
+			timeout = 0;
+		int numEvents = epoll_wait(epollFd, events, MAX_EVENTS, timeout);
 
 		if (numEvents < 0)
 		{
@@ -209,6 +353,7 @@ void Server::runServer()
 			break;
 		}
 
+		watchdog.beginLoop();
 		for (int i = 0; i < numEvents; i++)
 		{
 			if (events[i].data.fd == socketfd)
@@ -217,14 +362,155 @@ void Server::runServer()
 			}
 			else
 			{
-				parseInput(events[i].data.fd);
+				if (events[i].events & EPOLLOUT)
+					flushSendQueue(events[i].data.fd);
+				if (events[i].events & (EPOLLIN | EPOLLHUP | EPOLLERR))
+					parseInput(events[i].data.fd);
 			}
 		}
+
+		processThrottled();
+		flushModeBatches();
+		streaming = continueListings();
+		if (continueWhos())
+			streaming = true;
+		flushPendingOutput();
+		reapClients();
+		checkTimers();
+
+		t_stall stall;
+		if (watchdog.endLoop(stall))
+			reportStall("loop", stall);
 	}
 
 	std::cout << "[IRC] Server stopped" << std::endl;
 }
 
+/*
+ * Run the periodic housekeeping tasks, called once per loop iteration
+ * @return void
+ */
+void Server::checkTimers()
+{
+	const time_t now = time(NULL);
+
+	if (now - lastDecay >= HH_DECAY_INTERVAL)
+	{
+		clientBytes.decay();
+		clientLines.decay();
+		ipBytes.decay();
+		ipLines.decay();
+		channelFanout.decay();
+		lastDecay = now;
+	}
+
+	if (now - lastPurge >= IPTABLE_PURGE_INTERVAL)
+	{
+		ipTable.purge(now, connectHalflife, lockout.forget);
+		purgeAccountFailures(now);
+		lastPurge = now;
+	}
+
+	if (now != lastPingCheck)
+	{
+		expireBans(now);
+		checkPings(now);
+		lastPingCheck = now;
+	}
+}
+
+/*
+ * Count the recipients of a channel broadcast for the heavy hitters
+ * @param channelName the channel the message was sent to
+ * @param recipients the number of members it was delivered to
+ * @return void
+ */
+void Server::countChannelFanout(const std::string &channelName, size_t recipients)
+{
+	channelFanout.add(channelName, recipients);
+}
+
+/*
+ * Send a JOIN, PART or KICK about a member to the channel
+ * The member always gets it, the others only if they can see it (+u)
+ * @param chan the channel
+ * @param fd the member joining or leaving
+ * @param message the line to send
+ * @return void
+ */
+void Server::broadcastMembership(const Channel &chan, int fd, const std::string &message)
+{
+	const std::set<int> &audience = chan.getAudience(fd);
+	const bool batched = batchFanout(audience.size());
+	size_t sent = 0;
+
+	for (std::set<int>::const_iterator it = audience.begin(); it != audience.end(); ++it, ++sent) {
+		if (batched)
+			queueToClient(*it, message);
+		else
+			sendToClient(*it, message);
+	}
+	if (!audience.count(fd)) {
+		sendToClient(fd, message);
+		sent++;
+	}
+	countChannelFanout(chan.getName(), sent);
+}
+
+/*
+ * Find a channel by name
+ * @param name the channel name
+ * @return the channel, channelList.end() if there is none
+ */
+std::list<Channel>::iterator Server::findChannel(const std::string &name)
+{
+	std::map<std::string, std::list<Channel>::iterator>::const_iterator slot = channelSlots.find(name);
+	if (slot == channelSlots.end())
+		return (channelList.end());
+	return (slot->second);
+}
+
+/*
+ * Find a channel by name
+ * @param name the channel name
+ * @return the channel, channelList.end() if there is none
+ */
+std::list<Channel>::const_iterator Server::findChannel(const std::string &name) const
+{
+	std::map<std::string, std::list<Channel>::iterator>::const_iterator slot = channelSlots.find(name);
+	if (slot == channelSlots.end())
+		return (channelList.end());
+	return (slot->second);
+}
+
+/*
+ * Register a new channel: channel list, name slot, LIST index and LUSERS
+ * The other channels stay where they are
+ * @param channel the channel, with its creator
+ * @return the stored channel
+ */
+Channel &Server::addChannel(const Channel &channel)
+{
+	channelList.push_back(channel);
+	channelSlots[channel.getName()] = --channelList.end();
+	listIndex.update(channelList.back());
+	lusers.channels++;
+	return (channelList.back());
+}
+
+/*
+ * Drop a channel that became empty, nothing else is moved or renumbered
+ * @param channel the channel
+ * @return the channel after it, for the loops going on
+ */
+std::list<Channel>::iterator Server::eraseChannel(std::list<Channel>::iterator channel)
+{
+	listIndex.remove(channel->getName());
+	channelSlots.erase(channel->getName());
+	lusers.channels--;
+	return (channelList.erase(channel));
+}
+
 /*
  * Accept new user connection
  * @return void
@@ -248,21 +534,24 @@ void Server::acceptUser()
 		return;
 	}
 
+	char ipStr[INET_ADDRSTRLEN];
+	inet_ntop(AF_INET, &clientAddr.sin_addr, ipStr, INET_ADDRSTRLEN);
+
+	if (!admitConnection(clientFd, ntohl(clientAddr.sin_addr.s_addr), ipStr))
+		return;
+
 	event.events = EPOLLIN | EPOLLET;
 	event.data.fd = clientFd;
 
 	if (epoll_ctl(epollFd, EPOLL_CTL_ADD, clientFd, &event) < 0)
 	{
 		std::cerr << "[IRC] Failed to add client to epoll" << std::endl;
+		releaseConnection(Users[clientFd]);
+		Users.erase(clientFd);
 		close(clientFd);
 		return;
 	}
-
-	User newUser;
-	Users[clientFd] = newUser;
-
-	char ipStr[INET_ADDRSTRLEN];
-	inet_ntop(AF_INET, &clientAddr.sin_addr, ipStr, INET_ADDRSTRLEN);
+	lusers.unknown++;
 
 	std::cout << "[IRC] New connection from " << ipStr
 			  << ":" << ntohs(clientAddr.sin_port)
@@ -271,54 +560,471 @@ void Server::acceptUser()
 
 /*
  * Parse input from user
- * Accumulates partial data in per-user buffer until complete command (\r\n)
+ * Drains the socket (edge-triggered epoll) into the per-user buffer and
+ * processes the complete commands. Reading stops while the user is
+ * throttled so the kernel buffers fill up and TCP pushes back
  * @param userFd the user file descriptor
  * @return void
  */
 void Server::parseInput(int userFd)
 {
+	std::map<int, User>::iterator it = Users.find(userFd);
+	if (it == Users.end())
+		return;
+
+	const std::string &connId = it->second.getConnId();
+	const std::string &ip = it->second.getIp();
 	char buffer[1024];
-	int bytesRead = recv(userFd, buffer, sizeof(buffer) - 1, 0);
 
-	if (bytesRead <= 0)
+	while (throttled.find(userFd) == throttled.end())
 	{
+		int bytesRead = recv(userFd, buffer, sizeof(buffer) - 1, 0);
+
 		if (bytesRead == 0)
 		{
 			std::cout << "[IRC] Client disconnected (fd: " << userFd << ")" << std::endl;
+			disconnectUser(userFd, "Connection closed");
+			return;
 		}
-		else
+		if (bytesRead < 0)
+			break; // EAGAIN/EWOULDBLOCK - socket drained
+
+		clientBytes.add(connId, bytesRead);
+		ipBytes.add(ip, bytesRead);
+
+		// Accumulate data in per-user buffer for partial command handling
+		it->second.addToBuffer(std::string(buffer, bytesRead));
+
+		processInput(userFd);
+		if (Users.find(userFd) == Users.end())
+			return;
+
+		// Whatever is left is below the next line: it must stay small
+		if (it->second.getBuffer().size() > getClass(it->second).recvq)
 		{
-			return; // EAGAIN/EWOULDBLOCK - no data available yet
+			disconnectUser(userFd, "Excess Flood");
+			return;
 		}
-
-		epoll_ctl(epollFd, EPOLL_CTL_DEL, userFd, NULL);
-		close(userFd);
-		Users.erase(userFd);
-		return;
 	}
+}
 
-	buffer[bytesRead] = '\0';
-
-	// Accumulate data in per-user buffer for partial command handling
-	Users[userFd].addToBuffer(std::string(buffer));
+/*
+ * Process the complete commands (ending with \r\n) of a user buffer
+ * Stops while the user is throttled (fake lag or empty flood bucket):
+ * the rest stays buffered and is picked up again by processThrottled()
+ * @param userFd the user file descriptor
+ * @return void
+ */
+void Server::processInput(int userFd)
+{
+	std::map<int, User>::iterator it = Users.find(userFd);
+	if (it == Users.end())
+		return;
 
-	// Process only complete commands (ending with \r\n)
-	std::string &userBuffer = Users[userFd].getBufferRef();
+	const std::string &connId = it->second.getConnId();
+	const std::string &ip = it->second.getIp();
+	std::string &userBuffer = it->second.getBufferRef();
 	size_t pos;
 	while ((pos = userBuffer.find("\r\n")) != std::string::npos)
 	{
+		if (pendingDisconnect.count(userFd))
+			return;
+		// Looked up per line: a REHASH run by a command rebuilds the classes
+		const t_connclass &cls = getClass(it->second);
+		if (isThrottled(it->second)
+			|| !it->second.takeToken(getTimeUsec(), cls.floodBurst, cls.floodRate))
+		{
+			throttled.insert(userFd);
+			return;
+		}
+
 		std::string command = userBuffer.substr(0, pos);
 		userBuffer.erase(0, pos + 2);
+		it->second.setActivity(time(NULL));
 
 		if (!command.empty())
 		{
+			clientLines.add(connId, 1);
+			ipLines.add(ip, 1);
 			handleLine(userFd, command + "\r\n");
+			if (Users.find(userFd) == Users.end())
+				return;
+		}
+	}
+	throttled.erase(userFd);
+}
+
+/*
+ * Resume the throttled users: run their buffered commands, then go back
+ * to reading their socket once the buffer is drained (edge-triggered
+ * epoll will not report the data left in the kernel again)
+ * @return void
+ */
+void Server::processThrottled()
+{
+	const std::vector<int> fds(throttled.begin(), throttled.end());
+
+	for (size_t i = 0; i < fds.size(); i++)
+	{
+		std::map<int, User>::iterator it = Users.find(fds[i]);
+		if (it == Users.end())
+			throttled.erase(fds[i]);
+		else if (!isThrottled(it->second))
+		{
+			processInput(fds[i]);
+			if (throttled.find(fds[i]) == throttled.end())
+				parseInput(fds[i]);
 		}
 	}
 }
 
+/*
+ * Check if a user has too much fake lag to run another command
+ * or is serving a failed authentication backoff
+ * @param user the user to check
+ * @return true if the user's commands must be held back
+ */
+bool Server::isThrottled(const User &user) const
+{
+	const long now = getTimeUsec();
+	return (user.getHoldUntil() > now
+	        || user.getLag(now) > penalty.thresholdUsec * getClass(user).budget);
+}
+
+/*
+ * Charge a client for the command it just ran
+ * Cost = handler time * cpu factor + messages caused * per-send cost
+ * + nicks looked up * per-lookup cost
+ * Clients piling up more lag than the disconnect limit are dropped
+ * @param clientFd the client file descriptor
+ * @param usec the time spent in the handler
+ * @return void
+ */
+void Server::chargeCommand(const int &clientFd, long usec)
+{
+	std::map<int, User>::iterator it = Users.find(clientFd);
+	if (it == Users.end())
+		return;
+
+	const long now = getTimeUsec();
+	const long cost = usec * penalty.cpuFactor + (long)dispatchSends * penalty.sendUsec
+	                  + (long)dispatchLookups * penalty.lookupUsec;
+	it->second.charge(now, usec, dispatchSends, cost);
+
+	if (it->second.getLag(now) > penalty.disconnectUsec * getClass(it->second).budget)
+	{
+		std::cerr << "[IRC] Disconnecting fd " << clientFd << ": excess CPU usage" << std::endl;
+		sendError(clientFd, "Closing Link: Excess CPU usage");
+		disconnectUser(clientFd, "Excess CPU usage");
+	}
+}
+
+/*
+ * Start a broadcast whose recipients must be reached once
+ * Every stamp left by the previous ones becomes stale, nothing is cleared
+ * @return void
+ */
+void Server::beginBroadcast()
+{
+	this->broadcastEpoch++;
+}
+
+/*
+ * Check whether a client was already reached by the current broadcast,
+ * and stamp it if not
+ * @param fd the recipient file descriptor
+ * @return true the first time the client is reached by this broadcast
+ */
+bool Server::firstDelivery(int fd)
+{
+	if (fd < 0)
+		return (false);
+	if ((size_t)fd >= this->recipientEpochs.size())
+		this->recipientEpochs.resize(fd + 1, 0);
+	if (this->recipientEpochs[fd] == this->broadcastEpoch)
+		return (false);
+	this->recipientEpochs[fd] = this->broadcastEpoch;
+	return (true);
+}
+
+/*
+ * Send a message to a client
+ * Every outgoing message goes through here so the dispatching client
+ * can be charged for the fan-out it causes. What the socket does not
+ * take right away waits in the user SendQ until EPOLLOUT, a client whose
+ * SendQ grows past its class limit is dropped
+ * @param clientFd the recipient file descriptor
+ * @param message the full IRC line (with CRLF)
+ * @return void
+ */
+void Server::sendToClient(const int &clientFd, const std::string &message)
+{
+	sendToClient(clientFd, message.data(), message.length());
+}
+
+/*
+ * Send raw bytes to a client, queueing what the socket does not take
+ * @param clientFd the client file descriptor
+ * @param data the bytes to send
+ * @param length how many of them
+ * @return void
+ */
+void Server::sendToClient(const int &clientFd, const char *data, size_t length)
+{
+	dispatchSends++;
+
+	std::map<int, User>::iterator it = Users.find(clientFd);
+	if (it == Users.end() || pendingDisconnect.count(clientFd))
+		return;
+
+	std::string &queue = it->second.getSendQueueRef();
+	if (!queue.empty())
+		queue.append(data, length);
+	else
+	{
+		ssize_t sent = send(clientFd, data, length, MSG_NOSIGNAL);
+		if (sent == (ssize_t)length)
+			return;
+		if (sent < 0)
+		{
+			if (errno != EAGAIN && errno != EWOULDBLOCK)
+			{
+				scheduleDisconnect(clientFd, "Write error");
+				return;
+			}
+			sent = 0;
+		}
+		queue.append(data + sent, length - sent);
+		watchOutput(clientFd, true);
+	}
+
+	if (queue.size() > getClass(it->second).sendq)
+		scheduleDisconnect(clientFd, "SendQ exceeded");
+}
+
+/*
+ * Send a gathered message to a client with writev(), queueing what the
+ * socket does not take
+ * @param clientFd the client file descriptor
+ * @param iov the slices to send, in order
+ * @param count how many slices
+ * @return void
+ */
+void Server::sendToClient(const int &clientFd, const struct iovec *iov, size_t count)
+{
+	dispatchSends++;
+
+	std::map<int, User>::iterator it = Users.find(clientFd);
+	if (it == Users.end() || pendingDisconnect.count(clientFd))
+		return;
+
+	std::string &queue = it->second.getSendQueueRef();
+	size_t i = 0;
+	if (queue.empty())
+	{
+		while (i < count)
+		{
+			const size_t chunk = std::min(count - i, (size_t)IOV_MAX);
+			size_t total = 0;
+			for (size_t j = i; j < i + chunk; j++)
+				total += iov[j].iov_len;
+
+			ssize_t sent = writev(clientFd, iov + i, chunk);
+			if (sent < 0)
+			{
+				if (errno != EAGAIN && errno != EWOULDBLOCK)
+				{
+					scheduleDisconnect(clientFd, "Write error");
+					return;
+				}
+				sent = 0;
+			}
+			if ((size_t)sent == total)
+			{
+				i += chunk;
+				continue;
+			}
+			// Queue the unsent end of the slice the socket stopped in
+			while ((size_t)sent >= iov[i].iov_len)
+				sent -= iov[i++].iov_len;
+			queue.append(static_cast<const char *>(iov[i].iov_base) + sent, iov[i].iov_len - sent);
+			i++;
+			break;
+		}
+		if (queue.empty() && i == count)
+			return;
+		watchOutput(clientFd, true);
+	}
+	for (; i < count; i++)
+		queue.append(static_cast<const char *>(iov[i].iov_base), iov[i].iov_len);
+
+	if (queue.size() > getClass(it->second).sendq)
+		scheduleDisconnect(clientFd, "SendQ exceeded");
+}
+
+/*
+ * Terminate a numeric reply and send it to a client
+ * @param clientFd the client file descriptor
+ * @param reply the reply, finished here
+ * @return void
+ */
+void Server::sendToClient(const int &clientFd, ReplyBuilder &reply)
+{
+	const char *line = reply.finish();
+	sendToClient(clientFd, line, reply.size());
+}
+
+/*
+ * Queue a message for a client without writing it yet
+ * Used for the members of a big channel: the socket is written once for
+ * everything queued during the loop iteration, by flushPendingOutput().
+ * A client whose SendQ was not empty is already waiting for EPOLLOUT
+ * @param clientFd the recipient file descriptor
+ * @param message the full IRC line (with CRLF)
+ * @return void
+ */
+void Server::queueToClient(const int &clientFd, const std::string &message)
+{
+	dispatchSends++;
+
+	std::map<int, User>::iterator it = Users.find(clientFd);
+	if (it == Users.end() || pendingDisconnect.count(clientFd))
+		return;
+
+	std::string &queue = it->second.getSendQueueRef();
+	if (queue.empty())
+		pendingOutput.push_back(clientFd);
+	queue.append(message);
+
+	if (queue.size() > getClass(it->second).sendq)
+		scheduleDisconnect(clientFd, "SendQ exceeded");
+}
+
+/*
+ * Check whether a channel broadcast goes through queueToClient()
+ * @param members the number of recipients
+ * @return true from fanout_batch_members recipients (0 never batches)
+ */
+bool Server::batchFanout(size_t members) const
+{
+	return (this->fanoutBatchMembers && members >= this->fanoutBatchMembers);
+}
+
+/*
+ * Write the SendQs filled by queueToClient() during the loop iteration
+ * One send() per client whatever the number of broadcasts it got, what
+ * the socket does not take waits for EPOLLOUT as usual
+ * @return void
+ */
+void Server::flushPendingOutput()
+{
+	for (size_t i = 0; i < pendingOutput.size(); i++)
+	{
+		const int clientFd = pendingOutput[i];
+		std::map<int, User>::iterator it = Users.find(clientFd);
+		if (it == Users.end() || pendingDisconnect.count(clientFd))
+			continue;
+
+		std::string &queue = it->second.getSendQueueRef();
+		if (queue.empty())
+			continue;
+		ssize_t sent = send(clientFd, queue.data(), queue.length(), MSG_NOSIGNAL);
+		if (sent < 0)
+		{
+			if (errno != EAGAIN && errno != EWOULDBLOCK)
+			{
+				scheduleDisconnect(clientFd, "Write error");
+				continue;
+			}
+			sent = 0;
+		}
+		queue.erase(0, sent);
+		if (!queue.empty())
+			watchOutput(clientFd, true);
+	}
+	pendingOutput.clear();
+}
+
+/*
+ * Write as much of the SendQ as the socket accepts
+ * @param clientFd the client file descriptor
+ * @return void
+ */
+void Server::flushSendQueue(const int &clientFd)
+{
+	std::map<int, User>::iterator it = Users.find(clientFd);
+	if (it == Users.end())
+		return;
+
+	std::string &queue = it->second.getSendQueueRef();
+	while (!queue.empty())
+	{
+		const ssize_t sent = send(clientFd, queue.c_str(), queue.length(), MSG_NOSIGNAL);
+		if (sent < 0)
+		{
+			if (errno != EAGAIN && errno != EWOULDBLOCK)
+				scheduleDisconnect(clientFd, "Write error");
+			return;
+		}
+		queue.erase(0, sent);
+	}
+	watchOutput(clientFd, false);
+}
+
+/*
+ * Enable or disable EPOLLOUT notifications for a client
+ * @param clientFd the client file descriptor
+ * @param enable true while the SendQ is not empty
+ * @return void
+ */
+void Server::watchOutput(const int &clientFd, bool enable)
+{
+	epoll_event ev;
+
+	ev.events = EPOLLIN | EPOLLET;
+	if (enable)
+		ev.events |= EPOLLOUT;
+	ev.data.fd = clientFd;
+	epoll_ctl(epollFd, EPOLL_CTL_MOD, clientFd, &ev);
+}
+
+/*
+ * Mark a client to be disconnected at the end of the loop iteration
+ * Used where removing the user right away would break the caller
+ * (a channel broadcast iterating over its members, for example)
+ * @param clientFd the client file descriptor
+ * @param reason the quit reason
+ * @return void
+ */
+void Server::scheduleDisconnect(const int &clientFd, const std::string &reason)
+{
+	if (pendingDisconnect.find(clientFd) == pendingDisconnect.end())
+		pendingDisconnect[clientFd] = reason;
+}
+
+/*
+ * Disconnect the clients marked by scheduleDisconnect()
+ * Their QUIT broadcasts may mark other clients, hence the loop
+ * @return void
+ */
+void Server::reapClients()
+{
+	while (!pendingDisconnect.empty())
+	{
+		const int clientFd = pendingDisconnect.begin()->first;
+		const std::string reason = pendingDisconnect.begin()->second;
+
+		pendingDisconnect.erase(pendingDisconnect.begin());
+		std::cout << "[IRC] Dropping fd " << clientFd << ": " << reason << std::endl;
+		if (Users.find(clientFd) != Users.end())
+			sendError(clientFd, "Closing Link: " + Users[clientFd].getIp() + " (" + reason + ")");
+		disconnectUser(clientFd, reason);
+	}
+}
+
 /*
  * Handle incoming line from user
+ * Each command dispatch is timed and reported to the stall watchdog
  * @param clientFd the client file descriptor
  * @param line the line to parse
  * @return void
@@ -354,136 +1060,395 @@ void Server::handleLine(const int &clientFd, const std::string &line)
 			cmdName[i] = toupper(cmdName[i]);
 		}
 
-		if (cmdName == "CAP")
+		// Held MODE broadcasts go out before anything else can happen
+		if (cmdName != "MODE" && !modeBatches.empty())
+			flushModeBatches();
+
+		dispatchSends = 0;
+		dispatchLookups = 0;
+		const long start = getTimeUsec();
+		dispatchCommand(clientFd, cmdName, command);
+		const long elapsed = getTimeUsec() - start;
+
+		t_stall stall;
+		if (watchdog.recordCommand(clientFd, cmdName, getTargetChannel(command), elapsed, stall))
+			reportStall("command", stall);
+		chargeCommand(clientFd, elapsed);
+
+		if (Users.find(clientFd) == Users.end())
+			return;
+	}
+}
+
+/*
+ * Route one command to its handler
+ * @param clientFd the client file descriptor
+ * @param cmdName the uppercased command name
+ * @param command the full command line (without CRLF)
+ * @return void
+ */
+void Server::dispatchCommand(const int &clientFd, const std::string &cmdName, const std::string &command)
+{
+	if (cmdName == "CAP")
+	{
+		handleCap(clientFd, command);
+	}
+	else if (cmdName == "PASS")
+	{
+		handlePass(clientFd, command);
+	}
+	else if (cmdName == "NICK")
+	{
+		handleNick(clientFd, command);
+	}
+	else if (cmdName == "USER")
+	{
+		handleUsername(clientFd, command);
+	}
+	else if (cmdName == "PING")
+	{
+		handlePing(clientFd, command);
+	}
+	else if (cmdName == "PONG")
+	{
+		handlePong(clientFd, command);
+	}
+	else if (cmdName == "JOIN")
+	{
+		if (!Users[clientFd].getIsRegister())
 		{
-			handleCap(clientFd, command);
+			sendERR_NOTREGISTERED(clientFd);
+			return;
 		}
-		else if (cmdName == "PASS")
+		handleJoin(clientFd, command);
+	}
+	else if (cmdName == "PART")
+	{
+		if (!Users[clientFd].getIsRegister())
 		{
-			handlePass(clientFd, command);
+			sendERR_NOTREGISTERED(clientFd);
+			return;
 		}
-		else if (cmdName == "NICK")
+		handlePart(clientFd, command);
+	}
+	else if (cmdName == "PRIVMSG")
+	{
+		if (!Users[clientFd].getIsRegister())
 		{
-			handleNick(clientFd, command);
+			sendERR_NOTREGISTERED(clientFd);
+			return;
 		}
-		else if (cmdName == "USER")
+		handlePrivateMessage(clientFd, command);
+	}
+	else if (cmdName == "NOTICE")
+	{
+		if (!Users[clientFd].getIsRegister())
 		{
-			handleUsername(clientFd, command);
+			sendERR_NOTREGISTERED(clientFd);
+			return;
 		}
-		else if (cmdName == "PING")
+		handleNotice(clientFd, command);
+	}
+	else if (cmdName == "TOPIC")
+	{
+		if (!Users[clientFd].getIsRegister())
 		{
-			handlePing(clientFd, command);
+			sendERR_NOTREGISTERED(clientFd);
+			return;
 		}
-		else if (cmdName == "PONG")
+		handleTopic(clientFd, command);
+	}
+	else if (cmdName == "KICK")
+	{
+		if (!Users[clientFd].getIsRegister())
 		{
-			handlePong(clientFd, command);
+			sendERR_NOTREGISTERED(clientFd);
+			return;
 		}
-		else if (cmdName == "JOIN")
+		handleKick(clientFd, command);
+	}
+	else if (cmdName == "INVITE")
+	{
+		if (!Users[clientFd].getIsRegister())
 		{
-			if (!Users[clientFd].getIsRegister())
-			{
-				sendERR_NOTREGISTERED(clientFd);
-				continue;
-			}
-			handleJoin(clientFd, command);
+			sendERR_NOTREGISTERED(clientFd);
+			return;
 		}
-		else if (cmdName == "PART")
+		handleInvite(clientFd, command);
+	}
+	else if (cmdName == "MODE")
+	{
+		if (!Users[clientFd].getIsRegister())
 		{
-			if (!Users[clientFd].getIsRegister())
-			{
-				sendERR_NOTREGISTERED(clientFd);
-				continue;
-			}
-			handlePart(clientFd, command);
+			sendERR_NOTREGISTERED(clientFd);
+			return;
 		}
-		else if (cmdName == "PRIVMSG")
+		handleMode(clientFd, command);
+	}
+	else if (cmdName == "OPER")
+	{
+		if (!Users[clientFd].getIsRegister())
 		{
-			if (!Users[clientFd].getIsRegister())
-			{
-				sendERR_NOTREGISTERED(clientFd);
-				continue;
-			}
-			handlePrivateMessage(clientFd, command);
+			sendERR_NOTREGISTERED(clientFd);
+			return;
 		}
-		else if (cmdName == "NOTICE")
+		handleOper(clientFd, command);
+	}
+	else if (cmdName == "KILL")
+	{
+		if (!Users[clientFd].getIsRegister())
 		{
-			if (!Users[clientFd].getIsRegister())
-			{
-				sendERR_NOTREGISTERED(clientFd);
-				continue;
-			}
-			handleNotice(clientFd, command);
+			sendERR_NOTREGISTERED(clientFd);
+			return;
 		}
-		else if (cmdName == "TOPIC")
+		handleKill(clientFd, command);
+	}
+	else if (cmdName == "REHASH")
+	{
+		if (!Users[clientFd].getIsRegister())
 		{
-			if (!Users[clientFd].getIsRegister())
-			{
-				sendERR_NOTREGISTERED(clientFd);
-				continue;
-			}
-			handleTopic(clientFd, command);
+			sendERR_NOTREGISTERED(clientFd);
+			return;
 		}
-		else if (cmdName == "KICK")
+		handleRehash(clientFd, command);
+	}
+	else if (cmdName == "KLINE")
+	{
+		if (!Users[clientFd].getIsRegister())
 		{
-			if (!Users[clientFd].getIsRegister())
-			{
-				sendERR_NOTREGISTERED(clientFd);
-				continue;
-			}
-			handleKick(clientFd, command);
+			sendERR_NOTREGISTERED(clientFd);
+			return;
 		}
-		else if (cmdName == "INVITE")
+		handleKline(clientFd, command);
+	}
+	else if (cmdName == "UNKLINE")
+	{
+		if (!Users[clientFd].getIsRegister())
 		{
-			if (!Users[clientFd].getIsRegister())
-			{
-				sendERR_NOTREGISTERED(clientFd);
-				continue;
-			}
-			handleInvite(clientFd, command);
+			sendERR_NOTREGISTERED(clientFd);
+			return;
 		}
-		else if (cmdName == "MODE")
+		handleUnkline(clientFd, command);
+	}
+	else if (cmdName == "DLINE")
+	{
+		if (!Users[clientFd].getIsRegister())
 		{
-			if (!Users[clientFd].getIsRegister())
-			{
-				sendERR_NOTREGISTERED(clientFd);
-				continue;
-			}
-			handleMode(clientFd, command);
+			sendERR_NOTREGISTERED(clientFd);
+			return;
 		}
-		else if (cmdName == "WHO")
+		handleDline(clientFd, command);
+	}
+	else if (cmdName == "UNDLINE")
+	{
+		if (!Users[clientFd].getIsRegister())
 		{
-			if (!Users[clientFd].getIsRegister())
-			{
-				sendERR_NOTREGISTERED(clientFd);
-				continue;
-			}
-			handleWho(clientFd, command);
+			sendERR_NOTREGISTERED(clientFd);
+			return;
 		}
-		else if (cmdName == "WHOIS")
+		handleUndline(clientFd, command);
+	}
+	else if (cmdName == "STATS")
+	{
+		if (!Users[clientFd].getIsRegister())
 		{
-			if (!Users[clientFd].getIsRegister())
-			{
-				sendERR_NOTREGISTERED(clientFd);
-				continue;
-			}
-			handleWho(clientFd, command);
+			sendERR_NOTREGISTERED(clientFd);
+			return;
 		}
-		else if (cmdName == "QUIT")
+		handleStats(clientFd, command);
+	}
+	else if (cmdName == "WHO")
+	{
+		if (!Users[clientFd].getIsRegister())
 		{
-			std::cout << "[IRC] Client " << clientFd << " quit" << std::endl;
-			epoll_ctl(epollFd, EPOLL_CTL_DEL, clientFd, NULL);
-			close(clientFd);
-			Users.erase(clientFd);
+			sendERR_NOTREGISTERED(clientFd);
 			return;
 		}
-		else
+		handleWho(clientFd, command);
+	}
+	else if (cmdName == "AWAY")
+	{
+		if (!Users[clientFd].getIsRegister())
 		{
-			if (Users[clientFd].getIsRegister())
-			{
-				sendERR_UNKNOWNCOMMAND(clientFd, cmdName);
-			}
+			sendERR_NOTREGISTERED(clientFd);
+			return;
 		}
+		handleAway(clientFd, command);
 	}
+	else if (cmdName == "ISON")
+	{
+		if (!Users[clientFd].getIsRegister())
+		{
+			sendERR_NOTREGISTERED(clientFd);
+			return;
+		}
+		handleIson(clientFd, command);
+	}
+	else if (cmdName == "USERHOST")
+	{
+		if (!Users[clientFd].getIsRegister())
+		{
+			sendERR_NOTREGISTERED(clientFd);
+			return;
+		}
+		handleUserhost(clientFd, command);
+	}
+	else if (cmdName == "MONITOR")
+	{
+		if (!Users[clientFd].getIsRegister())
+		{
+			sendERR_NOTREGISTERED(clientFd);
+			return;
+		}
+		handleMonitor(clientFd, command);
+	}
+	else if (cmdName == "WHOWAS")
+	{
+		if (!Users[clientFd].getIsRegister())
+		{
+			sendERR_NOTREGISTERED(clientFd);
+			return;
+		}
+		handleWhowas(clientFd, command);
+	}
+	else if (cmdName == "LUSERS")
+	{
+		if (!Users[clientFd].getIsRegister())
+		{
+			sendERR_NOTREGISTERED(clientFd);
+			return;
+		}
+		handleLusers(clientFd, command);
+	}
+	else if (cmdName == "USERS")
+	{
+		if (!Users[clientFd].getIsRegister())
+		{
+			sendERR_NOTREGISTERED(clientFd);
+			return;
+		}
+		handleUsers(clientFd, command);
+	}
+	else if (cmdName == "LIST")
+	{
+		if (!Users[clientFd].getIsRegister())
+		{
+			sendERR_NOTREGISTERED(clientFd);
+			return;
+		}
+		handleList(clientFd, command);
+	}
+	else if (cmdName == "NAMES")
+	{
+		if (!Users[clientFd].getIsRegister())
+		{
+			sendERR_NOTREGISTERED(clientFd);
+			return;
+		}
+		handleNames(clientFd, command);
+	}
+	else if (cmdName == "MOTD")
+	{
+		if (!Users[clientFd].getIsRegister())
+		{
+			sendERR_NOTREGISTERED(clientFd);
+			return;
+		}
+		handleMotd(clientFd, command);
+	}
+	else if (cmdName == "VERSION")
+	{
+		if (!Users[clientFd].getIsRegister())
+		{
+			sendERR_NOTREGISTERED(clientFd);
+			return;
+		}
+		handleVersion(clientFd, command);
+	}
+	else if (cmdName == "INFO")
+	{
+		if (!Users[clientFd].getIsRegister())
+		{
+			sendERR_NOTREGISTERED(clientFd);
+			return;
+		}
+		handleInfo(clientFd, command);
+	}
+	else if (cmdName == "ADMIN")
+	{
+		if (!Users[clientFd].getIsRegister())
+		{
+			sendERR_NOTREGISTERED(clientFd);
+			return;
+		}
+		handleAdmin(clientFd, command);
+	}
+	else if (cmdName == "QUIT")
+	{
+		handleQuit(clientFd, command);
+	}
+	else
+	{
+		if (Users[clientFd].getIsRegister())
+		{
+			sendERR_UNKNOWNCOMMAND(clientFd, cmdName);
+		}
+	}
+}
+
+/*
+ * Log a stall and notify the operators subscribed to server notices
+ * @param kind what stalled ("command" or "loop")
+ * @param stall the offending dispatch
+ * @return void
+ */
+void Server::reportStall(const std::string &kind, const t_stall &stall)
+{
+	std::ostringstream oss;
+	oss << "Stall: " << kind << " took " << stall.usec / 1000 << "ms";
+	if (stall.fd != -1)
+	{
+		std::map<int, User>::iterator it = Users.find(stall.fd);
+		oss << " (fd " << stall.fd;
+		if (it != Users.end() && !it->second.getNickname().empty())
+			oss << ", " << it->second.getNickname();
+		oss << ", " << stall.command;
+		if (!stall.channel.empty())
+			oss << " " << stall.channel;
+		oss << ")";
+	}
+
+	std::cerr << "[IRC] " << oss.str() << std::endl;
+	sendServerNotice(oss.str());
+}
+
+/*
+ * Send a server notice to every operator subscribed to them (+s)
+ * @param message the notice text
+ * @return void
+ */
+void Server::sendServerNotice(const std::string &message)
+{
+	for (std::map<int, User>::iterator it = Users.begin(); it != Users.end(); ++it)
+	{
+		if (!it->second.isOperator() || !it->second.getServerNotices())
+			continue;
+		std::string notice = ":" + std::string(SERVER_NAME) + " NOTICE " +
+		                     it->second.getNickname() + " :*** Notice -- " + message + IRC_CRLF;
+		sendToClient(it->first, notice);
+	}
+}
+
+/*
+ * Send a server NOTICE to one client
+ * @param clientFd the client file descriptor
+ * @param message the notice text
+ * @return void
+ */
+void Server::sendNotice(const int &clientFd, const std::string &message)
+{
+	sendToClient(clientFd, ":" + std::string(SERVER_NAME) + " NOTICE " +
+	             Users[clientFd].getNickname() + " :" + message + IRC_CRLF);
 }
 
 /*
@@ -499,7 +1464,7 @@ void Server::handleCap(const int &clientFd, const std::string &line)
 		std::string response = ":";
 		response += SERVER_NAME;
 		response += " CAP * LS :\r\n";
-		send(clientFd, response.c_str(), response.length(), 0);
+		sendToClient(clientFd, response);
 	}
 	else if (line.find("END") != std::string::npos)
 	{
@@ -510,12 +1475,13 @@ void Server::handleCap(const int &clientFd, const std::string &line)
 		std::string response = ":";
 		response += SERVER_NAME;
 		response += " CAP * NAK :\r\n";
-		send(clientFd, response.c_str(), response.length(), 0);
+		sendToClient(clientFd, response);
 	}
 }
 
 /*
  * Check if user is registered and send welcome message if needed
+ * This is where a connection stops counting as unknown in LUSERS
  * @param clientFd the client file descriptor
  * @return void
  */
@@ -524,25 +1490,131 @@ void Server::checkUserRegistration(const int &clientFd)
 	User &user = Users[clientFd];
 	if (user.getIsRegister() && !user.getWelcomeMessage())
 	{
-		std::string nick = user.getNickname();
-		std::string msg = ":";
-		msg += SERVER_NAME;
-		msg += " 001 " + nick + " :Welcome to IRC\r\n";
-		send(clientFd, msg.c_str(), msg.length(), 0);
+		const t_ban *ban = findKline(user);
+		if (ban)
+		{
+			// Still counted as unknown until it is gone
+			user.setHasRegister(false);
+			sendERR_YOUREBANNEDCREEP(clientFd, ban->reason);
+			scheduleDisconnect(clientFd, "K-lined (" + ban->reason + ")");
+			return;
+		}
+
+		sendStaticReply(clientFd, welcomeReply);
 		user.hasWelcomeMessage();
+		userIndex.add(clientFd, user);
+		notifyMonitors(user.getNickname(), user.getHostmask());
+
+		lusers.unknown--;
+		lusers.registered++;
+		if (lusers.registered > lusers.localMax)
+			lusers.localMax = lusers.registered;
+		if (lusers.registered > lusers.globalMax)
+			lusers.globalMax = lusers.registered;
+		sendLusers(clientFd);
+		sendStaticReply(clientFd, motdReply);
+	}
+}
+
+/*
+ * Render the welcome burst, MOTD, VERSION, INFO and ADMIN replies
+ * The new renderings replace the old ones only once complete; a MOTD
+ * file that cannot be read keeps the previous MOTD
+ * @return void
+ */
+void Server::renderStaticReplies()
+{
+	StaticReply welcome;
+	StaticReply version;
+	StaticReply info;
+	StaticReply admin;
+	StaticReply motd;
+
+	renderWelcome(welcome);
+	renderVersion(version);
+	renderInfo(info);
+	renderAdmin(admin);
+	welcomeReply.swap(welcome);
+	versionReply.swap(version);
+	infoReply.swap(info);
+	adminReply.swap(admin);
+
+	const std::string motdPath = config.get("motd_file", MOTD_FILE);
+	if (renderMotd(motd, motdPath))
+		motdReply.swap(motd);
+	else
+		std::cout << "[IRC] " << motdPath << " could not be read, MOTD kept" << std::endl;
+}
+
+/*
+ * Render the 001-005 welcome burst
+ * @param reply the reply to fill
+ * @return void
+ */
+void Server::renderWelcome(StaticReply &reply) const
+{
+	char created[64];
+	strftime(created, sizeof(created), "%a %b %d %Y at %H:%M:%S UTC", gmtime(&startTime));
+
+	// Channel modes by type for CHANMODES, +o goes in PREFIX instead
+	std::string letters;
+	std::map<char, std::string> byType;
+	for (size_t i = 0; chanModes[i].letter; i++)
+	{
+		letters += chanModes[i].letter;
+		if (chanModes[i].letter != 'o')
+			byType[chanModes[i].type] += chanModes[i].letter;
 	}
+
+	reply.addLine(RPL_WELCOME, "", "Welcome to the " SERVER_NAME " IRC Network ", true);
+	reply.addLine(RPL_YOURHOST, "", "Your host is " SERVER_NAME ", running version " SERVER_VERSION);
+	reply.addLine(RPL_CREATED, "", std::string("This server was created ") + created);
+	reply.addLine(RPL_MYINFO, SERVER_NAME " " SERVER_VERSION " ios " + letters, "");
+	reply.addLine(RPL_ISUPPORT, "CHANTYPES=#& PREFIX=(o)@ CHANMODES=" + byType[MODE_TYPE_A] + ","
+	              + byType[MODE_TYPE_B] + "," + byType[MODE_TYPE_C] + "," + byType[MODE_TYPE_D]
+	              + " MODES=" + toString(MODE_LINE_PARAMS) + " MAXLIST=" + byType[MODE_TYPE_A] + ":"
+	              + toString(MASKLIST_MAX_ENTRIES) + " NICKLEN=" + toString(IRC_MAX_NICKNAME_LENGTH)
+	              + " CASEMAPPING=ascii ELIST=CMNTU SAFELIST WHOX TARGMAX=PRIVMSG:"
+	              + toString(MAX_TARGETS) + ",NOTICE:" + toString(MAX_TARGETS) + " MONITOR="
+	              + toString(classes.empty() ? CLASS_MONITOR : classes[0].monitor) + " NETWORK=" SERVER_NAME, "are supported by this server");
 }
 
 /*
- * Handle WHO command
+ * Send a pre-rendered reply in a single writev()
  * @param clientFd the client file descriptor
- * @param line the command line
+ * @param reply the reply
  * @return void
  */
-void Server::handleWho(const int &clientFd, const std::string &line)
+void Server::sendStaticReply(const int &clientFd, const StaticReply &reply)
 {
-	(void)clientFd;
-	(void)line;
+	std::map<int, User>::const_iterator it = Users.find(clientFd);
+	if (it == Users.end() || reply.empty())
+		return;
+
+	reply.fill(replyIov, it->second.getNickname());
+	sendToClient(clientFd, &replyIov[0], replyIov.size());
+}
+
+/*
+ * Check the optional [server] parameter of MOTD, VERSION, INFO and ADMIN
+ * Sends ERR_NOSUCHSERVER when it names another server
+ * @param clientFd the client file descriptor
+ * @param line the command line
+ * @return true if the query is for this server
+ */
+bool Server::isLocalServerTarget(const int &clientFd, const std::string &line)
+{
+	std::istringstream iss(line);
+	std::string command;
+	std::string target;
+
+	iss >> command >> target;
+	if (!target.empty() && target[0] == ':')
+		target.erase(0, 1);
+	if (target.empty() || strcasecmp(target.c_str(), SERVER_NAME) == 0)
+		return (true);
+	sendERR_NOSUCHSERVER(clientFd, target);
+	return (false);
 }
 
 /*
@@ -553,8 +1625,7 @@ void Server::handleWho(const int &clientFd, const std::string &line)
  */
 void Server::sendERR_UNKNOWNCOMMAND(const int &clientFd, const std::string &command)
 {
-	std::string msg = ":";
-	msg += SERVER_NAME;
-	msg += " 421 * " + command + " :Unknown command\r\n";
-	send(clientFd, msg.c_str(), msg.length(), 0);
+	ReplyBuilder reply;
+	reply.start(ERR_UNKNOWNCOMMAND, "*").param(command).trailing(MSG_ERR_UNKNOWNCOMMAND);
+	sendToClient(clientFd, reply);
 }
@@ -0,0 +1,128 @@
+/* ************************************************************************** */
+/*                                                                          */
+/*                                                        :::      ::::::::   */
+/*   StaticReply.cpp                                    :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: adrien <adrien@student.42.fr>              +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/19 19:04:26 by adrien            #+#    #+#             */
+/*   Updated: 2026/10/20 11:24:39 by adrien           ###   ########.fr       */
+/*                                                                          */
+/* ************************************************************************** */
+
+/*
+** ============================================================================
+**                           PRE-RENDERED REPLIES
+** ============================================================================
+**
+**  A StaticReply keeps its lines in one string with the recipient's
+**  nickname left out, and the offsets where it belongs:
+**    text  = ":ircserv 375 " | " :- ircserv Message of the day -\r\n..."
+**    holes = 13, ...
+**  fill() turns that into iovecs alternating text slices and the
+**  nickname, for a single writev(). Lines are cut when rendered so that
+**  they stay under 512 bytes with the longest nickname.
+**
+** ============================================================================
+*/
+
+#include "../includes/StaticReply.hpp"
+#include "../includes/ReplyBuilder.hpp"
+
+StaticReply::StaticReply()
+{
+}
+
+StaticReply::StaticReply(const StaticReply &src)
+{
+	*this = src;
+}
+
+StaticReply &StaticReply::operator=(const StaticReply &src)
+{
+	if (this != &src)
+	{
+		this->text = src.text;
+		this->holes = src.holes;
+	}
+	return (*this);
+}
+
+StaticReply::~StaticReply()
+{
+}
+
+/*
+ * This function renders one numeric line
+ * @param code the numeric code
+ * @param params the middle parameters after the nickname, may be empty
+ * @param trailing the trailing parameter, left out when empty
+ * @param nickInTrailing true to end the trailing with the nickname too
+ * @return void
+ */
+void StaticReply::addLine(int code, const std::string &params,
+						  const std::string &trailing, bool nickInTrailing)
+{
+	ReplyBuilder prefix;
+	prefix.start(code);
+
+	const size_t nickRoom = IRC_MAX_NICKNAME_LENGTH * (nickInTrailing ? 2 : 1);
+	const size_t lineStart = this->text.size();
+
+	this->text.append(prefix.data(), prefix.length());
+	this->holes.push_back(this->text.size());
+	if (!params.empty())
+		this->text += " " + params;
+	if (!trailing.empty() || nickInTrailing)
+		this->text += " :" + trailing;
+	if (this->text.size() - lineStart + nickRoom > REPLY_MAX_BODY)
+		this->text.resize(lineStart + REPLY_MAX_BODY - nickRoom);
+	if (nickInTrailing)
+		this->holes.push_back(this->text.size());
+	this->text += IRC_CRLF;
+}
+
+/*
+ * This function gathers the reply for one recipient
+ * @param iov cleared, then filled with the slices to write in order
+ * @param nick the recipient's nickname, "*" if empty
+ * @return void
+ */
+void StaticReply::fill(std::vector<struct iovec> &iov, const std::string &nick) const
+{
+	static const std::string unknown("*");
+	const std::string &name = nick.empty() ? unknown : nick;
+	struct iovec slice;
+	size_t from = 0;
+
+	iov.clear();
+	for (size_t i = 0; i <= this->holes.size(); i++)
+	{
+		const size_t to = (i < this->holes.size()) ? this->holes[i] : this->text.size();
+		if (to > from)
+		{
+			slice.iov_base = const_cast<char *>(this->text.data() + from);
+			slice.iov_len = to - from;
+			iov.push_back(slice);
+		}
+		if (i < this->holes.size())
+		{
+			slice.iov_base = const_cast<char *>(name.data());
+			slice.iov_len = name.size();
+			iov.push_back(slice);
+		}
+		from = to;
+	}
+}
+
+/*
+ * This function exchanges two replies, so a new rendering replaces the
+ * old one in a single step
+ * @param other the reply to exchange with
+ * @return void
+ */
+void StaticReply::swap(StaticReply &other)
+{
+	this->text.swap(other.text);
+	this->holes.swap(other.holes);
+}
@@ -0,0 +1,125 @@
+/* ************************************************************************** */
+/*                                                                          */
+/*                                                        :::      ::::::::   */
+/*   TimerWheel.cpp                                     :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: adrien <adrien@student.42.fr>              +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/19 14:31:55 by adrien            #+#    #+#             */
+/*   Updated: 2026/10/19 15:26:03 by adrien           ###   ########.fr       */
+/*                                                                          */
+/* ************************************************************************** */
+
+/*
+** ============================================================================
+**                           TIMER WHEEL
+** ============================================================================
+**
+**  Hashed timing wheel with one-second ticks: a timer due at time t sits
+**  in slot t % WHEEL_SLOTS. Each tick only looks at its own slot and
+**  fires the timers that are due, timers due in a later round stay.
+**
+**  schedule(): O(1)
+**  advance():  O(timers in the slots crossed), whatever the total count
+**  Timers are not cancelled: the owner ignores the stale ones it gets.
+**
+** ============================================================================
+*/
+
+#include "../includes/TimerWheel.hpp"
+
+/*
+ * Default constructor
+ */
+TimerWheel::TimerWheel() : slots(WHEEL_SLOTS), current(time(NULL)), count(0) {}
+
+/*
+ * Copy constructor
+ * @param src the wheel to copy
+ */
+TimerWheel::TimerWheel(const TimerWheel &src)
+{
+	*this = src;
+}
+
+/*
+ * Assignment operator
+ * @param src the wheel to copy
+ * @return reference to this wheel
+ */
+TimerWheel &TimerWheel::operator=(const TimerWheel &src)
+{
+	if (this != &src)
+	{
+		this->slots = src.slots;
+		this->current = src.current;
+		this->count = src.count;
+	}
+	return (*this);
+}
+
+/*
+ * Destructor
+ */
+TimerWheel::~TimerWheel() {}
+
+/*
+ * Add a timer
+ * @param when the time it is due
+ * @param id the id given back when it fires
+ * @return void
+ */
+void TimerWheel::schedule(time_t when, int id)
+{
+	t_timer timer;
+
+	// A timer already due fires at the next tick
+	if (when <= this->current)
+		when = this->current + 1;
+	timer.when = when;
+	timer.id = id;
+	this->slots[when % WHEEL_SLOTS].push_back(timer);
+	this->count++;
+}
+
+/*
+ * Move the wheel to the current time and collect the due timers
+ * @param now the current time
+ * @param fired filled with the ids of the timers due
+ * @return void
+ */
+void TimerWheel::advance(time_t now, std::vector<int> &fired)
+{
+	fired.clear();
+	if (now <= this->current)
+		return;
+
+	// After a long pause every slot is visited once
+	const time_t from = (now - this->current > WHEEL_SLOTS) ? now - WHEEL_SLOTS : this->current;
+	for (time_t tick = from + 1; tick <= now; tick++)
+	{
+		std::vector<t_timer> &slot = this->slots[tick % WHEEL_SLOTS];
+		size_t kept = 0;
+		for (size_t i = 0; i < slot.size(); i++)
+		{
+			if (slot[i].when <= now)
+				fired.push_back(slot[i].id);
+			else
+				slot[kept++] = slot[i];
+		}
+		this->count -= slot.size() - kept;
+		slot.resize(kept);
+	}
+	this->current = now;
+}
+
+/*
+ * Remove every timer
+ * @return void
+ */
+void TimerWheel::clear()
+{
+	for (size_t i = 0; i < this->slots.size(); i++)
+		this->slots[i].clear();
+	this->count = 0;
+}
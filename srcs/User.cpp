@@ -6,7 +6,7 @@
 /*   By: hdelacou <hdelacou@student.42.fr>          +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/12/16 04:10:00 by hdelacou          #+#    #+#             */
-/*   Updated: 2025/12/16 06:21:47 by hdelacou         ###   ########.fr       */
+/*   Updated: 2026/10/20 10:52:47 by adrien           ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -20,6 +20,9 @@
 **  Registration requires 3 flags: hasPass, hasNickname, hasUsername
 **  tryRegisterUser() validates all flags before marking user as registered
 **
+**  Prefix: ":nick!user@host" is kept ready for the serializers and only
+**          rebuilt by setNickname(), setUsername() and setHost()
+**
 ** ============================================================================
 */
 
@@ -29,8 +32,11 @@
  * Default constructor for User class
  * Initializes all member variables to default values
  */
-User::User() : nickname(""), username(""), fd(-1),
-			   hasNickname(false), hasUsername(false), hasPass(false), isRegister(false), welcomeMessage(false) {}
+User::User() : nickname(""), username(""), fd(-1), addr(0),
+			   hasNickname(false), hasUsername(false), hasPass(false), isRegister(false), isOper(false), serverNotices(false), invisible(false), welcomeMessage(false),
+			   cpuUsec(0), sends(0), commands(0), lagUntil(0), floodTokens(-1), floodStamp(0),
+			   connClass(0), sendQueue(""), lastActivity(time(NULL)), pingSent(false), signonTime(time(NULL)),
+			   authFailures(0), holdUntil(0) {}
 
 /*
  * Copy constructor for User class
@@ -53,12 +59,37 @@ User &User::operator=(const User &src)
 		return (*this);
 	this->nickname = src.nickname;
 	this->username = src.username;
+	this->realname = src.realname;
 	this->fd = src.fd;
+	this->connId = src.connId;
+	this->ip = src.ip;
+	this->addr = src.addr;
+	this->host = src.host;
+	this->hostmask = src.hostmask;
+	this->prefix = src.prefix;
 	this->hasNickname = src.hasNickname;
 	this->hasUsername = src.hasUsername;
 	this->hasPass = src.hasPass;
 	this->isRegister = src.isRegister;
+	this->isOper = src.isOper;
+	this->serverNotices = src.serverNotices;
+	this->invisible = src.invisible;
 	this->welcomeMessage = src.welcomeMessage;
+	this->awayMessage = src.awayMessage;
+	this->channels = src.channels;
+	this->cpuUsec = src.cpuUsec;
+	this->sends = src.sends;
+	this->commands = src.commands;
+	this->lagUntil = src.lagUntil;
+	this->floodTokens = src.floodTokens;
+	this->floodStamp = src.floodStamp;
+	this->connClass = src.connClass;
+	this->sendQueue = src.sendQueue;
+	this->lastActivity = src.lastActivity;
+	this->pingSent = src.pingSent;
+	this->signonTime = src.signonTime;
+	this->authFailures = src.authFailures;
+	this->holdUntil = src.holdUntil;
 	return (*this);
 }
 
@@ -77,8 +108,14 @@ User::~User()
  * @param username the user's username
  * @return void
  */
-User::User(const std::string &nickname, const std::string &username) : nickname(nickname), username(username), fd(-1), buffer(""),
-																	   hasNickname(false), hasUsername(false), hasPass(false), isRegister(false), welcomeMessage(false) {}
+User::User(const std::string &nickname, const std::string &username) : nickname(nickname), username(username), fd(-1), addr(0), buffer(""),
+																	   hasNickname(false), hasUsername(false), hasPass(false), isRegister(false), isOper(false), serverNotices(false), invisible(false), welcomeMessage(false),
+																	   cpuUsec(0), sends(0), commands(0), lagUntil(0), floodTokens(-1), floodStamp(0),
+																			   connClass(0), sendQueue(""), lastActivity(time(NULL)), pingSent(false), signonTime(time(NULL)),
+																			   authFailures(0), holdUntil(0)
+{
+	updatePrefix();
+}
 
 /*
  * Set the file descriptor for the user
@@ -98,6 +135,7 @@ void User::setFd(const int &fd)
 void User::setNickname(const std::string &nickname)
 {
 	this->nickname = nickname;
+	updatePrefix();
 }
 
 /*
@@ -108,6 +146,28 @@ void User::setNickname(const std::string &nickname)
 void User::setUsername(const std::string &username)
 {
 	this->username = username;
+	updatePrefix();
+}
+
+/*
+ * Set the host shown to other clients (address or cloak)
+ * @param host the host to set
+ * @return void
+ */
+void User::setHost(const std::string &host)
+{
+	this->host = host;
+	updatePrefix();
+}
+
+/*
+ * Rebuild the cached nick!user@host and its ":" prefix form
+ * @return void
+ */
+void User::updatePrefix()
+{
+	this->hostmask = this->nickname + "!" + this->username + "@" + this->host;
+	this->prefix = ":" + this->hostmask;
 }
 
 /*
@@ -123,6 +183,56 @@ void User::closeConnection()
 	}
 }
 
+/*
+ * Charge the user for one command
+ * The penalty is added to the fake lag: commands are held back while
+ * the lag is above the throttling threshold
+ * @param now the current monotonic time in microseconds
+ * @param usec the time spent in the handler
+ * @param sends the number of messages the command caused
+ * @param penalty the cost of the command in microseconds of lag
+ * @return void
+ */
+void User::charge(long now, long usec, unsigned long sends, long penalty)
+{
+	this->cpuUsec += usec;
+	this->sends += sends;
+	this->commands++;
+	if (this->lagUntil < now)
+		this->lagUntil = now;
+	this->lagUntil += penalty;
+}
+
+/*
+ * Take one line from the flood control bucket
+ * The bucket refills at rate lines per second up to burst lines,
+ * a new user starts with a full bucket
+ * @param now the current monotonic time in microseconds
+ * @param burst the bucket size in lines
+ * @param rate the refill rate in lines per second
+ * @return true if the line can be processed now
+ */
+bool User::takeToken(long now, long burst, long rate)
+{
+	const long capacity = burst * FLOOD_TOKEN_UNIT;
+
+	const long refill = (now - this->floodStamp) * rate / (1000000L / FLOOD_TOKEN_UNIT);
+
+	// Keep the stamp while the refill rounds to zero so no credit is lost
+	if (this->floodTokens < 0 || refill > 0)
+	{
+		this->floodTokens = (this->floodTokens < 0) ? capacity : this->floodTokens + refill;
+		this->floodStamp = now;
+	}
+	if (this->floodTokens > capacity)
+		this->floodTokens = capacity;
+
+	if (this->floodTokens < FLOOD_TOKEN_UNIT)
+		return (false);
+	this->floodTokens -= FLOOD_TOKEN_UNIT;
+	return (true);
+}
+
 /*
  * Try to register the user
  * User is registered if they have nickname, username, and password
@@ -0,0 +1,179 @@
+/* ************************************************************************** */
+/*                                                                          */
+/*                                                        :::      ::::::::   */
+/*   UserIndex.cpp                                      :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: adrien <adrien@student.42.fr>              +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/19 20:52:30 by adrien            #+#    #+#             */
+/*   Updated: 2026/10/19 20:52:30 by adrien           ###   ########.fr       */
+/*                                                                          */
+/* ************************************************************************** */
+
+/*
+** ============================================================================
+**                          USER INDEX (WHO)
+** ============================================================================
+**
+**  forward[field]:  ("irc.isp.net", fd)   lowercase value
+**  reversed[field]: ("ten.psi.cri", fd)   same, read backwards
+**
+**  collect("*.isp.net") → literal suffix ".isp.net" is longer than the
+**      empty prefix → range of reversed[] starting with "ten.psi."
+**  collect("bob")       → no wildcard → exact range of forward[]
+**  collect("*o*")       → nothing literal at either end → every client
+**
+**  The candidates are still matched against the whole mask by WHO.
+**
+** ============================================================================
+*/
+
+#include "../includes/UserIndex.hpp"
+#include <climits>
+#include <cctype>
+#include <algorithm>
+
+UserIndex::UserIndex()
+{
+}
+
+UserIndex::UserIndex(const UserIndex &src)
+{
+	*this = src;
+}
+
+UserIndex &UserIndex::operator=(const UserIndex &src)
+{
+	if (this != &src)
+	{
+		for (int i = 0; i < WHO_FIELDS; i++)
+		{
+			this->forward[i] = src.forward[i];
+			this->reversed[i] = src.reversed[i];
+		}
+	}
+	return (*this);
+}
+
+UserIndex::~UserIndex()
+{
+}
+
+/*
+ * This function gives the lowercase value of a field of a client
+ * @param user the client
+ * @param field the field (e_whofield)
+ * @return the value
+ */
+std::string UserIndex::value(const User &user, int field)
+{
+	std::string text;
+
+	if (field == WHO_NICK)
+		text = user.getNickname();
+	else if (field == WHO_USER)
+		text = user.getUsername();
+	else if (field == WHO_HOST)
+		text = user.getHost();
+	else
+		text = user.getRealname();
+	for (size_t i = 0; i < text.length(); i++)
+		text[i] = std::tolower(text[i]);
+	return (text);
+}
+
+/*
+ * This function indexes a client once it is registered
+ * @param fd the client file descriptor
+ * @param user the client
+ * @return void
+ */
+void UserIndex::add(int fd, const User &user)
+{
+	for (int i = 0; i < WHO_FIELDS; i++)
+	{
+		std::string text = value(user, i);
+		this->forward[i].insert(std::make_pair(text, fd));
+		std::reverse(text.begin(), text.end());
+		this->reversed[i].insert(std::make_pair(text, fd));
+	}
+}
+
+/*
+ * This function forgets a client, before it changes or leaves
+ * @param fd the client file descriptor
+ * @param user the client as it was indexed
+ * @return void
+ */
+void UserIndex::remove(int fd, const User &user)
+{
+	for (int i = 0; i < WHO_FIELDS; i++)
+	{
+		std::string text = value(user, i);
+		this->forward[i].erase(std::make_pair(text, fd));
+		std::reverse(text.begin(), text.end());
+		this->reversed[i].erase(std::make_pair(text, fd));
+	}
+}
+
+/*
+ * This function adds the clients whose key starts with a literal
+ * @param keys the field order to walk
+ * @param literal the lowercase literal ('?' ends it)
+ * @param exact true if the key must be the literal itself
+ * @param fds where to add the clients
+ * @return void
+ */
+void UserIndex::range(const t_keys &keys, const std::string &literal, bool exact, std::vector<int> &fds)
+{
+	t_keys::const_iterator it = keys.lower_bound(std::make_pair(literal, INT_MIN));
+
+	for (; it != keys.end(); ++it)
+	{
+		if (exact ? it->first != literal : it->first.compare(0, literal.length(), literal) != 0)
+			break;
+		fds.push_back(it->second);
+	}
+}
+
+/*
+ * This function adds the clients whose field may match a mask
+ * The longer of the literal prefix and the literal suffix of the mask
+ * picks the order to walk; a mask with neither gives every client
+ * @param field the field (e_whofield)
+ * @param mask the glob mask
+ * @param fds where to add the clients (may hold duplicates)
+ * @return void
+ */
+void UserIndex::collect(int field, const std::string &mask, std::vector<int> &fds) const
+{
+	size_t first = mask.find_first_of("*?");
+	size_t last = mask.find_last_of("*?");
+	std::string prefix = mask.substr(0, first);
+	std::string suffix = (last == std::string::npos) ? mask : mask.substr(last + 1);
+
+	for (size_t i = 0; i < prefix.length(); i++)
+		prefix[i] = std::tolower(prefix[i]);
+	for (size_t i = 0; i < suffix.length(); i++)
+		suffix[i] = std::tolower(suffix[i]);
+	if (first == std::string::npos)
+		range(this->forward[field], prefix, true, fds);
+	else if (prefix.length() >= suffix.length())
+		range(this->forward[field], prefix, false, fds);
+	else
+	{
+		std::reverse(suffix.begin(), suffix.end());
+		range(this->reversed[field], suffix, false, fds);
+	}
+}
+
+/*
+ * This function gives every indexed client
+ * @param fds where to add the clients
+ * @return void
+ */
+void UserIndex::all(std::vector<int> &fds) const
+{
+	for (t_keys::const_iterator it = this->forward[WHO_NICK].begin(); it != this->forward[WHO_NICK].end(); ++it)
+		fds.push_back(it->second);
+}
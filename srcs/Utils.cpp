@@ -6,7 +6,7 @@
 /*   By: adrien <adrien@student.42.fr>              +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/12/16 06:12:15 by hdelacou          #+#    #+#             */
-/*   Updated: 2026/01/15 07:58:37 by adrien           ###   ########.fr       */
+/*   Updated: 2026/10/19 18:02:47 by adrien           ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -17,11 +17,19 @@
 **
 **  getParam(): Extracts first parameter from IRC command line
 **  getChannelName(): Parses channel name (starting with #) from message
+**  getTargetChannel(): Channel named by the first parameter, if any
+**  toString(): Number to decimal string
+**  getTimeUsec(): Monotonic clock in microseconds (for timing handlers)
+**  cloakAddress(): Keyed hash of an IPv4 address, one segment per prefix
+**                  ("1.2.3.4" → "H(1.2.3.4).H(1.2.3).H(1.2).IP") so that
+**                  bans on "*.H(1.2.3).H(1.2).IP" still cover a /24
 **
 ** ============================================================================
 */
 
 #include "../includes/Utils.hpp"
+#include <ctime>
+#include <sstream>
 
 /*
  * Get the first parameter from a line
@@ -57,3 +65,94 @@ const std::string getChannelName(const std::string &line)
 	const std::string channelName = tmp.substr(0, tmp.find(' '));
 	return (channelName);
 }
+
+/*
+ * Get the channel targeted by a command (its first parameter)
+ * Unlike getChannelName(), a '#' inside the trailing text is ignored
+ * @param line the line to parse
+ * @return the first channel of the first parameter, or an empty string
+ */
+const std::string getTargetChannel(const std::string &line)
+{
+	size_t start = line.find(' ');
+	if (start == std::string::npos)
+		return (EMPTY_STRING);
+	start = line.find_first_not_of(' ', start);
+	if (start == std::string::npos || (line[start] != '#' && line[start] != '&'))
+		return (EMPTY_STRING);
+
+	const size_t end = line.find_first_of(", \r\n", start);
+	if (end == std::string::npos)
+		return (line.substr(start));
+	return (line.substr(start, end - start));
+}
+
+/*
+ * Convert a number to its decimal representation
+ * @param number the number to convert
+ * @return the decimal string
+ */
+const std::string toString(long number)
+{
+	std::ostringstream oss;
+	oss << number;
+	return (oss.str());
+}
+
+/*
+ * Get the current time from a monotonic clock
+ * Not affected by system clock changes, only meant for durations
+ * @return the time in microseconds
+ */
+long getTimeUsec()
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (ts.tv_sec * 1000000L + ts.tv_nsec / 1000L);
+}
+
+/*
+ * Keyed FNV-1a hash of a text, as 8 uppercase hex digits
+ * @param text the text to hash
+ * @param key the secret key
+ * @return the hash
+ */
+static std::string cloakSegment(const std::string &text, const std::string &key)
+{
+	unsigned int hash = 2166136261U;
+	const std::string input = key + ":" + text + ":" + key;
+
+	for (size_t i = 0; i < input.length(); i++)
+	{
+		hash ^= (unsigned char)input[i];
+		hash *= 16777619U;
+	}
+	// Final avalanche, FNV alone leaves the low bits weak
+	hash ^= hash >> 16;
+	hash *= 0x85EBCA6BU;
+	hash ^= hash >> 13;
+
+	static const char digits[] = "0123456789ABCDEF";
+	std::string segment(8, '0');
+	for (int i = 7; i >= 0; i--, hash >>= 4)
+		segment[i] = digits[hash & 0xF];
+	return (segment);
+}
+
+/*
+ * Hide an address behind a keyed hash
+ * @param ip the address as text
+ * @param key the secret cloak key
+ * @return the cloaked host
+ */
+const std::string cloakAddress(const std::string &ip, const std::string &key)
+{
+	const size_t third = ip.rfind('.');
+	const size_t second = (third == std::string::npos || third == 0) ? std::string::npos : ip.rfind('.', third - 1);
+
+	if (second == std::string::npos)
+		return (cloakSegment(ip, key) + ".IP");
+	return (cloakSegment(ip, key) + "." + cloakSegment(ip.substr(0, third), key)
+	        + "." + cloakSegment(ip.substr(0, second), key) + ".IP");
+}
@@ -0,0 +1,185 @@
+/* ************************************************************************** */
+/*                                                                          */
+/*                                                        :::      ::::::::   */
+/*   Watchdog.cpp                                       :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: adrien <adrien@student.42.fr>              +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/19 09:31:05 by adrien            #+#    #+#             */
+/*   Updated: 2026/10/19 09:31:05 by adrien           ###   ########.fr       */
+/*                                                                          */
+/* ************************************************************************** */
+
+/*
+** ============================================================================
+**                           EVENT LOOP STALL WATCHDOG
+** ============================================================================
+**
+**  The loop is single-threaded: one slow handler delays every other client.
+**
+**  recordCommand(): Times one handleLine() dispatch (fd, command, channel)
+**  beginLoop() / endLoop(): Times one epoll iteration, blamed on its
+**                           slowest command
+**  slowest: Top-N slowest dispatches seen so far (STATS w)
+**
+** ============================================================================
+*/
+
+#include "../includes/Watchdog.hpp"
+#include "../includes/Utils.hpp"
+
+/*
+ * Default constructor for Watchdog class
+ * Uses the compile-time thresholds until configure() is called
+ */
+Watchdog::Watchdog() : commandThreshold(WATCHDOG_COMMAND_THRESHOLD_MS * 1000L),
+					   loopThreshold(WATCHDOG_LOOP_THRESHOLD_MS * 1000L),
+					   topSize(WATCHDOG_TOP_SIZE), loopStart(0),
+					   commandStalls(0), loopStalls(0)
+{
+	this->loopWorst.usec = 0;
+	this->loopWorst.fd = -1;
+	this->loopWorst.when = 0;
+}
+
+/*
+ * Copy constructor for Watchdog class
+ * @param src the Watchdog object to copy from
+ */
+Watchdog::Watchdog(const Watchdog &src)
+{
+	*this = src;
+}
+
+/*
+ * Assignment operator for Watchdog class
+ * @param src the Watchdog object to copy from
+ * @return reference to this Watchdog object
+ */
+Watchdog &Watchdog::operator=(const Watchdog &src)
+{
+	if (this == &src)
+		return (*this);
+	this->commandThreshold = src.commandThreshold;
+	this->loopThreshold = src.loopThreshold;
+	this->topSize = src.topSize;
+	this->loopStart = src.loopStart;
+	this->loopWorst = src.loopWorst;
+	this->slowest = src.slowest;
+	this->commandStalls = src.commandStalls;
+	this->loopStalls = src.loopStalls;
+	return (*this);
+}
+
+/*
+ * Destructor for Watchdog class
+ */
+Watchdog::~Watchdog() {}
+
+/*
+ * Set the stall thresholds and the size of the slowest commands table
+ * @param commandThresholdMs max duration of one command dispatch
+ * @param loopThresholdMs max duration of one loop iteration
+ * @param topSize number of entries kept in the slowest commands table
+ */
+void Watchdog::configure(long commandThresholdMs, long loopThresholdMs, size_t topSize)
+{
+	this->commandThreshold = commandThresholdMs * 1000L;
+	this->loopThreshold = loopThresholdMs * 1000L;
+	this->topSize = topSize;
+	if (this->slowest.size() > topSize)
+		this->slowest.resize(topSize);
+}
+
+/*
+ * Insert a sample in the slowest commands table (sorted, slowest first)
+ * @param sample the sample to insert
+ */
+void Watchdog::recordSlowest(const t_stall &sample)
+{
+	if (this->topSize == 0)
+		return;
+	if (this->slowest.size() >= this->topSize && sample.usec <= this->slowest.back().usec)
+		return;
+
+	std::vector<t_stall>::iterator it = this->slowest.begin();
+	while (it != this->slowest.end() && it->usec >= sample.usec)
+		++it;
+	this->slowest.insert(it, sample);
+	if (this->slowest.size() > this->topSize)
+		this->slowest.pop_back();
+}
+
+/*
+ * Start timing a loop iteration
+ */
+void Watchdog::beginLoop()
+{
+	this->loopStart = getTimeUsec();
+	this->loopWorst.usec = 0;
+	this->loopWorst.fd = -1;
+	this->loopWorst.command.clear();
+	this->loopWorst.channel.clear();
+}
+
+/*
+ * Stop timing a loop iteration
+ * @param stall filled with the iteration duration and its slowest command
+ * @return true if the iteration exceeded the loop threshold
+ */
+bool Watchdog::endLoop(t_stall &stall)
+{
+	const long elapsed = getTimeUsec() - this->loopStart;
+
+	if (elapsed < this->loopThreshold)
+		return (false);
+
+	this->loopStalls++;
+	stall = this->loopWorst;
+	stall.usec = elapsed;
+	stall.when = time(NULL);
+	return (true);
+}
+
+/*
+ * Record the duration of one command dispatch
+ * @param fd the client that sent the command
+ * @param command the command name
+ * @param channel the channel targeted by the command (may be empty)
+ * @param usec the time spent in the handler
+ * @param stall filled with the sample if it is a stall
+ * @return true if the dispatch exceeded the command threshold
+ */
+bool Watchdog::recordCommand(int fd, const std::string &command, const std::string &channel,
+							 long usec, t_stall &stall)
+{
+	if (usec > this->loopWorst.usec)
+	{
+		this->loopWorst.usec = usec;
+		this->loopWorst.fd = fd;
+		this->loopWorst.command = command;
+		this->loopWorst.channel = channel;
+	}
+
+	if (this->slowest.size() < this->topSize || usec > this->slowest.back().usec)
+	{
+		t_stall sample;
+		sample.usec = usec;
+		sample.fd = fd;
+		sample.command = command;
+		sample.channel = channel;
+		sample.when = time(NULL);
+		recordSlowest(sample);
+	}
+
+	if (usec < this->commandThreshold)
+		return (false);
+
+	this->commandStalls++;
+	stall.usec = usec;
+	stall.fd = fd;
+	stall.command = command;
+	stall.channel = channel;
+	stall.when = time(NULL);
+	return (true);
+}
@@ -0,0 +1,190 @@
+/* ************************************************************************** */
+/*                                                                          */
+/*                                                        :::      ::::::::   */
+/*   WhowasHistory.cpp                                  :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: adrien <adrien@student.42.fr>              +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/19 22:13:52 by adrien            #+#    #+#             */
+/*   Updated: 2026/10/19 22:13:52 by adrien           ###   ########.fr       */
+/*                                                                          */
+/* ************************************************************************** */
+
+/*
+** ============================================================================
+**                          WHOWAS HISTORY
+** ============================================================================
+**
+**  ring:    [ r0 | r1 | r2 | ... | rN-1 ]   next → slot to overwrite
+**  buckets: hash(lowercase nick) & (2^k - 1) → newest record, chained
+**           through newer/older
+**
+**  record(): the slot at next is the oldest record of the whole ring, so
+**      it is the tail of its bucket chain and unlinks in O(1); the new
+**      record goes at the head of its own chain.
+**  find(): walks one chain from its head, newest first, comparing the
+**      nicks case-insensitively; chains stay short since there are at
+**      least twice as many buckets as slots.
+**
+** ============================================================================
+*/
+
+#include "../includes/WhowasHistory.hpp"
+#include <cctype>
+
+WhowasHistory::WhowasHistory() : next(0), used(0)
+{
+}
+
+WhowasHistory::WhowasHistory(const WhowasHistory &src)
+{
+	*this = src;
+}
+
+WhowasHistory &WhowasHistory::operator=(const WhowasHistory &src)
+{
+	if (this != &src)
+	{
+		this->ring = src.ring;
+		this->buckets = src.buckets;
+		this->next = src.next;
+		this->used = src.used;
+	}
+	return (*this);
+}
+
+WhowasHistory::~WhowasHistory()
+{
+}
+
+/*
+ * This function hashes a nickname case-insensitively (FNV-1a)
+ * @param nick the nickname
+ * @return the hash
+ */
+size_t WhowasHistory::hash(const std::string &nick)
+{
+	size_t value = 2166136261u;
+
+	for (size_t i = 0; i < nick.length(); i++)
+	{
+		value ^= static_cast<unsigned char>(std::tolower(nick[i]));
+		value *= 16777619u;
+	}
+	return (value);
+}
+
+/*
+ * This function compares two nicknames case-insensitively
+ * @param a the first nickname
+ * @param b the second nickname
+ * @return true if they are the same nick
+ */
+bool WhowasHistory::sameNick(const std::string &a, const std::string &b)
+{
+	if (a.length() != b.length())
+		return (false);
+	for (size_t i = 0; i < a.length(); i++)
+	{
+		if (std::tolower(a[i]) != std::tolower(b[i]))
+			return (false);
+	}
+	return (true);
+}
+
+/*
+ * This function takes a record out of its bucket chain
+ * @param slot the record
+ * @return void
+ */
+void WhowasHistory::unlink(size_t slot)
+{
+	t_whowas &entry = this->ring[slot];
+
+	if (entry.newer >= 0)
+		this->ring[entry.newer].older = entry.older;
+	else
+		this->buckets[entry.bucket] = entry.older;
+	if (entry.older >= 0)
+		this->ring[entry.older].newer = entry.newer;
+}
+
+/*
+ * This function sets the number of records kept, the history is lost
+ * when it changes
+ * @param capacity the number of records
+ * @return void
+ */
+void WhowasHistory::resize(size_t capacity)
+{
+	if (capacity == this->ring.size())
+		return;
+
+	size_t count = 1;
+	while (count < capacity * 2)
+		count <<= 1;
+
+	t_whowas blank;
+	blank.signoff = 0;
+	blank.bucket = 0;
+	blank.newer = -1;
+	blank.older = -1;
+	std::vector<t_whowas>(capacity, blank).swap(this->ring);
+	std::vector<int>(count, -1).swap(this->buckets);
+	this->next = 0;
+	this->used = 0;
+}
+
+/*
+ * This function records a nickname given up, over the oldest record
+ * @param user the client as it was under that nickname
+ * @param when the time it was given up
+ * @return void
+ */
+void WhowasHistory::record(const User &user, time_t when)
+{
+	if (this->ring.empty())
+		return;
+
+	const size_t slot = this->next;
+	if (this->used == this->ring.size())
+		unlink(slot);
+	else
+		this->used++;
+	this->next = (slot + 1) % this->ring.size();
+
+	t_whowas &entry = this->ring[slot];
+	entry.nick.assign(user.getNickname());
+	entry.user.assign(user.getUsername());
+	entry.host.assign(user.getHost());
+	entry.realname.assign(user.getRealname());
+	entry.signoff = when;
+	entry.bucket = hash(entry.nick) & (this->buckets.size() - 1);
+	entry.newer = -1;
+	entry.older = this->buckets[entry.bucket];
+	if (entry.older >= 0)
+		this->ring[entry.older].newer = slot;
+	this->buckets[entry.bucket] = slot;
+}
+
+/*
+ * This function gives the records of a nickname, newest first
+ * @param nick the nickname (any case)
+ * @param found where to put the records
+ * @param max how many records at most
+ * @return the number of records found
+ */
+size_t WhowasHistory::find(const std::string &nick, const t_whowas **found, size_t max) const
+{
+	if (this->ring.empty())
+		return (0);
+
+	size_t count = 0;
+	int slot = this->buckets[hash(nick) & (this->buckets.size() - 1)];
+	for (; slot >= 0 && count < max; slot = this->ring[slot].older)
+	{
+		if (sameNick(this->ring[slot].nick, nick))
+			found[count++] = &this->ring[slot];
+	}
+	return (count);
+}
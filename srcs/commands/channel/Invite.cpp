@@ -6,7 +6,7 @@
 /*   By: adrien <adrien@student.42.fr>              +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/12/16 02:34:25 by hdelacou          #+#    #+#             */
-/*   Updated: 2026/01/21 00:51:49 by adrien           ###   ########.fr       */
+/*   Updated: 2026/10/20 09:12:08 by adrien           ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -45,13 +45,7 @@ void Server::handleInvite(const int &clientFd, const std::string &line) {
 		channelName = channelName.substr(0, endPos);
 
 	// Find target user
-	int targetFd = -1;
-	for (std::map<int, User>::iterator it = Users.begin(); it != Users.end(); ++it) {
-		if (it->second.getNickname() == targetNick) {
-			targetFd = it->first;
-			break;
-		}
-	}
+	int targetFd = findUserByNickname(targetNick);
 
 	if (targetFd == -1) {
 		sendERR_NOSUCHNICK(clientFd, targetNick);
@@ -59,45 +53,42 @@ void Server::handleInvite(const int &clientFd, const std::string &line) {
 	}
 
 	// Find channel
-	for (std::vector<Channel>::iterator it = channelList.begin(); it != channelList.end(); ++it) {
-		if (it->getName() == channelName) {
-			// Check if inviter is on channel
-			if (!it->isMember(clientFd)) {
-				sendERR_NOTONCHANNEL(clientFd, channelName);
-				return;
-			}
-
-			// Check if target is already on channel
-			if (it->isMember(targetFd)) {
-				sendERR_USERONCHANNEL(clientFd, targetNick, channelName);
-				return;
-			}
-
-			// If channel is invite-only, check if inviter is operator
-			if (it->getInviteOnly() && !it->isOperator(clientFd)) {
-				sendERR_CHANOPRIVSNEEDED(clientFd, channelName);
-				return;
-			}
-
-			// Add target to invite list
-			it->invite(targetFd);
-
-			// Send RPL_INVITING to inviter
-			std::string invitingMsg = ":" + std::string(SERVER_NAME) + " 341 " +
-			                          Users[clientFd].getNickname() + " " +
-			                          targetNick + " " + channelName + IRC_CRLF;
-			send(clientFd, invitingMsg.c_str(), invitingMsg.length(), 0);
-
-			// Send INVITE to target
-			std::string inviteMsg = ":" + Users[clientFd].getNickname() + "!" +
-			                        Users[clientFd].getUsername() + "@localhost INVITE " +
-			                        targetNick + " " + channelName + IRC_CRLF;
-			send(targetFd, inviteMsg.c_str(), inviteMsg.length(), 0);
-
-			std::cout << "[IRC] " << Users[clientFd].getNickname() << " invited "
-			          << targetNick << " to " << channelName << std::endl;
+	std::list<Channel>::iterator it = findChannel(channelName);
+	if (it != channelList.end()) {
+		// Check if inviter is on channel
+		if (!it->isMember(clientFd)) {
+			sendERR_NOTONCHANNEL(clientFd, channelName);
 			return;
 		}
+
+		// Check if target is already on channel
+		if (it->isMember(targetFd)) {
+			sendERR_USERONCHANNEL(clientFd, targetNick, channelName);
+			return;
+		}
+
+		// If channel is invite-only, check if inviter is operator
+		if (it->getInviteOnly() && !it->isOperator(clientFd)) {
+			sendERR_CHANOPRIVSNEEDED(clientFd, channelName);
+			return;
+		}
+
+		// Add target to invite list
+		it->invite(targetFd);
+
+		// Send RPL_INVITING to inviter
+		ReplyBuilder inviting;
+		inviting.start(RPL_INVITING, Users[clientFd].getNickname())
+			.param(targetNick).param(channelName);
+		sendToClient(clientFd, inviting);
+
+		// Send INVITE to target
+		std::string inviteMsg = Users[clientFd].getPrefix() + " INVITE " + targetNick + " " + channelName + IRC_CRLF;
+		sendToClient(targetFd, inviteMsg);
+
+		std::cout << "[IRC] " << Users[clientFd].getNickname() << " invited "
+		          << targetNick << " to " << channelName << std::endl;
+		return;
 	}
 
 	sendERR_NOSUCHCHANNEL(clientFd, channelName);
@@ -6,7 +6,7 @@
 /*   By: adrien <adrien@student.42.fr>              +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/12/16 02:34:35 by hdelacou          #+#    #+#             */
-/*   Updated: 2026/01/21 00:51:49 by adrien           ###   ########.fr       */
+/*   Updated: 2026/10/20 09:41:52 by adrien           ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -62,69 +62,62 @@ void Server::handleJoin(const int &clientFd, const std::string &line) {
 
 	// Check if channel exists
 	bool found = false;
-	for (std::vector<Channel>::iterator it = channelList.begin(); it != channelList.end(); ++it) {
-		if (it->getName() == channelName) {
-			found = true;
-
-			// Check if already member
-			if (it->isMember(clientFd)) {
-				return; // Already on channel
-			}
-
-			// Check if can join (invite-only, key, limit)
-			std::string reason;
-			if (!it->canJoin(clientFd, key, reason)) {
-				if (it->getInviteOnly())
-					sendERR_INVITEONLYCHAN(clientFd, channelName);
-				else if (it->getHasKey())
-					sendERR_BADCHANNELKEY(clientFd, channelName);
-				else if (it->getUserLimit() > 0)
-					sendERR_CHANNELISFULL(clientFd, channelName);
-				return;
-			}
-
-			// Add user to channel
-			it->addMember(clientFd);
-			it->clearInvite(clientFd); // Remove from invite list if was invited
-
-			// Notify channel members
-			std::string joinMsg = ":" + Users[clientFd].getNickname() + "!" +
-			                      Users[clientFd].getUsername() + "@localhost JOIN " +
-			                      channelName + IRC_CRLF;
-			std::vector<int> members = it->getAllMembers();
-			for (size_t i = 0; i < members.size(); i++) {
-				send(members[i], joinMsg.c_str(), joinMsg.length(), 0);
-			}
-
-			// Send topic if exists
-			if (!it->getTopic().empty()) {
-				sendRPL_TOPIC(clientFd, *it);
-			} else {
-				sendRPL_NOTOPIC(clientFd, *it);
-			}
-
-			// Send names list
-			sendRPL_NAMEREPLY(clientFd, *it);
-			sendRPL_ENDOFNAMES(clientFd, *it);
+	std::list<Channel>::iterator it = findChannel(channelName);
+	if (it != channelList.end()) {
+		found = true;
+
+		// Check if already member
+		if (it->isMember(clientFd)) {
+			return; // Already on channel
+		}
+
+		// Check if can join (bans, invite-only, key, limit)
+		char mode = 0;
+		if (!it->canJoin(clientFd, Users[clientFd].getHostmask(), key, mode)) {
+			if (mode == 'b')
+				sendERR_BANNEDFROMCHAN(clientFd, channelName);
+			else if (mode == 'i')
+				sendERR_INVITEONLYCHAN(clientFd, channelName);
+			else if (mode == 'k')
+				sendERR_BADCHANNELKEY(clientFd, channelName);
+			else
+				sendERR_CHANNELISFULL(clientFd, channelName);
 			return;
 		}
+
+		// Add user to channel
+		it->addMember(clientFd, Users[clientFd].getNickname());
+		Users[clientFd].joinChannel(channelName);
+		it->clearInvite(clientFd); // Remove from invite list if was invited
+		listIndex.update(*it);
+
+		// Notify channel members (only the operators on a +u channel)
+		std::string joinMsg = Users[clientFd].getPrefix() + " JOIN " + channelName + IRC_CRLF;
+		broadcastMembership(*it, clientFd, joinMsg);
+
+		// Send topic if exists
+		if (!it->getTopic().empty()) {
+			sendRPL_TOPIC(clientFd, *it);
+		} else {
+			sendRPL_NOTOPIC(clientFd, *it);
+		}
+
+		// Send names list
+		sendNames(clientFd, *it);
+		return;
 	}
 
 	// Channel doesn't exist - create it
 	if (!found) {
-		Channel newChannel(channelName, clientFd);
-		channelList.push_back(newChannel);
+		Channel &chan = addChannel(Channel(channelName, clientFd));
+		Users[clientFd].joinChannel(channelName);
 
 		// Notify user of join
-		std::string joinMsg = ":" + Users[clientFd].getNickname() + "!" +
-		                      Users[clientFd].getUsername() + "@localhost JOIN " +
-		                      channelName + IRC_CRLF;
-		send(clientFd, joinMsg.c_str(), joinMsg.length(), 0);
+		std::string joinMsg = Users[clientFd].getPrefix() + " JOIN " + channelName + IRC_CRLF;
+		sendToClient(clientFd, joinMsg);
 
 		// Send names list (just the creator)
-		Channel &chan = channelList.back();
-		sendRPL_NAMEREPLY(clientFd, chan);
-		sendRPL_ENDOFNAMES(clientFd, chan);
+		sendNames(clientFd, chan);
 
 		std::cout << "[IRC] Channel " << channelName << " created by "
 		          << Users[clientFd].getNickname() << std::endl;
@@ -142,6 +135,7 @@ void Server::handleJoin(const int &clientFd, const std::string &line) {
 **  Action: Add user to channel (create if new).
 **  Checks: Invite-only? Key? Limit? Banned?
 **  Replies: Topic, Name list, End of names.
+**  Notify: Channel members, only the operators on a +u channel.
 **
 ** ============================================================================
 */
@@ -6,7 +6,7 @@
 /*   By: adrien <adrien@student.42.fr>              +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/12/16 02:39:05 by hdelacou          #+#    #+#             */
-/*   Updated: 2026/01/21 00:51:49 by adrien           ###   ########.fr       */
+/*   Updated: 2026/10/20 09:41:52 by adrien           ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -62,58 +62,48 @@ void Server::handleKick(const int &clientFd, const std::string &line) {
 		comment = comment.substr(0, endPos);
 
 	// Find channel
-	for (std::vector<Channel>::iterator it = channelList.begin(); it != channelList.end(); ++it) {
-		if (it->getName() == channelName) {
-			// Check if kicker is on channel
-			if (!it->isMember(clientFd)) {
-				sendERR_NOTONCHANNEL(clientFd, channelName);
-				return;
-			}
-
-			// Check if kicker is operator
-			if (!it->isOperator(clientFd)) {
-				sendERR_CHANOPRIVSNEEDED(clientFd, channelName);
-				return;
-			}
-
-			// Find target user fd
-			int targetFd = -1;
-			for (std::map<int, User>::iterator uit = Users.begin(); uit != Users.end(); ++uit) {
-				if (uit->second.getNickname() == targetNick) {
-					targetFd = uit->first;
-					break;
-				}
-			}
-
-			if (targetFd == -1) {
-				sendERR_NOSUCHNICK(clientFd, targetNick);
-				return;
-			}
-
-			// Check if target is on channel
-			if (!it->isMember(targetFd)) {
-				sendERR_USERNOTINCHANNEL(clientFd, targetNick, channelName);
-				return;
-			}
-
-			// Broadcast KICK message to channel
-			std::string kickMsg = ":" + Users[clientFd].getNickname() + "!" +
-			                      Users[clientFd].getUsername() + "@localhost KICK " +
-			                      channelName + " " + targetNick + " :" + comment + IRC_CRLF;
-			std::vector<int> members = it->getAllMembers();
-			for (size_t i = 0; i < members.size(); i++) {
-				send(members[i], kickMsg.c_str(), kickMsg.length(), 0);
-			}
-
-			// Remove target from channel
-			it->removeMember(targetFd);
-
-			// If channel is empty, delete it
-			if (it->isEmpty()) {
-				channelList.erase(it);
-			}
+	std::list<Channel>::iterator it = findChannel(channelName);
+	if (it != channelList.end()) {
+		// Check if kicker is on channel
+		if (!it->isMember(clientFd)) {
+			sendERR_NOTONCHANNEL(clientFd, channelName);
 			return;
 		}
+
+		// Check if kicker is operator
+		if (!it->isOperator(clientFd)) {
+			sendERR_CHANOPRIVSNEEDED(clientFd, channelName);
+			return;
+		}
+
+		// Find target user fd
+		int targetFd = findUserByNickname(targetNick);
+
+		if (targetFd == -1) {
+			sendERR_NOSUCHNICK(clientFd, targetNick);
+			return;
+		}
+
+		// Check if target is on channel
+		if (!it->isMember(targetFd)) {
+			sendERR_USERNOTINCHANNEL(clientFd, targetNick, channelName);
+			return;
+		}
+
+		// Broadcast KICK message to channel
+		std::string kickMsg = Users[clientFd].getPrefix() + " KICK " + channelName + " " + targetNick + " :" + comment + IRC_CRLF;
+		broadcastMembership(*it, targetFd, kickMsg);
+
+		// Remove target from channel
+		it->removeMember(targetFd);
+		Users[targetFd].leaveChannel(channelName);
+
+		// If channel is empty, delete it
+		if (it->isEmpty()) {
+			eraseChannel(it);
+		} else
+			listIndex.update(*it);
+		return;
 	}
 
 	sendERR_NOSUCHCHANNEL(clientFd, channelName);
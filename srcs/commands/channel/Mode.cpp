@@ -6,7 +6,7 @@
 /*   By: adrien <adrien@student.42.fr>              +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/12/16 02:39:09 by hdelacou          #+#    #+#             */
-/*   Updated: 2026/01/21 00:51:49 by adrien           ###   ########.fr       */
+/*   Updated: 2026/10/20 10:11:34 by adrien           ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -14,11 +14,29 @@
 #include "../../../includes/Utils.hpp"
 #include <sstream>
 #include <cstdlib>
+#include <strings.h>
+
+/*
+* The channel modes: letter, type (parameter rules), privilege needed to
+* change and to list, handler. CHANMODES=beI,k,l,itu
+*/
+const t_chanmode Server::chanModes[] = {
+	{'b', MODE_TYPE_A, MODE_PRIV_CHANOP, MODE_PRIV_ANY, &Server::modeList},
+	{'e', MODE_TYPE_A, MODE_PRIV_CHANOP, MODE_PRIV_CHANOP, &Server::modeList},
+	{'I', MODE_TYPE_A, MODE_PRIV_CHANOP, MODE_PRIV_CHANOP, &Server::modeList},
+	{'k', MODE_TYPE_B, MODE_PRIV_CHANOP, MODE_PRIV_ANY, &Server::modeKey},
+	{'o', MODE_TYPE_B, MODE_PRIV_CHANOP, MODE_PRIV_ANY, &Server::modeOperator},
+	{'l', MODE_TYPE_C, MODE_PRIV_CHANOP, MODE_PRIV_ANY, &Server::modeLimit},
+	{'i', MODE_TYPE_D, MODE_PRIV_CHANOP, MODE_PRIV_ANY, &Server::modeFlag},
+	{'t', MODE_TYPE_D, MODE_PRIV_CHANOP, MODE_PRIV_ANY, &Server::modeFlag},
+	{'u', MODE_TYPE_D, MODE_PRIV_CHANOP, MODE_PRIV_ANY, &Server::modeFlag},
+	{0, 0, 0, 0, NULL}
+};
 
 /*
 * this fonction will handle the MODE command
 * Format: MODE <channel> [<modes> [<mode params>]]
-* Modes: i (invite-only), t (topic-op-only), k (key), o (operator), l (limit)
+* Modes: see chanModes
 * @param clientFd the client file descriptor
 * @param line the line to parse
 * @return void
@@ -65,166 +83,480 @@ void Server::handleMode(const int &clientFd, const std::string &line) {
 	if (endPos != std::string::npos)
 		modeArgs = modeArgs.substr(0, endPos);
 
+	if (target.empty()) {
+		sendERR_NEEDMOREPARAMS(clientFd, "MODE");
+		return;
+	}
+
 	// Check if target is a channel
 	if (target[0] != '#' && target[0] != '&') {
-		// User mode - not fully implemented
+		handleUserMode(clientFd, target, modeStr);
 		return;
 	}
 
 	// Find channel
-	for (std::vector<Channel>::iterator it = channelList.begin(); it != channelList.end(); ++it) {
-		if (it->getName() == target) {
-			// If no mode specified, return current modes
-			if (modeStr.empty()) {
-				std::string modes = "+";
-				std::string modeParams = "";
-
-				if (it->getInviteOnly()) modes += "i";
-				if (it->getTopicOpOnly()) modes += "t";
-				if (it->getHasKey()) {
-					modes += "k";
-					modeParams += " " + it->getKey();
-				}
-				if (it->getUserLimit() > 0) {
-					modes += "l";
-					std::ostringstream oss;
-					oss << it->getUserLimit();
-					modeParams += " " + oss.str();
-				}
-
-				std::string reply = ":" + std::string(SERVER_NAME) + " 324 " +
-				                    Users[clientFd].getNickname() + " " + target + " " +
-				                    modes + modeParams + IRC_CRLF;
-				send(clientFd, reply.c_str(), reply.length(), 0);
-				return;
-			}
+	std::list<Channel>::iterator it = findChannel(target);
+	if (it != channelList.end()) {
+		// If no mode specified, return current modes
+		if (modeStr.empty()) {
+			sendChannelModes(clientFd, *it);
+			return;
+		}
 
-			// Check if user is on channel
-			if (!it->isMember(clientFd)) {
-				sendERR_NOTONCHANNEL(clientFd, target);
-				return;
-			}
+		// Split modeArgs into vector
+		std::vector<std::string> args;
+		std::istringstream iss(modeArgs);
+		std::string arg;
+		while (iss >> arg) {
+			args.push_back(arg);
+		}
 
-			// Check if user is operator
-			if (!it->isOperator(clientFd)) {
-				sendERR_CHANOPRIVSNEEDED(clientFd, target);
-				return;
-			}
+		applyChannelModes(clientFd, *it, modeStr, args);
+		return;
+	}
+
+	sendERR_NOSUCHCHANNEL(clientFd, target);
+}
+
+/*
+* This function sends the current modes of a channel (RPL_CHANNELMODEIS)
+* @param clientFd the client file descriptor
+* @param channel the channel
+* @return void
+*/
+void Server::sendChannelModes(const int &clientFd, const Channel &channel) {
+	std::string modes = "+";
+	std::string modeParams = "";
+
+	if (channel.getInviteOnly()) modes += "i";
+	if (channel.getTopicOpOnly()) modes += "t";
+	if (channel.getAuditorium()) modes += "u";
+	if (channel.getHasKey()) {
+		modes += "k";
+		modeParams += " " + channel.getKey();
+	}
+	if (channel.getUserLimit() > 0) {
+		modes += "l";
+		modeParams += " " + toString(channel.getUserLimit());
+	}
+
+	ReplyBuilder reply;
+	reply.start(RPL_CHANNELMODEIS, Users[clientFd].getNickname())
+		.param(channel.getName()).param(modes).append(modeParams);
+	sendToClient(clientFd, reply);
+}
+
+/*
+* This function finds a mode in the channel mode table
+* @param letter the mode character
+* @return the mode, NULL if unknown
+*/
+const t_chanmode *Server::findChanMode(char letter) const {
+	for (size_t i = 0; chanModes[i].letter; i++) {
+		if (chanModes[i].letter == letter)
+			return &chanModes[i];
+	}
+	return NULL;
+}
+
+/*
+* This function runs a mode string against the mode table in one pass:
+* parameters are taken by type, privileges checked per mode, list
+* queries answered, and the changes that took effect are queued for one
+* broadcast
+* @param clientFd the client file descriptor
+* @param chan the channel
+* @param modeStr the mode characters ("+o-v", ...)
+* @param args the mode parameters
+* @return void
+*/
+void Server::applyChannelModes(const int &clientFd, Channel &chan, const std::string &modeStr,
+                               const std::vector<std::string> &args) {
+	std::vector<t_modechange> applied;
+	bool adding = true;
+	bool denied = false;
+	size_t argIndex = 0;
+
+	for (size_t i = 0; i < modeStr.length(); i++) {
+		const char c = modeStr[i];
+
+		if (c == '+' || c == '-') {
+			adding = (c == '+');
+			continue;
+		}
+
+		const t_chanmode *mode = findChanMode(c);
+		if (!mode) {
+			sendERR_UNKNOWNMODE(clientFd, c);
+			continue;
+		}
+
+		// Parameter rules of the mode type
+		std::string param;
+		const bool takesParam = mode->type == MODE_TYPE_A || mode->type == MODE_TYPE_B
+		                        || (mode->type == MODE_TYPE_C && adding);
+		if (takesParam && argIndex < args.size())
+			param = args[argIndex++];
 
-			// Parse modes
-			bool adding = true;
-			std::string appliedModes = "";
-			std::string appliedParams = "";
-			size_t argIndex = 0;
-
-			// Split modeArgs into vector
-			std::vector<std::string> args;
-			std::istringstream iss(modeArgs);
-			std::string arg;
-			while (iss >> arg) {
-				args.push_back(arg);
+		if (mode->type == MODE_TYPE_A && param.empty()) {
+			if (mode->listPriv == MODE_PRIV_CHANOP && !chan.isOperator(clientFd))
+				sendERR_CHANOPRIVSNEEDED(clientFd, chan.getName());
+			else
+				sendMaskList(clientFd, chan, c);
+			continue;
+		}
+
+		if (mode->setPriv == MODE_PRIV_CHANOP && !chan.isOperator(clientFd)) {
+			if (!denied) {
+				if (!chan.isMember(clientFd))
+					sendERR_NOTONCHANNEL(clientFd, chan.getName());
+				else
+					sendERR_CHANOPRIVSNEEDED(clientFd, chan.getName());
+				denied = true;
 			}
+			continue;
+		}
 
-			for (size_t i = 0; i < modeStr.length(); i++) {
-				char c = modeStr[i];
-
-				if (c == '+') {
-					adding = true;
-					appliedModes += "+";
-				} else if (c == '-') {
-					adding = false;
-					appliedModes += "-";
-				} else if (c == 'i') {
-					it->setInviteOnly(adding);
-					appliedModes += "i";
-				} else if (c == 't') {
-					it->setTopicOpOnly(adding);
-					appliedModes += "t";
-				} else if (c == 'k') {
-					if (adding) {
-						if (argIndex < args.size()) {
-							it->setKey(args[argIndex]);
-							appliedModes += "k";
-							appliedParams += " " + args[argIndex];
-							argIndex++;
-						} else {
-							sendERR_NEEDMOREPARAMS(clientFd, "MODE");
-						}
-					} else {
-						it->clearKey();
-						appliedModes += "k";
-					}
-				} else if (c == 'o') {
-					if (argIndex < args.size()) {
-						std::string nickArg = args[argIndex];
-						argIndex++;
-
-						// Find user by nick
-						int targetFd = -1;
-						for (std::map<int, User>::iterator uit = Users.begin(); uit != Users.end(); ++uit) {
-							if (uit->second.getNickname() == nickArg) {
-								targetFd = uit->first;
-								break;
-							}
-						}
-
-						if (targetFd == -1) {
-							sendERR_NOSUCHNICK(clientFd, nickArg);
-							continue;
-						}
-
-						if (!it->isMember(targetFd)) {
-							sendERR_USERNOTINCHANNEL(clientFd, nickArg, target);
-							continue;
-						}
-
-						if (adding) {
-							it->addOperator(targetFd);
-						} else {
-							it->removeOperator(targetFd);
-						}
-						appliedModes += "o";
-						appliedParams += " " + nickArg;
-					} else {
-						sendERR_NEEDMOREPARAMS(clientFd, "MODE");
-					}
-				} else if (c == 'l') {
-					if (adding) {
-						if (argIndex < args.size()) {
-							int limit = std::atoi(args[argIndex].c_str());
-							if (limit > 0) {
-								it->setUserLimit(limit);
-								appliedModes += "l";
-								appliedParams += " " + args[argIndex];
-							}
-							argIndex++;
-						} else {
-							sendERR_NEEDMOREPARAMS(clientFd, "MODE");
-						}
-					} else {
-						it->resetUserLimit();
-						appliedModes += "l";
-					}
-				} else {
-					sendERR_UNKNOWNMODE(clientFd, c);
-				}
+		if (takesParam && param.empty() && adding) {
+			sendERR_NEEDMOREPARAMS(clientFd, "MODE");
+			continue;
+		}
+
+		if ((this->*(mode->apply))(chan, clientFd, c, adding, param)) {
+			t_modechange change;
+			change.sign = adding ? '+' : '-';
+			change.letter = c;
+			change.param = param;
+			applied.push_back(change);
+		}
+	}
+
+	if (!applied.empty())
+		queueModeChanges(clientFd, chan, applied);
+}
+
+/*
+* This function sets or clears a flag mode (i, t, u)
+* @param chan the channel
+* @param clientFd the client file descriptor
+* @param letter the mode character
+* @param adding true for +, false for -
+* @param param unused
+* @return true if the flag changed
+*/
+bool Server::modeFlag(Channel &chan, const int &clientFd, char letter, bool adding, std::string &param) {
+	(void)clientFd;
+	(void)param;
+	if (letter == 'i') {
+		if (chan.getInviteOnly() == adding)
+			return false;
+		chan.setInviteOnly(adding);
+	} else if (letter == 'u') {
+		if (chan.getAuditorium() == adding)
+			return false;
+		chan.setAuditorium(adding);
+	} else {
+		if (chan.getTopicOpOnly() == adding)
+			return false;
+		chan.setTopicOpOnly(adding);
+	}
+	return true;
+}
+
+/*
+* This function sets or clears the channel key (k)
+* "-k" needs no parameter, the broadcast shows "-k *"
+* @param chan the channel
+* @param clientFd the client file descriptor
+* @param letter the mode character
+* @param adding true for +, false for -
+* @param param the key, rewritten to "*" on removal
+* @return true if the key changed
+*/
+bool Server::modeKey(Channel &chan, const int &clientFd, char letter, bool adding, std::string &param) {
+	(void)clientFd;
+	(void)letter;
+	if (adding) {
+		if (chan.getHasKey() && chan.getKey() == param)
+			return false;
+		chan.setKey(param);
+		return true;
+	}
+	if (!chan.getHasKey())
+		return false;
+	chan.clearKey();
+	param = "*";
+	return true;
+}
+
+/*
+* This function sets or clears the user limit (l)
+* @param chan the channel
+* @param clientFd the client file descriptor
+* @param letter the mode character
+* @param adding true for +, false for -
+* @param param the limit, rewritten as a plain number
+* @return true if the limit changed
+*/
+bool Server::modeLimit(Channel &chan, const int &clientFd, char letter, bool adding, std::string &param) {
+	(void)clientFd;
+	(void)letter;
+	if (adding) {
+		const int limit = std::atoi(param.c_str());
+		if (limit <= 0 || limit == chan.getUserLimit())
+			return false;
+		chan.setUserLimit(limit);
+		param = toString(limit);
+		return true;
+	}
+	if (chan.getUserLimit() <= 0)
+		return false;
+	chan.resetUserLimit();
+	return true;
+}
+
+/*
+* This function gives or takes channel operator status (o)
+* @param chan the channel
+* @param clientFd the client file descriptor
+* @param letter the mode character
+* @param adding true for +, false for -
+* @param param the nickname, rewritten with its real case
+* @return true if the status changed
+*/
+bool Server::modeOperator(Channel &chan, const int &clientFd, char letter, bool adding, std::string &param) {
+	(void)letter;
+	if (param.empty()) {
+		sendERR_NEEDMOREPARAMS(clientFd, "MODE");
+		return false;
+	}
+
+	const int targetFd = findUserByNickname(param);
+	if (targetFd == -1) {
+		sendERR_NOSUCHNICK(clientFd, param);
+		return false;
+	}
+	if (!chan.isMember(targetFd)) {
+		sendERR_USERNOTINCHANNEL(clientFd, param, chan.getName());
+		return false;
+	}
+
+	param = Users[targetFd].getNickname();
+	return adding ? chan.addOperator(targetFd) : chan.removeOperator(targetFd);
+}
+
+/*
+* This function adds or removes a ban, exception or invite exception
+* mask (b, e, I)
+* @param chan the channel
+* @param clientFd the client file descriptor
+* @param letter the mode character
+* @param adding true for +, false for -
+* @param param the mask, rewritten in its nick!user@host form
+* @return true if the list changed
+*/
+bool Server::modeList(Channel &chan, const int &clientFd, char letter, bool adding, std::string &param) {
+	param = MaskList::normalize(param);
+	if (param.empty())
+		return false;
+	if (!adding)
+		return chan.removeMask(letter, param);
+	if (chan.addMask(letter, param, Users[clientFd].getHostmask()))
+		return true;
+	if (chan.getMaskList(letter)->size() >= MASKLIST_MAX_ENTRIES)
+		sendERR_BANLISTFULL(clientFd, chan.getName(), param);
+	return false;
+}
+
+/*
+* This function sends one of the mask lists of a channel
+* @param clientFd the client file descriptor
+* @param channel the channel
+* @param mode 'b' (RPL_BANLIST), 'e' (RPL_EXCEPTLIST) or 'I' (RPL_INVITELIST)
+* @return void
+*/
+void Server::sendMaskList(const int &clientFd, const Channel &channel, char mode) {
+	std::vector<t_listmask> masks;
+
+	channel.getMaskList(mode)->list(masks);
+	for (size_t i = 0; i < masks.size(); i++)
+		sendRPL_MASKLIST(clientFd, channel.getName(), mode, masks[i]);
+	sendRPL_ENDOFMASKLIST(clientFd, channel.getName(), mode);
+}
+
+/*
+* This function holds the applied changes until the end of the current
+* run of MODE commands, so that a burst from one source goes out as one
+* broadcast per channel. Changes from another source flush the held ones
+* first to keep the order
+* @param clientFd the client file descriptor
+* @param chan the channel
+* @param changes the changes that took effect
+* @return void
+*/
+void Server::queueModeChanges(const int &clientFd, const Channel &chan,
+                              const std::vector<t_modechange> &changes) {
+	const std::string &source = Users[clientFd].getHostmask();
+
+	std::map<std::string, t_modebatch>::iterator it = modeBatches.find(chan.getName());
+	if (it != modeBatches.end() && it->second.source != source) {
+		broadcastModeChanges(it->first, it->second);
+		modeBatches.erase(it);
+	}
+
+	t_modebatch &batch = modeBatches[chan.getName()];
+	batch.source = source;
+	batch.changes.insert(batch.changes.end(), changes.begin(), changes.end());
+
+	// The fan-out happens later, it is charged to the command now
+	dispatchSends += chan.getMemberCount();
+}
+
+/*
+* This function broadcasts a batch of mode changes to a channel, split
+* into lines of at most 512 bytes and MODE_LINE_PARAMS parameters
+* Big channels get them queued like messages (see batchFanout())
+* @param channelName the channel name
+* @param batch the source and its changes
+* @return void
+*/
+void Server::broadcastModeChanges(const std::string &channelName, const t_modebatch &batch) {
+	std::list<Channel>::iterator chan = findChannel(channelName);
+	if (chan == channelList.end())
+		return;
+
+	const std::string head = ":" + batch.source + " MODE " + channelName + " ";
+	std::string out;
+	std::string modes;
+	std::string params;
+	char sign = 0;
+	size_t count = 0;
+
+	for (size_t i = 0; i < batch.changes.size(); i++) {
+		const t_modechange &change = batch.changes[i];
+		const size_t extra = 2 + (change.param.empty() ? 0 : change.param.length() + 1);
+
+		if (!modes.empty() && (head.length() + modes.length() + params.length() + extra + 2 > IRC_MAX_MESSAGE_LENGTH
+		                       || (!change.param.empty() && count == MODE_LINE_PARAMS))) {
+			out += head + modes + params + IRC_CRLF;
+			modes.clear();
+			params.clear();
+			sign = 0;
+			count = 0;
+		}
+		if (change.sign != sign) {
+			sign = change.sign;
+			modes += sign;
+		}
+		modes += change.letter;
+		if (!change.param.empty()) {
+			params += " " + change.param;
+			count++;
+		}
+	}
+	out += head + modes + params + IRC_CRLF;
+
+	const std::set<int> &members = chan->getMemberSet();
+	const bool batched = batchFanout(members.size());
+	for (std::set<int>::const_iterator member = members.begin(); member != members.end(); ++member) {
+		if (batched)
+			queueToClient(*member, out);
+		else
+			sendToClient(*member, out);
+	}
+	countChannelFanout(channelName, members.size());
+}
+
+/*
+* This function sends every held mode broadcast
+* Called before any other command runs and at the end of each loop
+* iteration
+* @return void
+*/
+void Server::flushModeBatches() {
+	for (std::map<std::string, t_modebatch>::iterator it = modeBatches.begin();
+	     it != modeBatches.end(); ++it)
+		broadcastModeChanges(it->first, it->second);
+	modeBatches.clear();
+}
+
+/*
+* this fonction will handle the user MODE command
+* Format: MODE <nickname> [<modes>]
+* Modes: i (invisible), o (IRC operator, can only be removed), s (server notices)
+* @param clientFd the client file descriptor
+* @param target the nickname whose modes are queried or changed
+* @param modeStr the requested mode changes
+* @return void
+*/
+void Server::handleUserMode(const int &clientFd, const std::string &target, const std::string &modeStr) {
+	User &user = Users[clientFd];
+
+	if (strcasecmp(target.c_str(), user.getNickname().c_str()) != 0) {
+		sendERR_USERSDONTMATCH(clientFd);
+		return;
+	}
+
+	if (modeStr.empty()) {
+		std::string modes = "+";
+		if (user.isInvisible()) modes += "i";
+		if (user.isOperator()) modes += "o";
+		if (user.getServerNotices()) modes += "s";
+		sendRPL_UMODEIS(clientFd, modes);
+		return;
+	}
+
+	bool adding = true;
+	bool unknown = false;
+	char lastSign = 0;
+	std::string appliedModes = "";
+
+	for (size_t i = 0; i < modeStr.length(); i++) {
+		char c = modeStr[i];
+		bool changed = false;
+
+		if (c == '+' || c == '-') {
+			adding = (c == '+');
+			continue;
+		} else if (c == 'i') {
+			if (user.isInvisible() != adding) {
+				user.setInvisible(adding);
+				this->lusers.invisible += adding ? 1 : -1;
+				changed = true;
+			}
+		} else if (c == 'o') {
+			// +o is only granted by OPER
+			if (!adding && user.isOperator()) {
+				user.setOperator(false);
+				this->lusers.opers--;
+				changed = true;
+			}
+		} else if (c == 's') {
+			if (user.getServerNotices() != adding) {
+				user.setServerNotices(adding);
+				changed = true;
 			}
+		} else {
+			unknown = true;
+		}
 
-			// Broadcast mode change if any modes were applied
-			if (!appliedModes.empty() && appliedModes != "+" && appliedModes != "-") {
-				std::string modeMsg = ":" + Users[clientFd].getNickname() + "!" +
-				                      Users[clientFd].getUsername() + "@localhost MODE " +
-				                      target + " " + appliedModes + appliedParams + IRC_CRLF;
-				std::vector<int> members = it->getAllMembers();
-				for (size_t m = 0; m < members.size(); m++) {
-					send(members[m], modeMsg.c_str(), modeMsg.length(), 0);
-				}
+		if (changed) {
+			if (lastSign != (adding ? '+' : '-')) {
+				lastSign = adding ? '+' : '-';
+				appliedModes += lastSign;
 			}
-			return;
+			appliedModes += c;
 		}
 	}
 
-	sendERR_NOSUCHCHANNEL(clientFd, target);
+	if (unknown)
+		sendERR_UMODEUNKNOWNFLAG(clientFd);
+
+	if (!appliedModes.empty()) {
+		std::string modeMsg = ":" + user.getNickname() + " MODE " + user.getNickname() +
+		                      " :" + appliedModes + IRC_CRLF;
+		sendToClient(clientFd, modeMsg);
+	}
 }
 
 /*
@@ -233,8 +565,16 @@ void Server::handleMode(const int &clientFd, const std::string &line) {
 ** ============================================================================
 **
 **  Format: MODE <channel> <modes> [params]
+**          MODE <nickname> [<modes>]
 **
-**  Action: Apply/Remove channel modes (+i, +t, +k, +l, +o).
+**  Action: Apply/Remove channel modes (+i, +t, +u, +k, +l, +o).
+**          Add/Remove/List channel masks (+b, +e, +I), "MODE #chan b"
+**          lists the bans to anyone.
+**  Engine: chanModes table (letter, type A/B/C/D, privileges, handler);
+**          one pass over the mode string, the applied changes of a run
+**          of MODE commands from one source are broadcast together,
+**          split into 512-byte lines.
+**          Apply/Remove own user modes (+i, -o, +s).
 **  Checks: Operator privileges required for most changes.
 **
 ** ============================================================================
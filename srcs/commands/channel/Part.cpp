@@ -6,7 +6,7 @@
 /*   By: adrien <adrien@student.42.fr>              +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/12/16 02:39:17 by hdelacou          #+#    #+#             */
-/*   Updated: 2026/01/21 00:51:49 by adrien           ###   ########.fr       */
+/*   Updated: 2026/10/20 09:41:52 by adrien           ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -57,33 +57,29 @@ void Server::handlePart(const int &clientFd, const std::string &line) {
 	}
 
 	// Find channel
-	for (std::vector<Channel>::iterator it = channelList.begin(); it != channelList.end(); ++it) {
-		if (it->getName() == channelName) {
-			// Check if user is on channel
-			if (!it->isMember(clientFd)) {
-				sendERR_NOTONCHANNEL(clientFd, channelName);
-				return;
-			}
+	std::list<Channel>::iterator it = findChannel(channelName);
+	if (it != channelList.end()) {
+		// Check if user is on channel
+		if (!it->isMember(clientFd)) {
+			sendERR_NOTONCHANNEL(clientFd, channelName);
+			return;
+		}
 
-			// Notify channel members before removing
-			std::string partMsg = ":" + Users[clientFd].getNickname() + "!" +
-			                      Users[clientFd].getUsername() + "@localhost PART " +
-			                      channelName + " :" + partMessage + IRC_CRLF;
-			std::vector<int> members = it->getAllMembers();
-			for (size_t i = 0; i < members.size(); i++) {
-				send(members[i], partMsg.c_str(), partMsg.length(), 0);
-			}
+		// Notify channel members before removing
+		std::string partMsg = Users[clientFd].getPrefix() + " PART " + channelName + " :" + partMessage + IRC_CRLF;
+		broadcastMembership(*it, clientFd, partMsg);
 
-			// Remove user from channel
-			it->removeMember(clientFd);
+		// Remove user from channel
+		it->removeMember(clientFd);
+		Users[clientFd].leaveChannel(channelName);
 
-			// If channel is empty, delete it
-			if (it->isEmpty()) {
-				std::cout << "[IRC] Channel " << channelName << " deleted (empty)" << std::endl;
-				channelList.erase(it);
-			}
-			return;
-		}
+		// If channel is empty, delete it
+		if (it->isEmpty()) {
+			std::cout << "[IRC] Channel " << channelName << " deleted (empty)" << std::endl;
+			eraseChannel(it);
+		} else
+			listIndex.update(*it);
+		return;
 	}
 
 	// Channel not found
@@ -98,7 +94,8 @@ void Server::handlePart(const int &clientFd, const std::string &line) {
 **  Format: PART <channel> [:message]
 **
 **  Action: Removes user from channel.
-**  Notify: Broadcasts part message to channel members.
+**  Notify: Broadcasts part message to channel members (only to the
+**          operators on a +u channel).
 **  Cleanup: Destroys channel if empty.
 **
 ** ============================================================================
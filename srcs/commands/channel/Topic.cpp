@@ -6,7 +6,7 @@
 /*   By: adrien <adrien@student.42.fr>              +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/12/16 02:39:20 by hdelacou          #+#    #+#             */
-/*   Updated: 2026/01/21 00:51:49 by adrien           ###   ########.fr       */
+/*   Updated: 2026/10/20 09:12:08 by adrien           ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -54,45 +54,44 @@ void Server::handleTopic(const int &clientFd, const std::string &line) {
 		newTopic = newTopic.substr(0, endPos);
 
 	// Find channel
-	for (std::vector<Channel>::iterator it = channelList.begin(); it != channelList.end(); ++it) {
-		if (it->getName() == channelName) {
-			// Check if user is on channel
-			if (!it->isMember(clientFd)) {
-				sendERR_NOTONCHANNEL(clientFd, channelName);
-				return;
-			}
-
-			if (!settingTopic) {
-				// Query topic
-				if (it->getTopic().empty()) {
-					sendRPL_NOTOPIC(clientFd, *it);
-				} else {
-					sendRPL_TOPIC(clientFd, *it);
-				}
-				return;
-			}
+	std::list<Channel>::iterator it = findChannel(channelName);
+	if (it != channelList.end()) {
+		// Check if user is on channel
+		if (!it->isMember(clientFd)) {
+			sendERR_NOTONCHANNEL(clientFd, channelName);
+			return;
+		}
 
-			// Setting topic - check permissions
-			if (it->getTopicOpOnly() && !it->isOperator(clientFd)) {
-				sendERR_CHANOPRIVSNEEDED(clientFd, channelName);
-				return;
+		if (!settingTopic) {
+			// Query topic
+			if (it->getTopic().empty()) {
+				sendRPL_NOTOPIC(clientFd, *it);
+			} else {
+				sendRPL_TOPIC(clientFd, *it);
 			}
+			return;
+		}
 
-			// Set topic
-			it->setTopic(clientFd, newTopic, Users[clientFd].getNickname());
+		// Setting topic - check permissions
+		if (it->getTopicOpOnly() && !it->isOperator(clientFd)) {
+			sendERR_CHANOPRIVSNEEDED(clientFd, channelName);
+			return;
+		}
 
-			// Broadcast topic change to channel
-			std::string topicMsg = ":" + Users[clientFd].getNickname() + "!" +
-			                       Users[clientFd].getUsername() + "@localhost TOPIC " +
-			                       channelName + " :" + newTopic + IRC_CRLF;
-			std::vector<int> members = it->getAllMembers();
-			for (size_t i = 0; i < members.size(); i++) {
-				send(members[i], topicMsg.c_str(), topicMsg.length(), 0);
-			}
+		// Set topic
+		it->setTopic(clientFd, newTopic, Users[clientFd].getNickname());
+		listIndex.update(*it);
 
-			std::cout << "[IRC] Topic of " << channelName << " set to: " << newTopic << std::endl;
-			return;
+		// Broadcast topic change to channel
+		std::string topicMsg = Users[clientFd].getPrefix() + " TOPIC " + channelName + " :" + newTopic + IRC_CRLF;
+		std::vector<int> members = it->getAllMembers();
+		for (size_t i = 0; i < members.size(); i++) {
+			sendToClient(members[i], topicMsg);
 		}
+		countChannelFanout(channelName, members.size());
+
+		std::cout << "[IRC] Topic of " << channelName << " set to: " << newTopic << std::endl;
+		return;
 	}
 
 	sendERR_NOSUCHCHANNEL(clientFd, channelName);
@@ -6,7 +6,7 @@
 /*   By: hdelacou <hdelacou@student.42.fr>          +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/12/16 02:39:30 by hdelacou          #+#    #+#             */
-/*   Updated: 2025/12/16 06:30:54 by hdelacou         ###   ########.fr       */
+/*   Updated: 2026/10/19 20:52:30 by adrien           ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -46,6 +46,7 @@ void Server::handleAway(const int &clientFd, const std::string &line)
 {
 	std::string awayMessage = parseAwayMessage(line);
 
+	this->Users[clientFd].setAwayMessage(awayMessage);
 	if (awayMessage.empty())
 	{
 		sendRPL_UNAWAY(clientFd);
@@ -6,7 +6,7 @@
 /*   By: hdelacou <hdelacou@student.42.fr>          +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/12/16 02:40:03 by hdelacou          #+#    #+#             */
-/*   Updated: 2025/12/16 06:30:03 by hdelacou         ###   ########.fr       */
+/*   Updated: 2026/10/20 10:27:05 by adrien           ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -39,46 +39,19 @@ void Server::handleNotice(const int &clientFd, const std::string &line)
 	if (target.empty() || message.empty())
 		return;
 
-	// Send notice - simplified for now
-	std::string msg = ":" + this->Users[clientFd].getNickname();
-	msg += "!" + this->Users[clientFd].getUsername();
-	msg += "@localhost NOTICE " + target + " :" + message + IRC_CRLF;
-	
-	if (target[0] == '#' || target[0] == '&') {
-		// Channel notice - broadcast to channel members
-		for (std::vector<Channel>::iterator chan = channelList.begin(); 
-		     chan != channelList.end(); ++chan) {
-			if (chan->getName() == target) {
-				const std::vector<int> &members = chan->getAllMembers();
-				for (size_t i = 0; i < members.size(); i++) {
-					if (members[i] != clientFd)
-						send(members[i], msg.c_str(), msg.length(), 0);
-				}
-				return;
-			}
-		}
-	} else {
-		// User notice
-		for (std::map<int, User>::iterator it = this->Users.begin(); 
-		     it != this->Users.end(); ++it) {
-			if (it->second.getNickname() == target) {
-				send(it->first, msg.c_str(), msg.length(), 0);
-				return;
-			}
-		}
-	}
+	relayMessage(clientFd, "NOTICE", target, message);
 }
 
-
 /*
 ** ============================================================================
 **                           NOTICE COMMAND
 ** ============================================================================
 **
-**  Format: NOTICE <target> :<message>
+**  Format: NOTICE <target>{,<target>} :<message>
 **
 **  Action: Same as PRIVMSG but strictly for notifications.
 **  Rules: No automatic replies. No error messages returned.
+**         More than MAX_TARGETS targets: delivered to none of them.
 **
 ** ============================================================================
 */
\ No newline at end of file
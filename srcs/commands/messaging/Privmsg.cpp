@@ -6,13 +6,14 @@
 /*   By: adrien <adrien@student.42.fr>              +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/12/16 02:41:16 by hdelacou          #+#    #+#             */
-/*   Updated: 2026/01/21 00:51:49 by adrien           ###   ########.fr       */
+/*   Updated: 2026/10/20 10:27:05 by adrien           ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
 #include "../../../includes/Server.hpp"
 #include "../../../includes/Utils.hpp"
 #include "../../../includes/IrcReplies.hpp"
+#include <sstream>
 
 /*
 * this fonction will handle the PRIVMSG command
@@ -58,46 +59,87 @@ void Server::handlePrivateMessage(int clientFd, const std::string &line) {
 		return;
 	}
 
-	// Build message prefix
-	std::string prefix = ":" + Users[clientFd].getNickname() + "!" +
-	                     Users[clientFd].getUsername() + "@localhost";
-
-	// Check if target is a channel
-	if (target[0] == '#' || target[0] == '&') {
-		// Find channel
-		for (std::vector<Channel>::iterator it = channelList.begin(); it != channelList.end(); ++it) {
-			if (it->getName() == target) {
-				// Check if user is on channel
-				if (!it->isMember(clientFd)) {
-					sendERR_CANNOTSENDTOCHAN(clientFd, target);
-					return;
-				}
-
-				// Broadcast to all channel members except sender
-				std::string fullMsg = prefix + " PRIVMSG " + target + " :" + message + IRC_CRLF;
-				std::vector<int> members = it->getAllMembers();
-				for (size_t i = 0; i < members.size(); i++) {
-					if (members[i] != clientFd) {
-						send(members[i], fullMsg.c_str(), fullMsg.length(), 0);
-					}
-				}
-				return;
-			}
-		}
-		sendERR_NOSUCHCHANNEL(clientFd, target);
-		return;
-	}
+	relayMessage(clientFd, "PRIVMSG", target, message);
+}
 
-	// Target is a user - find by nickname
-	for (std::map<int, User>::iterator it = Users.begin(); it != Users.end(); ++it) {
-		if (it->second.getNickname() == target) {
-			std::string fullMsg = prefix + " PRIVMSG " + target + " :" + message + IRC_CRLF;
-			send(it->first, fullMsg.c_str(), fullMsg.length(), 0);
+/*
+* This function delivers a PRIVMSG or NOTICE to its comma separated
+* targets. The line of each target is built once and shared by all its
+* recipients; a client reached by several targets (channels sharing
+* members, a nick also on a channel) only gets the line of the first one.
+* Past MAX_TARGETS targets nothing is delivered at all.
+* NOTICE never causes an error reply and needs no channel membership
+* @param clientFd the sender
+* @param command "PRIVMSG" or "NOTICE"
+* @param targets the targets, comma separated
+* @param text the message
+* @return void
+*/
+void Server::relayMessage(const int &clientFd, const std::string &command, const std::string &targets,
+                          const std::string &text) {
+	const bool notice = (command == "NOTICE");
+	const User &sender = this->Users[clientFd];
+	size_t count = 0;
+
+	// Too many targets: the message goes nowhere, not to the first ones
+	std::istringstream check(targets);
+	std::string target;
+	while (std::getline(check, target, ',')) {
+		if (!target.empty() && ++count > MAX_TARGETS) {
+			if (!notice)
+				sendERR_TOOMANYTARGETS(clientFd, target);
 			return;
 		}
 	}
 
-	sendERR_NOSUCHNICK(clientFd, target);
+	beginBroadcast();
+
+	std::istringstream list(targets);
+	while (std::getline(list, target, ',')) {
+		if (target.empty())
+			continue;
+		const std::string fullMsg = sender.getPrefix() + " " + command + " " + target + " :" + text + IRC_CRLF;
+
+		if (target[0] != '#' && target[0] != '&') {
+			const int targetFd = findUserByNickname(target);
+			if (targetFd == -1) {
+				if (!notice)
+					sendERR_NOSUCHNICK(clientFd, target);
+			}
+			else if (firstDelivery(targetFd))
+				sendToClient(targetFd, fullMsg);
+			continue;
+		}
+
+		std::list<Channel>::iterator it = findChannel(target);
+		if (it == channelList.end()) {
+			if (!notice)
+				sendERR_NOSUCHCHANNEL(clientFd, target);
+			continue;
+		}
+		// Members only for PRIVMSG, and banned ones only if they are ops
+		if ((!notice && !it->isMember(clientFd))
+			|| (!it->isOperator(clientFd) && it->isBanned(clientFd, sender.getHostmask()))) {
+			if (!notice)
+				sendERR_CANNOTSENDTOCHAN(clientFd, target);
+			continue;
+		}
+
+		// Regular members of a +u channel only talk to the operators
+		const std::set<int> &members = it->getAudience(clientFd);
+		const bool batched = batchFanout(members.size());
+		size_t sent = 0;
+		for (std::set<int>::const_iterator member = members.begin(); member != members.end(); ++member) {
+			if (*member == clientFd || !firstDelivery(*member))
+				continue;
+			if (batched)
+				queueToClient(*member, fullMsg);
+			else
+				sendToClient(*member, fullMsg);
+			sent++;
+		}
+		countChannelFanout(target, sent);
+	}
 }
 
 /*
@@ -105,10 +147,18 @@ void Server::handlePrivateMessage(int clientFd, const std::string &line) {
 **                           PRIVMSG COMMAND
 ** ============================================================================
 **
-**  Format: PRIVMSG <target> :<message>
+**  Format: PRIVMSG <target>{,<target>} :<message>
 **
-**  Action: Sends message to target (User or Channel).
+**  Action: Sends message to targets (Users or Channels), MAX_TARGETS
+**          at most. Past it nothing is delivered, PRIVMSG answers
+**          ERR_TOOMANYTARGETS and NOTICE is dropped silently.
 **  Routing: Channel -> Broadcast to members. User -> Direct message.
+**           Each recipient gets the message once, with the first
+**           target that reached it.
+**           Channels of fanout_batch_members members or more get it
+**           queued, the SendQs are written at the end of the iteration.
+**  Checks: Channel senders must be members, banned ones (+b without +e)
+**          only if they are channel operators.
 **
 ** ============================================================================
 */
@@ -6,7 +6,7 @@
 /*   By: hdelacou <hdelacou@student.42.fr>          +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/12/16 03:57:42 by hdelacou          #+#    #+#             */
-/*   Updated: 2025/12/16 06:31:07 by hdelacou         ###   ########.fr       */
+/*   Updated: 2026/10/19 17:34:20 by adrien           ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -18,11 +18,6 @@
 * @param line the raw command line to parse
 * @return KillParams struct containing target nickname and reason
 */
-struct KillParams {
-	std::string target;
-	std::string reason;
-};
-
 KillParams Server::parseKillCommand(const std::string &line) {
 	KillParams params;
 	
@@ -59,57 +54,6 @@ KillParams Server::parseKillCommand(const std::string &line) {
 	return params;
 }
 
-/*
-* This function finds a user by their nickname
-* @param nickname the nickname to search for
-* @return file descriptor of the user, or -1 if not found
-*/
-int Server::findUserByNickname(const std::string &nickname) {
-	for (std::map<int, User>::iterator it = this->Users.begin(); 
-	     it != this->Users.end(); ++it) {
-		if (strcasecmp(it->second.getNickname().c_str(), nickname.c_str()) == 0)
-			return it->first;
-	}
-	return -1;
-}
-
-/*
-* this fonction will broadcast the KILL command
-* @param operatorFd the operator file descriptor
-* @param victimFd the victim file descriptor
-* @param reason the reason for the kill
-* @return void
-*/
-void Server::broadcastKill(const int &operatorFd, const int &victimFd, 
-                           const std::string &reason) {
-	std::string message = ":";
-	message += this->Users[operatorFd].getNickname();
-	message += "!" + this->Users[operatorFd].getUsername();
-	message += "@localhost KILL ";
-	message += this->Users[victimFd].getNickname();
-	message += " :";
-	message += reason + "\r\n";
-
-	// Track who we've notified
-	std::set<int> notified;
-	notified.insert(operatorFd);
-	notified.insert(victimFd);
-
-	// Send to all users in shared channels with victim
-	for (std::vector<Channel>::iterator chan = channelList.begin(); 
-	     chan != channelList.end(); ++chan) {
-		if (chan->isMember(victimFd)) {
-			const std::vector<int> &members = chan->getMembers();
-			for (size_t i = 0; i < members.size(); i++) {
-				if (notified.find(members[i]) == notified.end()) {
-					send(members[i], message.c_str(), message.length(), 0);
-					notified.insert(members[i]);
-				}
-			}
-		}
-	}
-}
-
 /*
 * this fonction will handle the KILL command
 * @param clientFd the client file descriptor
@@ -144,51 +88,13 @@ void Server::handleKill(const int &clientFd, const std::string &line) {
 	          << " killed " << params.target 
 	          << " (reason: " << params.reason << ")" << std::endl;
 
-	broadcastKill(clientFd, targetFd, params.reason);
-
-	std::string errorMsg = "ERROR :Closing Link: localhost (Killed (";
-	errorMsg += this->Users[clientFd].getNickname();
-	errorMsg += " (" + params.reason + ")))\r\n";
-	send(targetFd, errorMsg.c_str(), errorMsg.length(), 0);
+	const std::string path = "Killed (" + this->Users[clientFd].getNickname()
+	                         + " (" + params.reason + "))";
+	sendToClient(targetFd, "ERROR :Closing Link: " + this->Users[targetFd].getIp()
+	                       + " (" + path + ")" + IRC_CRLF);
 
-	removeFromAllChannels(targetFd);
-	close(targetFd);
-	removeFromPollFds(targetFd);
-	this->Users.erase(targetFd);
-}
-
-	std::cout << "User " << params.target << " (fd: " << targetFd 
-	          << ") has been killed" << std::endl;
-}
-
-/*
-* Error Response Functions for KILL command
-*/
-
-// ERR_NOPRIVILEGES (481): Permission Denied - You're not an IRC operator
-void Server::sendERR_NOPRIVILEGES(const int &clientFd) {
-	std::string nick = this->Users[clientFd].getNickname();
-	
-	std::string response = ":";
-	response += SERVER_NAME;
-	response += " 481 ";
-	response += nick;
-	response += " :Permission Denied- You're not an IRC operator\r\n";
-	
-	send(clientFd, response.c_str(), response.length(), 0);
-}
-
-// ERR_CANTKILLSERVER (483): You can't kill a server!
-void Server::sendERR_CANTKILLSERVER(const int &clientFd) {
-	std::string nick = this->Users[clientFd].getNickname();
-	
-	std::string response = ":";
-	response += SERVER_NAME;
-	response += " 483 ";
-	response += nick;
-	response += " :You can't kill a server!\r\n";
-	
-	send(clientFd, response.c_str(), response.length(), 0);
+	// Channel members see the kill as the victim's QUIT
+	disconnectUser(targetFd, path);
 }
 
 /*
@@ -199,7 +105,9 @@ void Server::sendERR_CANTKILLSERVER(const int &clientFd) {
 **  Format: KILL <nickname> <comment>
 **
 **  Action: Close client-server connection causing a QUIT.
+**          Shared channels see "QUIT :Killed (<oper> (<comment>))".
 **  Checks: Operator privileges required.
+**  See also: KLINE/DLINE (Kline.cpp) to keep the client out.
 **
 ** ============================================================================
 */
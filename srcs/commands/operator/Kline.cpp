@@ -0,0 +1,299 @@
+/* ************************************************************************** */
+/*                                                                          */
+/*                                                        :::      ::::::::   */
+/*   Kline.cpp                                          :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: adrien <adrien@student.42.fr>              +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/19 15:02:41 by adrien            #+#    #+#             */
+/*   Updated: 2026/10/20 11:43:27 by adrien           ###   ########.fr       */
+/*                                                                          */
+/* ************************************************************************** */
+
+#include "../../../includes/Server.hpp"
+#include "../../../includes/Utils.hpp"
+#include <sstream>
+
+/*
+* This function parses KLINE/DLINE and their UN- variants
+* @param cmdLength the length of the command
+* @param line the raw command line to parse
+* @return t_banrequest with the duration (minutes, 0 = permanent), mask and reason
+*/
+t_banrequest Server::parseBanCommand(int cmdLength, const std::string &line) {
+	t_banrequest request;
+	request.duration = 0;
+
+	std::string params = line.substr(cmdLength);
+	const size_t colon = params.find(" :");
+	if (colon != std::string::npos) {
+		request.reason = params.substr(colon + 2);
+		params.erase(colon);
+	}
+
+	std::istringstream iss(params);
+	std::string word;
+	if (!(iss >> word))
+		return request;
+	if (word.find_first_not_of("0123456789") == std::string::npos) {
+		request.duration = std::atol(word.c_str());
+		iss >> word;
+		if (iss.fail())
+			return request;
+	}
+	request.mask = word;
+
+	if (request.reason.empty())
+		request.reason = "No reason given";
+	return request;
+}
+
+/*
+* This function finds the K-line covering a registered client, matching
+* the mask against its IP and against its hostname or cloak
+* @param user the client
+* @return the ban, NULL if the client is not banned
+*/
+const t_ban *Server::findKline(const User &user) const {
+	const t_ban *ban = this->bans.findKline(user.getUsername(), user.getIp(), user.getAddr());
+	if (ban == NULL && user.getHost() != user.getIp())
+		ban = this->bans.findKline(user.getUsername(), user.getHost(), user.getAddr());
+	return ban;
+}
+
+/*
+* This function disconnects the clients covered by a new ban
+* @param ban the ban just added
+* @return void
+*/
+void Server::enforceBan(const t_ban &ban) {
+	for (std::map<int, User>::iterator it = this->Users.begin(); it != this->Users.end(); ++it) {
+		const User &user = it->second;
+		bool covered;
+		if (ban.type == BAN_DLINE)
+			covered = (this->bans.findDline(user.getAddr()) != NULL);
+		else
+			covered = user.getIsRegister()
+			          && findKline(user) != NULL;
+		if (!covered)
+			continue;
+		sendERR_YOUREBANNEDCREEP(it->first, ban.reason);
+		scheduleDisconnect(it->first, std::string(ban.type == BAN_DLINE ? "D" : "K")
+		                   + "-lined (" + ban.reason + ")");
+	}
+}
+
+/*
+* This function adds a K-line or D-line from an operator command
+* @param clientFd the operator file descriptor
+* @param type BAN_KLINE or BAN_DLINE
+* @param command the command name
+* @param line the line to parse
+* @return void
+*/
+void Server::addBan(const int &clientFd, char type, const std::string &command, const std::string &line) {
+	if (!this->Users[clientFd].isOperator()) {
+		sendERR_NOPRIVILEGES(clientFd);
+		return;
+	}
+
+	const t_banrequest request = parseBanCommand(command.length(), line);
+	if (request.mask.empty()) {
+		sendERR_NEEDMOREPARAMS(clientFd, command);
+		return;
+	}
+
+	t_ban ban;
+	ban.type = type;
+	ban.mask = request.mask;
+	ban.reason = request.reason;
+	ban.setter = this->Users[clientFd].getNickname();
+	ban.setAt = time(NULL);
+	ban.expires = request.duration ? ban.setAt + request.duration * 60 : 0;
+	if (!BanEngine::normalize(ban)) {
+		sendNotice(clientFd, "Invalid " + command + " mask: " + request.mask);
+		return;
+	}
+
+	if (!this->bans.add(ban)) {
+		sendNotice(clientFd, "[" + ban.mask + "] already " + command + "d");
+		return;
+	}
+	saveBans();
+
+	const std::string duration = request.duration
+		? "temporary " + toString(request.duration) + " min. " : "";
+	sendNotice(clientFd, "Added " + duration + command + " [" + ban.mask + "]");
+	sendServerNotice(ban.setter + " added " + duration + command + " for [" + ban.mask
+	                 + "] [" + ban.reason + "]");
+	enforceBan(ban);
+}
+
+/*
+* This function removes a K-line or D-line from an operator command
+* @param clientFd the operator file descriptor
+* @param type BAN_KLINE or BAN_DLINE
+* @param command the command name
+* @param line the line to parse
+* @return void
+*/
+void Server::removeBan(const int &clientFd, char type, const std::string &command, const std::string &line) {
+	if (!this->Users[clientFd].isOperator()) {
+		sendERR_NOPRIVILEGES(clientFd);
+		return;
+	}
+
+	t_ban ban;
+	ban.type = type;
+	ban.mask = getParam(command.length(), line);
+	if (ban.mask.empty()) {
+		sendERR_NEEDMOREPARAMS(clientFd, command);
+		return;
+	}
+
+	const std::string given = ban.mask;
+	if (!BanEngine::normalize(ban) || !this->bans.remove(type, ban.mask)) {
+		sendNotice(clientFd, "No " + command.substr(2) + " for [" + given + "]");
+		return;
+	}
+	saveBans();
+
+	sendNotice(clientFd, command.substr(2) + " for [" + ban.mask + "] is removed");
+	sendServerNotice(this->Users[clientFd].getNickname() + " has removed the "
+	                 + command.substr(2) + " for [" + ban.mask + "]");
+}
+
+/*
+* this fonction will handle the KLINE command
+* @param clientFd the client file descriptor
+* @param line the line to parse
+* @return void
+*/
+void Server::handleKline(const int &clientFd, const std::string &line) {
+	addBan(clientFd, BAN_KLINE, CMD_KLINE, line);
+}
+
+/*
+* this fonction will handle the DLINE command
+* @param clientFd the client file descriptor
+* @param line the line to parse
+* @return void
+*/
+void Server::handleDline(const int &clientFd, const std::string &line) {
+	addBan(clientFd, BAN_DLINE, CMD_DLINE, line);
+}
+
+/*
+* this fonction will handle the UNKLINE command
+* @param clientFd the client file descriptor
+* @param line the line to parse
+* @return void
+*/
+void Server::handleUnkline(const int &clientFd, const std::string &line) {
+	removeBan(clientFd, BAN_KLINE, CMD_UNKLINE, line);
+}
+
+/*
+* this fonction will handle the UNDLINE command
+* @param clientFd the client file descriptor
+* @param line the line to parse
+* @return void
+*/
+void Server::handleUndline(const int &clientFd, const std::string &line) {
+	removeBan(clientFd, BAN_DLINE, CMD_UNDLINE, line);
+}
+
+/*
+* This function (re)loads the bans file, only the differences are applied
+* @return false if the file could not be read
+*/
+bool Server::loadBans() {
+	size_t added;
+	size_t removed;
+
+	this->bansPath = this->config.get("bans_file", BANS_FILE);
+	if (!this->bans.load(this->bansPath, added, removed))
+		return false;
+
+	std::cout << "[IRC] Bans loaded from " << this->bansPath << ": " << added << " added, "
+	          << removed << " removed, " << this->bans.size() << " active" << std::endl;
+	return true;
+}
+
+/*
+* This function writes the bans file
+* @return void
+*/
+void Server::saveBans() {
+	if (!this->bans.save(this->bansPath))
+		std::cerr << "[IRC] Failed to write " << this->bansPath << std::endl;
+}
+
+/*
+* This function removes the expired bans, called once per second
+* @param now the current time
+* @return void
+*/
+void Server::expireBans(time_t now) {
+	std::vector<t_ban> expired;
+
+	this->bans.expire(now, expired);
+	if (expired.empty())
+		return;
+
+	for (size_t i = 0; i < expired.size(); i++)
+		sendServerNotice(std::string("Temporary ") + expired[i].type + "-line for ["
+		                 + expired[i].mask + "] expired");
+	saveBans();
+}
+
+/*
+* This function sends the K-lines (RPL_STATSKLINE 216) or D-lines
+* (RPL_STATSDLINE 225) for STATS k / STATS d
+* @param clientFd the client file descriptor
+* @param type BAN_KLINE or BAN_DLINE
+* @return void
+*/
+void Server::sendStatsBans(const int &clientFd, char type) {
+	std::vector<t_ban> list;
+	const time_t now = time(NULL);
+
+	this->bans.list(type, list);
+	for (size_t i = 0; i < list.size(); i++) {
+		std::ostringstream oss;
+		if (type == BAN_KLINE) {
+			const size_t at = list[i].mask.find('@');
+			oss << "K " << list[i].mask.substr(at + 1) << " * " << list[i].mask.substr(0, at);
+		} else {
+			oss << "D " << list[i].mask;
+		}
+		std::string reason = list[i].reason;
+		if (list[i].expires)
+			reason += " (" + toString((list[i].expires - now + 59) / 60) + " min. left)";
+		sendNumericReply(clientFd, type == BAN_KLINE ? RPL_STATSKLINE : RPL_STATSDLINE,
+		                 oss.str(), reason);
+	}
+}
+
+/*
+** ============================================================================
+**                       KLINE / DLINE COMMANDS
+** ============================================================================
+**
+**  Format: KLINE [minutes] <user@host> :<reason>
+**          DLINE [minutes] <ip[/bits]> :<reason>
+**          UNKLINE <user@host>
+**          UNDLINE <ip[/bits]>
+**
+**  Action: Ban clients from the server. D-lines are checked at accept,
+**          K-lines when a client registers; matching clients already
+**          connected are disconnected. Without a duration the ban is
+**          permanent. Bans are saved to the bans file (bans_file in
+**          server.conf) and reloaded by REHASH.
+**  Checks: Operator privileges required.
+**  Replies: NOTICE to the operator, server notice to +s operators,
+**           ERR_YOUREBANNEDCREEP (465) to the banned clients.
+**  Listing: STATS k, STATS d.
+**
+** ============================================================================
+*/
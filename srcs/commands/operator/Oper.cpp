@@ -6,7 +6,7 @@
 /*   By: hdelacou <hdelacou@student.42.fr>          +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/12/16 03:57:53 by hdelacou          #+#    #+#             */
-/*   Updated: 2025/12/16 06:31:11 by hdelacou         ###   ########.fr       */
+/*   Updated: 2026/10/19 15:52:09 by adrien           ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -18,11 +18,6 @@
 * @param line the raw command line to parse
 * @return OperParams struct containing username and password
 */
-struct OperParams {
-	std::string username;
-	std::string password;
-};
-
 OperParams Server::parseOperCommand(const std::string &line) {
 	OperParams params;
 	
@@ -61,19 +56,17 @@ OperParams Server::parseOperCommand(const std::string &line) {
 
 /*
 * This function validates the OPER credentials
-* TODO: Load from config file
+* Credentials come from oper_user / oper_pass in the configuration file
 * @param username the username to validate
 * @param password the password to validate
 * @return true if credentials are valid, false otherwise
 */
 bool Server::validateOperCredentials(const std::string &username, 
                                       const std::string &password) {
-	// TODO: Load from configuration file
-	// For now, hardcoded credentials for testing
-	const std::string OPER_USER = "admin";
-	const std::string OPER_PASS = "operpass";
+	const std::string operUser = this->config.get("oper_user", "admin");
+	const std::string operPass = this->config.get("oper_pass", "operpass");
 
-	return (username == OPER_USER && password == OPER_PASS);
+	return (username == operUser && password == operPass);
 }
 
 /*
@@ -90,12 +83,19 @@ void Server::handleOper(const int &clientFd, const std::string &line) {
 		return;
 	}
 
-	if (!validateOperCredentials(params.username, params.password)) {
+	// A locked account is refused without looking at the password
+	if (isAccountLocked(params.username, time(NULL))
+		|| !validateOperCredentials(params.username, params.password)) {
 		sendERR_PASSWDMISMATCH(clientFd);
+		authFailed(clientFd, params.username);
 		return;
 	}
+	authSucceeded(clientFd, params.username);
 
+	if (!this->Users[clientFd].isOperator())
+		this->lusers.opers++;
 	this->Users[clientFd].setOperator(true);
+	this->Users[clientFd].setServerNotices(true);
 
 	sendRPL_YOUREOPER(clientFd);
 
@@ -103,60 +103,13 @@ void Server::handleOper(const int &clientFd, const std::string &line) {
 	modeMsg += this->Users[clientFd].getNickname();
 	modeMsg += " MODE ";
 	modeMsg += this->Users[clientFd].getNickname();
-	modeMsg += " :+o\r\n";
-	send(clientFd, modeMsg.c_str(), modeMsg.length(), 0);
+	modeMsg += " :+os\r\n";
+	sendToClient(clientFd, modeMsg);
 
 	std::cout << "User " << this->Users[clientFd].getNickname() 
 	          << " (fd: " << clientFd << ") is now an IRC Operator" << std::endl;
 }
 
-/*
-* Response Functions for OPER command
-*/
-
-// RPL_YOUREOPER (381): You are now an IRC operator
-void Server::sendRPL_YOUREOPER(const int &clientFd) {
-	std::string nick = this->Users[clientFd].getNickname();
-	
-	std::string response = ":";
-	response += SERVER_NAME;
-	response += " 381 ";
-	response += nick;
-	response += " :You are now an IRC operator\r\n";
-	
-	send(clientFd, response.c_str(), response.length(), 0);
-}
-
-// ERR_PASSWDMISMATCH (464): Password incorrect
-void Server::sendERR_PASSWDMISMATCH(const int &clientFd) {
-	std::string nick = this->Users[clientFd].getNickname();
-	if (nick.empty())
-		nick = "*";
-	
-	std::string response = ":";
-	response += SERVER_NAME;
-	response += " 464 ";
-	response += nick;
-	response += " :Password incorrect\r\n";
-	
-	send(clientFd, response.c_str(), response.length(), 0);
-}
-
-// ERR_NOOPERHOST (491): No O-lines for your host
-void Server::sendERR_NOOPERHOST(const int &clientFd) {
-	std::string nick = this->Users[clientFd].getNickname();
-	if (nick.empty())
-		nick = "*";
-	
-	std::string response = ":";
-	response += SERVER_NAME;
-	response += " 491 ";
-	response += nick;
-	response += " :No O-lines for your host\r\n";
-	
-	send(clientFd, response.c_str(), response.length(), 0);
-}
-
 /*
 ** ============================================================================
 **                           OPER COMMAND
@@ -164,8 +117,10 @@ void Server::sendERR_NOOPERHOST(const int &clientFd) {
 **
 **  Format: OPER <user> <password>
 **
-**  Action: Obtains operator privileges (IRCOP).
+**  Action: Obtains operator privileges (IRCOP) and server notices (+s).
 **  Reply: RPL_YOUREOPER (381).
+**  Lockout: failures hold the client input with an exponential backoff,
+**           too many in a row lock the account (see AuthLockout.cpp).
 **
 ** ============================================================================
 */
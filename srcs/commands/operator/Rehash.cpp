@@ -6,45 +6,31 @@
 /*   By: hdelacou <hdelacou@student.42.fr>          +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/12/16 03:58:34 by hdelacou          #+#    #+#             */
-/*   Updated: 2025/12/16 06:31:13 by hdelacou         ###   ########.fr       */
+/*   Updated: 2026/10/19 15:26:03 by adrien           ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
 
 #include "../../../includes/Server.hpp"
 #include "../../../includes/Utils.hpp"
-#include <fstream>
 
 /*
-* This function reloads the server configuration
+* This function reloads the server configuration and the bans file
+* The configuration is applied again (watchdog, penalties, classes),
+* the bans are diffed against the ones in memory
 * @return true on success, false on failure
 */
 bool Server::reloadConfiguration() {
-	// TODO: Implement actual config file reading
-	// For now, this is a placeholder
-	
 	std::cout << "Reloading configuration..." << std::endl;
-	
-	// Example: Read from "server.conf"
-	std::ifstream configFile("server.conf");
-	if (!configFile.is_open()) {
-		std::cout << "Warning: server.conf not found" << std::endl;
-		return false;
-	}
 
-	// Parse configuration
-	std::string line;
-	while (std::getline(configFile, line)) {
-		// Skip comments and empty lines
-		if (line.empty() || line[0] == '#')
-			continue;
-			
-		// TODO: Parse configuration directives
-		// Example: oper_user = admin
-		//          oper_pass = secretpass
+	if (!this->config.reload()) {
+		std::cout << "Warning: " << this->config.getPath() << " not found" << std::endl;
+		return false;
 	}
+	loadConfig();
+	if (!loadBans())
+		std::cout << "Warning: " << this->bansPath << " not found, bans kept" << std::endl;
 
-	configFile.close();
 	std::cout << "Configuration reloaded successfully" << std::endl;
 	return true;
 }
@@ -66,37 +52,15 @@ void Server::handleRehash(const int &clientFd, const std::string &line) {
 	std::cout << "IRCOP " << this->Users[clientFd].getNickname() 
 	          << " (fd: " << clientFd << ") initiated REHASH" << std::endl;
 
-	bool success = reloadConfiguration();
-
-	if (success) {
-		sendRPL_REHASHING(clientFd);
+	sendRPL_REHASHING(clientFd);
+	if (reloadConfiguration()) {
+		sendServerNotice(this->Users[clientFd].getNickname() + " is rehashing server config file ("
+		                 + toString(this->bans.size()) + " bans)");
 	} else {
-		std::string response = ":";
-		response += SERVER_NAME;
-		response += " NOTICE ";
-		response += this->Users[clientFd].getNickname();
-		response += " :Error reloading configuration file\r\n";
-		send(clientFd, response.c_str(), response.length(), 0);
+		sendNotice(clientFd, "Error reloading configuration file");
 	}
 }
 
-/*
-* Response Functions for REHASH command
-* @param clientFd the client file descriptor
-* @return void
-*/
-void Server::sendRPL_REHASHING(const int &clientFd) {
-	std::string nick = this->Users[clientFd].getNickname();
-	
-	std::string response = ":";
-	response += SERVER_NAME;
-	response += " 382 ";
-	response += nick;
-	response += " server.conf :Rehashing\r\n";
-	
-	send(clientFd, response.c_str(), response.length(), 0);
-}
-
 /*
 ** ============================================================================
 **                           REHASH COMMAND
@@ -104,7 +68,9 @@ void Server::sendRPL_REHASHING(const int &clientFd) {
 **
 **  Format: REHASH
 **
-**  Action: Reloads server configuration files.
+**  Action: Reloads server.conf and the bans file. Only the bans that
+**          changed in the file are added to or removed from the ban
+**          indexes; connection classes are rebuilt.
 **  Checks: Requires operator privileges.
 **
 ** ============================================================================
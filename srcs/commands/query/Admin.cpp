@@ -6,12 +6,24 @@
 /*   By: hdelacou <hdelacou@student.42.fr>          +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/12/16 03:59:16 by hdelacou          #+#    #+#             */
-/*   Updated: 2025/12/16 06:31:44 by hdelacou         ###   ########.fr       */
+/*   Updated: 2026/10/19 19:04:26 by adrien           ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
 #include "../../../includes/Server.hpp"
-#include "../../../includes/Utils.hpp"
+
+/*
+* This function renders the RPL_ADMINME (256) to RPL_ADMINEMAIL (259)
+* lines from the admin_* settings of server.conf
+* @param reply the reply to fill
+* @return void
+*/
+void Server::renderAdmin(StaticReply &reply) const {
+	reply.addLine(RPL_ADMINME, SERVER_NAME, "Administrative info");
+	reply.addLine(RPL_ADMINLOC1, "", this->config.get("admin_location", ADMIN_LOCATION));
+	reply.addLine(RPL_ADMINLOC2, "", this->config.get("admin_location2", SERVER_NAME " " SERVER_VERSION));
+	reply.addLine(RPL_ADMINEMAIL, "", this->config.get("admin_email", ADMIN_EMAIL));
+}
 
 /*
 * this fonction will handle the ADMIN command
@@ -20,8 +32,8 @@
 * @return void
 */
 void Server::handleAdmin(const int &clientFd, const std::string &line) {
-	(void)clientFd;
-	(void)line;
+	if (isLocalServerTarget(clientFd, line))
+		sendStaticReply(clientFd, this->adminReply);
 }
 
 /*
@@ -32,7 +44,8 @@ void Server::handleAdmin(const int &clientFd, const std::string &line) {
 **  Format: ADMIN [server]
 **
 **  Action: Returns administrative info about the server.
-**  Replies: RPL_ADMINME, RPL_ADMINLOC1, RPL_ADMINLOC2, RPL_ADMINEMAIL.
+**  Replies: RPL_ADMINME, RPL_ADMINLOC1, RPL_ADMINLOC2, RPL_ADMINEMAIL,
+**           rendered once at startup and on REHASH.
 **
 ** ============================================================================
 */
@@ -6,12 +6,36 @@
 /*   By: hdelacou <hdelacou@student.42.fr>          +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/12/16 03:59:59 by hdelacou          #+#    #+#             */
-/*   Updated: 2025/12/16 06:31:53 by hdelacou         ###   ########.fr       */
+/*   Updated: 2026/10/19 19:04:26 by adrien           ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
 #include "../../../includes/Server.hpp"
-#include "../../../includes/Utils.hpp"
+
+static const char *infoLines[] = {
+	SERVER_NAME " " SERVER_VERSION,
+	"",
+	"An RFC 1459 IRC server written in C++98 around a single",
+	"epoll loop, as a 42 school project.",
+	"",
+	"Authors: hdelacou, adrien",
+	NULL
+};
+
+/*
+* This function renders the RPL_INFO (371) lines and RPL_ENDOFINFO (374)
+* @param reply the reply to fill
+* @return void
+*/
+void Server::renderInfo(StaticReply &reply) const {
+	char started[64];
+	strftime(started, sizeof(started), "%a %b %d %Y at %H:%M:%S UTC", gmtime(&this->startTime));
+
+	for (size_t i = 0; infoLines[i]; i++)
+		reply.addLine(RPL_INFO, "", infoLines[i][0] ? infoLines[i] : " ");
+	reply.addLine(RPL_INFO, "", std::string("On-line since ") + started);
+	reply.addLine(RPL_ENDOFINFO, "", MSG_RPL_ENDOFINFO);
+}
 
 /*
 * this fonction will handle the INFO command
@@ -20,8 +44,8 @@
 * @return void
 */
 void Server::handleInfo(const int &clientFd, const std::string &line) {
-	(void)clientFd;
-	(void)line;
+	if (isLocalServerTarget(clientFd, line))
+		sendStaticReply(clientFd, this->infoReply);
 }
 
 /*
@@ -32,7 +56,8 @@ void Server::handleInfo(const int &clientFd, const std::string &line) {
 **  Format: INFO [server]
 **
 **  Action: Returns information describing the server.
-**  Replies: RPL_INFO (371), RPL_ENDOFINFO (374).
+**  Replies: RPL_INFO (371), RPL_ENDOFINFO (374), rendered once at
+**           startup and on REHASH.
 **
 ** ============================================================================
 */
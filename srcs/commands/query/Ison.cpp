@@ -6,22 +6,58 @@
 /*   By: hdelacou <hdelacou@student.42.fr>          +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/12/16 04:00:06 by hdelacou          #+#    #+#             */
-/*   Updated: 2025/12/16 06:31:55 by hdelacou         ###   ########.fr       */
+/*   Updated: 2026/10/20 11:24:39 by adrien           ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
 #include "../../../includes/Server.hpp"
-#include "../../../includes/Utils.hpp"
 
 /*
 * this fonction will handle the ISON command
+* Every nick is looked up in the nick index in place, the online ones
+* are copied into 303 lines (a new line when one is full) gathered in
+* one buffer and sent with a single write
 * @param clientFd the client file descriptor
 * @param line the line to parse
 * @return void
 */
 void Server::handleIson(const int &clientFd, const std::string &line) {
-	(void)clientFd;
-	(void)line;
+	static const char separators[] = " :";
+	size_t pos = line.find(' ');
+
+	if (pos == std::string::npos || line.find_first_not_of(separators, pos) == std::string::npos) {
+		sendERR_NEEDMOREPARAMS(clientFd, "ISON");
+		return;
+	}
+
+	const std::string &nick = this->Users[clientFd].getNickname();
+	ReplyBuilder reply;
+	reply.start(RPL_ISON, nick).append(separators, 2);
+	const size_t empty = reply.length();
+
+	this->lookupReply.clear();
+	while ((pos = line.find_first_not_of(separators, pos)) != std::string::npos) {
+		size_t end = line.find(' ', pos);
+		if (end == std::string::npos)
+			end = line.length();
+		const User *user = findOnlineUser(line.data() + pos, end - pos);
+		pos = end;
+		if (!user)
+			continue;
+
+		const std::string &online = user->getNickname();
+		if (reply.length() + 1 + online.length() > REPLY_MAX_BODY) {
+			reply.finish();
+			this->lookupReply.append(reply.data(), reply.size());
+			reply.start(RPL_ISON, nick).append(separators, 2);
+		}
+		if (reply.length() > empty)
+			reply.append(" ", 1);
+		reply.append(online);
+	}
+	reply.finish();
+	this->lookupReply.append(reply.data(), reply.size());
+	sendToClient(clientFd, this->lookupReply);
 }
 
 /*
@@ -32,7 +68,9 @@ void Server::handleIson(const int &clientFd, const std::string &line) {
 **  Format: ISON <nick1> [nick2] ...
 **
 **  Action: Checks if users are currently online.
-**  Replies: RPL_ISON (303) with list of online nicks.
+**  Replies: RPL_ISON (303) with list of online nicks, split over several
+**           lines when they do not fit in one.
+**  Cost: penalty_lookup_usec of fake lag per nick asked about.
 **
 ** ============================================================================
 */
@@ -6,91 +6,179 @@
 /*   By: hdelacou <hdelacou@student.42.fr>          +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/12/16 04:03:12 by hdelacou          #+#    #+#             */
-/*   Updated: 2025/12/16 06:32:23 by hdelacou         ###   ########.fr       */
+/*   Updated: 2026/10/19 20:17:45 by adrien           ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
 #include "../../../includes/Server.hpp"
-#include "../../../includes/Utils.hpp"
-#include "../../../includes/IrcReplies.hpp"
+#include <sstream>
+#include <cstdlib>
+#include <algorithm>
+#include <strings.h>
 
 /*
-* This function parses the LIST command
-* @param line the raw command line to parse
-* @return vector of channel names
+* This function reads one ELIST filter of a LIST command into a cursor
+* ">N" / "<N" bound the member count, "C<N" / "C>N" the creation time
+* and "T<N" / "T>N" the topic time in minutes ago, "!mask" hides the
+* matching channels, a mask or a plain name selects them
+* @param filter one comma separated item
+* @param cursor the listing to fill
+* @return void
 */
-std::vector<std::string> Server::parseListCommand(const std::string &line) {
-	std::vector<std::string> channels;
-	
-	size_t pos = line.find(' ');
-	if (pos == std::string::npos)
-		return channels; // No channels specified
-	
-	std::string channelList = line.substr(pos + 1);
-	
-	// Remove trailing CR/LF
-	if (!channelList.empty() && channelList[channelList.length() - 1] == '\r')
-		channelList.erase(channelList.length() - 1);
-	if (!channelList.empty() && channelList[channelList.length() - 1] == '\n')
-		channelList.erase(channelList.length() - 1);
-	
-	// Parse comma-separated channels
-	std::istringstream iss(channelList);
-	std::string chan;
-	while (std::getline(iss, chan, ',')) {
-		if (!chan.empty())
-			channels.push_back(chan);
+void Server::parseListFilter(const std::string &filter, t_listcursor &cursor) const {
+	if (filter.empty())
+		return;
+
+	char kind = 0;
+	size_t pos = 0;
+	if ((filter[0] == 'C' || filter[0] == 'T') && filter.size() > 1
+		&& (filter[1] == '<' || filter[1] == '>'))
+		kind = filter[pos++];
+	if (filter[pos] == '<' || filter[pos] == '>') {
+		char op = filter[pos];
+		unsigned long value = std::strtoul(filter.c_str() + pos + 1, NULL, 10);
+		if (kind == 0 && op == '>')
+			cursor.minMembers = std::max(cursor.minMembers, static_cast<size_t>(value) + 1);
+		else if (kind == 0)
+			cursor.maxMembers = std::min(cursor.maxMembers, value ? static_cast<size_t>(value) - 1 : 0);
+		else {
+			// "<N": less than N minutes ago, "> N": more than N minutes ago
+			time_t when = time(NULL) - static_cast<time_t>(value) * 60;
+			time_t &after = (kind == 'C') ? cursor.createdAfter : cursor.topicAfter;
+			time_t &before = (kind == 'C') ? cursor.createdBefore : cursor.topicBefore;
+			if (op == '<')
+				after = std::max(after, when);
+			else if (before == 0 || when < before)
+				before = when;
+		}
+		return;
 	}
-	
-	return channels;
+	if (filter[0] == '!' && filter.size() > 1)
+		cursor.notMasks.push_back(GlobMask(filter.substr(1)));
+	else if (filter.find_first_of("*?") != std::string::npos)
+		cursor.masks.push_back(GlobMask(filter));
+	else
+		cursor.names.push_back(filter);
 }
 
 /*
-* This function sends RPL_LIST (322) for one channel
-* @param clientFd the client file descriptor
-* @param channel the channel to send info for
-* @return void
+* This function checks a channel against the filters of a listing
+* The member bounds are checked by the caller, which walks the index in
+* member order
+* @param cursor the listing
+* @param key the channel position in the index
+* @param topic what the index knows about its topic
+* @return true if the channel is to be listed
 */
-void Server::sendRPL_LIST(const int &clientFd, Channel &channel) {
-	std::string nick = this->Users[clientFd].getNickname();
-	std::string chanName = channel.getName();
-	
-	// Count visible users
-	size_t userCount = channel.getMembers().size();
-	
-	// Get topic
-	std::string topic = channel.getTopic();
-	if (topic.empty())
-		topic = "No topic is set";
-	
-	// Build response
-	std::string response = ":" + std::string(SERVER_NAME);
-	response += " 322 " + nick +   + chanName +  ;
-	
-	// Add user count
-	std::ostringstream oss;
-	oss << userCount;
-	response += oss.str();
-	
-	response +=  : + topic + "
-";
-	
-	send(clientFd, response.c_str(), response.length(), 0);
+bool Server::listMatches(const t_listcursor &cursor, const t_listkey &key, const t_listtopic &topic) const {
+	if (key.members < cursor.minMembers || key.members > cursor.maxMembers)
+		return false;
+	if (cursor.createdAfter && key.created < cursor.createdAfter)
+		return false;
+	if (cursor.createdBefore && key.created > cursor.createdBefore)
+		return false;
+	if (cursor.topicAfter || cursor.topicBefore) {
+		if (topic.topicTime == 0)
+			return false;
+		if (cursor.topicAfter && topic.topicTime < cursor.topicAfter)
+			return false;
+		if (cursor.topicBefore && topic.topicTime > cursor.topicBefore)
+			return false;
+	}
+	for (size_t i = 0; i < cursor.notMasks.size(); i++)
+		if (cursor.notMasks[i].match(key.name))
+			return false;
+	if (cursor.masks.empty() && cursor.names.empty())
+		return true;
+	for (size_t i = 0; i < cursor.masks.size(); i++)
+		if (cursor.masks[i].match(key.name))
+			return true;
+	return std::find(cursor.names.begin(), cursor.names.end(), key.name) != cursor.names.end();
 }
 
 /*
-* This function sends RPL_LISTEND (323) to signal end of LIST
+* This function sends the next batch of a listing
+* At most LIST_BATCH lines are sent and LIST_SCAN index entries looked
+* at, the cursor then remembers the last entry so the next call resumes
+* right after it whatever happened to the channels in between
 * @param clientFd the client file descriptor
-* @return void
+* @param cursor the listing
+* @return true once RPL_LISTEND was sent
 */
-void Server::sendRPL_LISTEND(const int &clientFd) {
-	std::string nick = this->Users[clientFd].getNickname();
-	
-	std::string response = ":" + std::string(SERVER_NAME);
-	response +=  323  + nick;
-	response +=  :End of /LIST\r\n;
-	
-	send(clientFd, response.c_str(), response.length(), 0);
+bool Server::continueListing(const int &clientFd, t_listcursor &cursor) {
+	size_t sent = 0;
+
+	// Channels asked by name only: no need to walk the index
+	if (!cursor.names.empty() && cursor.masks.empty()) {
+		while (cursor.nextName < cursor.names.size() && sent < LIST_BATCH) {
+			ChannelIndex::const_iterator it = this->listIndex.find(cursor.names[cursor.nextName++]);
+			if (it == this->listIndex.end())
+				continue;
+			if (listMatches(cursor, it->first, it->second)) {
+				sendRPL_LIST(clientFd, it->first.name, it->first.members, it->second.topic);
+				sent++;
+			}
+		}
+		if (cursor.nextName < cursor.names.size())
+			return false;
+		sendRPL_LISTEND(clientFd);
+		return true;
+	}
+
+	ChannelIndex::const_iterator it;
+	if (cursor.started)
+		it = this->listIndex.after(cursor.last);
+	else if (cursor.maxMembers != static_cast<size_t>(-1))
+		it = this->listIndex.atMost(cursor.maxMembers);
+	else
+		it = this->listIndex.begin();
+
+	size_t scanned = 0;
+	for (; it != this->listIndex.end(); ++it) {
+		if (it->first.members < cursor.minMembers)
+			break;
+		if (sent >= LIST_BATCH || scanned >= LIST_SCAN)
+			return false;
+		cursor.last = it->first;
+		cursor.started = true;
+		scanned++;
+		if (listMatches(cursor, it->first, it->second)) {
+			sendRPL_LIST(clientFd, it->first.name, it->first.members, it->second.topic);
+			sent++;
+		}
+	}
+	sendRPL_LISTEND(clientFd);
+	return true;
+}
+
+/*
+* This function moves every listing in progress one batch forward
+* A listing waits while its client SendQ holds more than a share of what
+* its class allows, so a slow reader is never disconnected by its LIST
+* @return true if a listing still has something to send right away
+*/
+bool Server::continueListings() {
+	bool pending = false;
+	std::map<int, t_listcursor>::iterator it = this->listCursors.begin();
+
+	while (it != this->listCursors.end()) {
+		std::map<int, User>::iterator user = this->Users.find(it->first);
+		if (user == this->Users.end() || this->pendingDisconnect.count(it->first)) {
+			this->listCursors.erase(it++);
+			continue;
+		}
+		if (user->second.getSendQueueSize() >= getClass(user->second).sendq / LIST_SENDQ_SHARE) {
+			++it;
+			continue;
+		}
+		if (continueListing(it->first, it->second))
+			this->listCursors.erase(it++);
+		else {
+			pending = true;
+			++it;
+		}
+	}
+	return pending;
 }
 
 /*
@@ -100,26 +188,43 @@ void Server::sendRPL_LISTEND(const int &clientFd) {
 * @return void
 */
 void Server::handleList(const int &clientFd, const std::string &line) {
-	std::vector<std::string> requestedChannels = parseListCommand(line);
-	
-	if (requestedChannels.empty()) {
-		for (std::vector<Channel>::iterator chan = channelList.begin(); 
-		     chan != channelList.end(); ++chan) {
-			sendRPL_LIST(clientFd, *chan);
-		}
-	} else {
-		for (size_t i = 0; i < requestedChannels.size(); i++) {
-			for (std::vector<Channel>::iterator chan = channelList.begin(); 
-			     chan != channelList.end(); ++chan) {
-				if (chan->getName() == requestedChannels[i]) {
-					sendRPL_LIST(clientFd, *chan);
-					break;
-				}
-			}
-		}
+	std::istringstream iss(line);
+	std::string command;
+	std::string filters;
+	std::string target;
+
+	iss >> command >> filters >> target;
+	if (!filters.empty() && filters[0] == ':')
+		filters.erase(0, 1);
+	if (!target.empty() && target[0] == ':')
+		target.erase(0, 1);
+	if (!target.empty() && strcasecmp(target.c_str(), SERVER_NAME) != 0) {
+		sendERR_NOSUCHSERVER(clientFd, target);
+		return;
 	}
-	
-	sendRPL_LISTEND(clientFd);
+
+	// A new LIST replaces the one still streaming
+	t_listcursor &cursor = this->listCursors[clientFd];
+	cursor.minMembers = 0;
+	cursor.maxMembers = static_cast<size_t>(-1);
+	cursor.createdAfter = 0;
+	cursor.createdBefore = 0;
+	cursor.topicAfter = 0;
+	cursor.topicBefore = 0;
+	cursor.masks.clear();
+	cursor.notMasks.clear();
+	cursor.names.clear();
+	cursor.nextName = 0;
+	cursor.started = false;
+
+	std::istringstream list(filters);
+	std::string filter;
+	while (std::getline(list, filter, ','))
+		parseListFilter(filter, cursor);
+
+	sendRPL_LISTSTART(clientFd);
+	if (continueListing(clientFd, cursor))
+		this->listCursors.erase(clientFd);
 }
 
 /*
@@ -127,10 +232,16 @@ void Server::handleList(const int &clientFd, const std::string &line) {
 **                           LIST COMMAND
 ** ============================================================================
 **
-**  Format: LIST [channel(s)]
+**  Format: LIST [filter{,filter}] [server]
 **
-**  Action: Lists channels and their topics.
-**  Replies: RPL_LIST (322), RPL_LISTEND (323).
+**  Action: Lists channels and their topics, most populated first.
+**  Filters (ELIST=CMNTU): >N / <N members, C<N / C>N created less / more
+**          than N minutes ago, T<N / T>N same for the topic, mask,
+**          !mask, exact channel names.
+**  Replies: RPL_LISTSTART (321), RPL_LIST (322), RPL_LISTEND (323).
+**  Note: Streamed from the channel index in batches of LIST_BATCH lines
+**        from the main loop, paused while the SendQ is filling up; the
+**        cursor resumes after the last channel it went through.
 **
 ** ============================================================================
 */
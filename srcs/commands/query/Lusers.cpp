@@ -0,0 +1,105 @@
+/* ************************************************************************** */
+/*                                                                          */
+/*                                                        :::      ::::::::   */
+/*   Lusers.cpp                                         :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: adrien <adrien@student.42.fr>              +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/19 10:41:52 by adrien            #+#    #+#             */
+/*   Updated: 2026/10/19 10:41:52 by adrien           ###   ########.fr       */
+/*                                                                          */
+/* ************************************************************************** */
+
+#include "../../../includes/Server.hpp"
+#include "../../../includes/Utils.hpp"
+#include "../../../includes/IrcReplies.hpp"
+#include <sstream>
+
+/*
+* This function sends RPL_LOCALUSERS (265) and RPL_GLOBALUSERS (266)
+* Single server: the global counters are the local ones
+* @param clientFd the client file descriptor
+* @return void
+*/
+void Server::sendLocalGlobalUsers(const int &clientFd) {
+	std::ostringstream local;
+	local << this->lusers.registered << " " << this->lusers.localMax;
+	std::ostringstream localMsg;
+	localMsg << "Current local users " << this->lusers.registered
+	         << ", max " << this->lusers.localMax;
+	sendNumericReply(clientFd, RPL_LOCALUSERS, local.str(), localMsg.str());
+
+	std::ostringstream global;
+	global << this->lusers.registered << " " << this->lusers.globalMax;
+	std::ostringstream globalMsg;
+	globalMsg << "Current global users " << this->lusers.registered
+	          << ", max " << this->lusers.globalMax;
+	sendNumericReply(clientFd, RPL_GLOBALUSERS, global.str(), globalMsg.str());
+}
+
+/*
+* This function sends the LUSERS replies (251-255, 265, 266)
+* Every value comes from the counters, no user or channel is scanned
+* @param clientFd the client file descriptor
+* @return void
+*/
+void Server::sendLusers(const int &clientFd) {
+	std::ostringstream client;
+	client << "There are " << this->lusers.registered - this->lusers.invisible
+	       << " users and " << this->lusers.invisible << " invisible on 1 servers";
+	sendNumericReply(clientFd, RPL_LUSERCLIENT, "", client.str());
+
+	if (this->lusers.opers > 0) {
+		std::ostringstream opers;
+		opers << this->lusers.opers;
+		sendNumericReply(clientFd, RPL_LUSEROP, opers.str(), MSG_RPL_LUSEROP);
+	}
+
+	if (this->lusers.unknown > 0) {
+		std::ostringstream unknown;
+		unknown << this->lusers.unknown;
+		sendNumericReply(clientFd, RPL_LUSERUNKNOWN, unknown.str(), MSG_RPL_LUSERUNKNOWN);
+	}
+
+	if (this->lusers.channels > 0) {
+		std::ostringstream channels;
+		channels << this->lusers.channels;
+		sendNumericReply(clientFd, RPL_LUSERCHANNELS, channels.str(), MSG_RPL_LUSERCHANNELS);
+	}
+
+	std::ostringstream me;
+	me << "I have " << this->lusers.registered + this->lusers.unknown
+	   << " clients and 0 servers";
+	sendNumericReply(clientFd, RPL_LUSERME, "", me.str());
+
+	sendLocalGlobalUsers(clientFd);
+}
+
+/*
+* this fonction will handle the LUSERS command
+* @param clientFd the client file descriptor
+* @param line the line to parse
+* @return void
+*/
+void Server::handleLusers(const int &clientFd, const std::string &line) {
+	// Single server: the mask and server parameters select nothing else
+	(void)line;
+	sendLusers(clientFd);
+}
+
+/*
+** ============================================================================
+**                           LUSERS COMMAND
+** ============================================================================
+**
+**  Format: LUSERS [mask [server]]
+**
+**  Action: Returns statistics about the size of the network.
+**  Replies: LUSERCLIENT (251), LUSEROP (252), LUSERUNKNOWN (253),
+**           LUSERCHANNELS (254), LUSERME (255), LOCALUSERS (265),
+**           GLOBALUSERS (266).
+**  Cost: O(1), served from counters kept up to date on accept,
+**        registration, OPER, user modes, QUIT and channel create/destroy.
+**
+** ============================================================================
+*/
@@ -0,0 +1,192 @@
+/* ************************************************************************** */
+/*                                                                          */
+/*                                                        :::      ::::::::   */
+/*   Monitor.cpp                                        :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: adrien <adrien@student.42.fr>              +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/19 21:46:37 by adrien            #+#    #+#             */
+/*   Updated: 2026/10/20 11:24:39 by adrien           ###   ########.fr       */
+/*                                                                          */
+/* ************************************************************************** */
+
+#include "../../../includes/Server.hpp"
+#include <sstream>
+
+/*
+* This function sends a list of nicks as comma separated numeric lines
+* (RPL_MONONLINE, RPL_MONOFFLINE, RPL_MONLIST), a new line when one is full
+* @param clientFd the client file descriptor
+* @param code the numeric
+* @param items the nicks or nick!user@host masks
+* @return void
+*/
+void Server::sendMonitorItems(const int &clientFd, int code, const std::vector<std::string> &items) {
+	if (items.empty())
+		return;
+
+	const std::string &nick = this->Users[clientFd].getNickname();
+	ReplyBuilder reply;
+	reply.start(code, nick).append(" :", 2);
+	const size_t empty = reply.length();
+
+	this->lookupReply.clear();
+	for (size_t i = 0; i < items.size(); i++) {
+		if (reply.length() + 1 + items[i].length() > REPLY_MAX_BODY) {
+			reply.finish();
+			this->lookupReply.append(reply.data(), reply.size());
+			reply.start(code, nick).append(" :", 2);
+		}
+		if (reply.length() > empty)
+			reply.append(",", 1);
+		reply.append(items[i]);
+	}
+	reply.finish();
+	this->lookupReply.append(reply.data(), reply.size());
+	sendToClient(clientFd, this->lookupReply);
+}
+
+/*
+* This function tells a client which of some nicks are online
+* @param clientFd the client file descriptor
+* @param nicks the nicks
+* @return void
+*/
+void Server::sendMonitorStatus(const int &clientFd, const std::vector<std::string> &nicks) {
+	std::vector<std::string> online;
+	std::vector<std::string> offline;
+
+	for (size_t i = 0; i < nicks.size(); i++) {
+		const User *user = findOnlineUser(nicks[i].data(), nicks[i].length());
+		if (user)
+			online.push_back(user->getHostmask());
+		else
+			offline.push_back(nicks[i]);
+	}
+	sendMonitorItems(clientFd, RPL_MONONLINE, online);
+	sendMonitorItems(clientFd, RPL_MONOFFLINE, offline);
+}
+
+/*
+* This function tells the watchers of a nick that it came or went
+* The line is rendered once around the watcher nick and gathered with
+* it, so a state change costs one index lookup and one write per watcher
+* @param nick the nick
+* @param hostmask nick!user@host when it came online, "" when it went
+* @return void
+*/
+void Server::notifyMonitors(const std::string &nick, const std::string &hostmask) {
+	const std::set<int> *watchers = this->monitors.watchersOf(nick);
+	if (!watchers)
+		return;
+
+	ReplyBuilder prefix;
+	prefix.start(hostmask.empty() ? RPL_MONOFFLINE : RPL_MONONLINE);
+	const std::string tail = " :" + (hostmask.empty() ? nick : hostmask) + IRC_CRLF;
+
+	struct iovec iov[3];
+	iov[0].iov_base = const_cast<char *>(prefix.data());
+	iov[0].iov_len = prefix.length();
+	iov[2].iov_base = const_cast<char *>(tail.data());
+	iov[2].iov_len = tail.size();
+	for (std::set<int>::const_iterator it = watchers->begin(); it != watchers->end(); ++it) {
+		std::map<int, User>::const_iterator watcher = this->Users.find(*it);
+		if (watcher == this->Users.end())
+			continue;
+		iov[1].iov_base = const_cast<char *>(watcher->second.getNickname().data());
+		iov[1].iov_len = watcher->second.getNickname().size();
+		sendToClient(*it, iov, 3);
+	}
+}
+
+/*
+* this fonction will handle the MONITOR command
+* @param clientFd the client file descriptor
+* @param line the line to parse
+* @return void
+*/
+void Server::handleMonitor(const int &clientFd, const std::string &line) {
+	std::istringstream iss(line);
+	std::string command;
+	std::string action;
+	std::string targets;
+
+	iss >> command >> action >> targets;
+	if (!targets.empty() && targets[0] == ':')
+		targets.erase(0, 1);
+	if (action.length() != 1 || ((action[0] == '+' || action[0] == '-') && targets.empty())) {
+		sendERR_NEEDMOREPARAMS(clientFd, "MONITOR");
+		return;
+	}
+
+	std::vector<std::string> nicks;
+	std::istringstream list(targets);
+	std::string nick;
+	while (std::getline(list, nick, ','))
+		if (!nick.empty())
+			nicks.push_back(nick);
+
+	switch (action[0]) {
+		case '+': {
+			const long limit = getClass(this->Users[clientFd]).monitor;
+			std::vector<std::string> added;
+			for (size_t i = 0; i < nicks.size(); i++) {
+				if (!isValidNickname(nicks[i]))
+					continue;
+				if (static_cast<long>(this->monitors.count(clientFd)) >= limit) {
+					std::string rest = nicks[i];
+					for (size_t j = i + 1; j < nicks.size(); j++)
+						rest += "," + nicks[j];
+					sendNumericReply(clientFd, ERR_MONLISTFULL, toString(limit), rest, MSG_ERR_MONLISTFULL);
+					break;
+				}
+				if (this->monitors.add(clientFd, nicks[i]))
+					added.push_back(nicks[i]);
+			}
+			sendMonitorStatus(clientFd, added);
+			break;
+		}
+		case '-':
+			for (size_t i = 0; i < nicks.size(); i++)
+				this->monitors.remove(clientFd, nicks[i]);
+			break;
+		case 'C':
+		case 'c':
+			this->monitors.clear(clientFd);
+			break;
+		case 'L':
+		case 'l':
+		case 'S':
+		case 's': {
+			std::vector<std::string> watched;
+			const std::map<std::string, std::string> *list = this->monitors.targetsOf(clientFd);
+			if (list)
+				for (std::map<std::string, std::string>::const_iterator it = list->begin(); it != list->end(); ++it)
+					watched.push_back(it->second);
+			if (action[0] == 'S' || action[0] == 's') {
+				sendMonitorStatus(clientFd, watched);
+				break;
+			}
+			sendMonitorItems(clientFd, RPL_MONLIST, watched);
+			sendNumericReply(clientFd, RPL_ENDOFMONLIST, "", MSG_RPL_ENDOFMONLIST);
+			break;
+		}
+	}
+}
+
+/*
+** ============================================================================
+**                           MONITOR COMMAND
+** ============================================================================
+**
+**  Format: MONITOR + <nick>{,<nick>} | - <nick>{,<nick>} | C | L | S
+**
+**  Action: Watches nicks (IRCv3): the server pushes RPL_MONONLINE (730)
+**          when one registers or takes the nick and RPL_MONOFFLINE (731)
+**          when it quits, is killed or changes nick.
+**  Replies: 730 / 731 for the nicks added (+) or watched (S),
+**           RPL_MONLIST (732) + RPL_ENDOFMONLIST (733) for L,
+**           ERR_MONLISTFULL (734) past the class "monitor" limit.
+**
+** ============================================================================
+*/
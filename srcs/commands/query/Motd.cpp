@@ -0,0 +1,97 @@
+/* ************************************************************************** */
+/*                                                                          */
+/*                                                        :::      ::::::::   */
+/*   Motd.cpp                                           :+:      :+:    :+:   */
+/*                                                    +:+ +:+         +:+     */
+/*   By: adrien <adrien@student.42.fr>              +#+  +:+       +#+        */
+/*                                                +#+#+#+#+#+   +#+           */
+/*   Created: 2026/10/19 19:04:26 by adrien            #+#    #+#             */
+/*   Updated: 2026/10/19 19:04:26 by adrien           ###   ########.fr       */
+/*                                                                          */
+/* ************************************************************************** */
+
+#include "../../../includes/Server.hpp"
+#include <cerrno>
+#include <cstring>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+/*
+* This function renders the MOTD from a file, mapped in memory while its
+* lines are copied into the reply
+* A missing file gives ERR_NOMOTD (422)
+* @param reply the reply to fill
+* @param path the MOTD file
+* @return false if the file exists but could not be read
+*/
+bool Server::renderMotd(StaticReply &reply, const std::string &path) const {
+	const int fd = open(path.c_str(), O_RDONLY);
+	if (fd < 0) {
+		if (errno != ENOENT)
+			return false;
+		reply.addLine(ERR_NOMOTD, "", MSG_ERR_NOMOTD);
+		return true;
+	}
+
+	struct stat info;
+	if (fstat(fd, &info) < 0) {
+		close(fd);
+		return false;
+	}
+
+	const char *data = NULL;
+	const size_t size = info.st_size;
+	if (size > 0) {
+		void *mapped = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (mapped == MAP_FAILED) {
+			close(fd);
+			return false;
+		}
+		data = static_cast<const char *>(mapped);
+	}
+	close(fd);
+
+	reply.addLine(RPL_MOTDSTART, "", "- " SERVER_NAME " Message of the day - ");
+	size_t start = 0;
+	while (start < size) {
+		const char *newline = static_cast<const char *>(memchr(data + start, '\n', size - start));
+		size_t end = newline ? newline - data : size;
+		const size_t next = end + 1;
+		if (end > start && data[end - 1] == '\r')
+			end--;
+		reply.addLine(RPL_MOTD, "", "- " + std::string(data + start, end - start));
+		start = next;
+	}
+	reply.addLine(RPL_ENDOFMOTD, "", MSG_RPL_ENDOFMOTD);
+
+	if (data)
+		munmap(const_cast<char *>(data), size);
+	return true;
+}
+
+/*
+* this fonction will handle the MOTD command
+* @param clientFd the client file descriptor
+* @param line the line to parse
+* @return void
+*/
+void Server::handleMotd(const int &clientFd, const std::string &line) {
+	if (isLocalServerTarget(clientFd, line))
+		sendStaticReply(clientFd, this->motdReply);
+}
+
+/*
+** ============================================================================
+**                           MOTD COMMAND
+** ============================================================================
+**
+**  Format: MOTD [server]
+**
+**  Action: Sends the message of the day, also sent after registration.
+**  Replies: RPL_MOTDSTART (375), RPL_MOTD (372), RPL_ENDOFMOTD (376),
+**           or ERR_NOMOTD (422) when the motd_file does not exist.
+**  Note: The file is rendered once at startup and on REHASH; a file that
+**        can no longer be read keeps the previous MOTD.
+**
+** ============================================================================
+*/
@@ -6,13 +6,12 @@
 /*   By: hdelacou <hdelacou@student.42.fr>          +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/12/16 04:03:33 by hdelacou          #+#    #+#             */
-/*   Updated: 2025/12/16 06:32:29 by hdelacou         ###   ########.fr       */
+/*   Updated: 2026/10/20 11:24:39 by adrien           ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
 #include "../../../includes/Server.hpp"
-#include "../../../includes/Utils.hpp"
-#include "../../../includes/IrcReplies.hpp"
+#include <sstream>
 
 /*
 * This function parses the NAMES command
@@ -21,77 +20,135 @@
 */
 std::vector<std::string> Server::parseNamesCommand(const std::string &line) {
 	std::vector<std::string> channels;
-	
-	size_t pos = line.find(' ');
-	if (pos == std::string::npos)
-		return channels; // No channels specified
-	
-	std::string channelList = line.substr(pos + 1);
-	
-	// Remove trailing CR/LF
-	if (!channelList.empty() && channelList[channelList.length() - 1] == '\r')
-		channelList.erase(channelList.length() - 1);
-	if (!channelList.empty() && channelList[channelList.length() - 1] == '\n')
-		channelList.erase(channelList.length() - 1);
-	
+	std::istringstream iss(line);
+	std::string command;
+	std::string channelList;
+
+	iss >> command >> channelList;
+
 	// Parse comma-separated channels
-	std::istringstream iss(channelList);
+	std::istringstream list(channelList);
 	std::string chan;
-	while (std::getline(iss, chan, ',')) {
+	while (std::getline(list, chan, ',')) {
 		if (!chan.empty())
 			channels.push_back(chan);
 	}
-	
 	return channels;
 }
 
 /*
-* This function sends RPL_NAMREPLY (353) to the client
+* This function adds a slice to a gathered reply
+* @param iov the slices
+* @param data the bytes of the slice
+* @param size how many of them
+* @return void
+*/
+static void gather(std::vector<struct iovec> &iov, const char *data, size_t size) {
+	struct iovec slice;
+
+	slice.iov_base = const_cast<char *>(data);
+	slice.iov_len = size;
+	iov.push_back(slice);
+}
+
+/*
+* This function sends RPL_NAMREPLY (353) lines and RPL_ENDOFNAMES (366)
+* The cached chunks of the channel are gathered as they are, the cache
+* is only built when the channel has none
 * @param clientFd the client file descriptor
-* @param channel the channel to send names for
+* @param channel the channel
 * @return void
 */
-void Server::sendRPL_NAMREPLY(const int &clientFd, Channel &channel) {
-	std::string nick = this->Users[clientFd].getNickname();
-	std::string chanName = channel.getName();
-	
-	// Build user list with prefixes
-	std::string userList = ;
-	const std::vector<int> &members = channel.getMembers();
-	
-	for (size_t i = 0; i < members.size(); i++) {
-		if (channel.isOperator(members[i])) {
-			userList += @; // Operator prefix
+void Server::sendNames(const int &clientFd, Channel &channel) {
+	static const char crlf[] = IRC_CRLF;
+	std::map<int, User>::const_iterator user = this->Users.find(clientFd);
+	if (user == this->Users.end())
+		return;
+
+	// Regular members of a +u channel only see the operators
+	if (channel.getAuditorium() && !channel.isOperator(clientFd)) {
+		sendAuditoriumNames(clientFd, channel);
+		return;
+	}
+
+	NamesCache &names = channel.getNames();
+	if (!names.isBuilt()) {
+		names.build(channel.getName());
+		const std::vector<int> members = channel.getAllMembers();
+		for (size_t i = 0; i < members.size(); i++) {
+			std::map<int, User>::const_iterator member = this->Users.find(members[i]);
+			if (member != this->Users.end())
+				names.add(members[i], member->second.getNickname(), channel.isOperator(members[i]));
 		}
-		userList += this->Users[members[i]].getNickname();
-		if (i < members.size() - 1)
-			userList +=  ;
 	}
-	
-	// Send RPL_NAMREPLY
-	std::string response = ":" + std::string(SERVER_NAME);
-	response +=  353  + nick +  =  + chanName;
-	response +=  : + userList + "
-";
-	
-	send(clientFd, response.c_str(), response.length(), 0);
+
+	const std::string &nick = user->second.getNickname();
+	const std::vector<std::string> &chunks = names.getChunks();
+	ReplyBuilder prefix;
+	ReplyBuilder end;
+	prefix.start(RPL_NAMREPLY);
+	end.start(RPL_ENDOFNAMES, nick).param(channel.getName()).trailing(MSG_RPL_ENDOFNAMES).finish();
+
+	this->replyIov.clear();
+	for (size_t i = 0; i < chunks.size(); i++) {
+		if (chunks[i].empty())
+			continue;
+		gather(this->replyIov, prefix.data(), prefix.length());
+		gather(this->replyIov, nick.data(), nick.size());
+		gather(this->replyIov, names.getHeader().data(), names.getHeader().size());
+		gather(this->replyIov, chunks[i].data(), chunks[i].size());
+		gather(this->replyIov, crlf, sizeof(crlf) - 1);
+	}
+	gather(this->replyIov, end.data(), end.size());
+	sendToClient(clientFd, &this->replyIov[0], this->replyIov.size());
 }
 
 /*
-* This function sends RPL_ENDOFNAMES (366) to signal end of NAMES list
+* This function sends the NAMES of a +u channel to a client that is not
+* one of its operators: the operators, and the client if it is a member.
+* The list is short, it is composed here rather than taken from the cache
 * @param clientFd the client file descriptor
-* @param channel the channel to send end of names for
+* @param channel the channel
 * @return void
 */
-void Server::sendRPL_ENDOFNAMES(const int &clientFd, Channel &channel) {
-	std::string nick = this->Users[clientFd].getNickname();
-	std::string chanName = channel.getName();
-	
-	std::string response = ":" + std::string(SERVER_NAME);
-	response +=  366  + nick +   + chanName;
-	response +=  :End of /NAMES list\r\n;
-	
-	send(clientFd, response.c_str(), response.length(), 0);
+void Server::sendAuditoriumNames(const int &clientFd, const Channel &channel) {
+	const std::string &nick = Users[clientFd].getNickname();
+	const std::set<int> &operators = channel.getAudience(clientFd);
+	ReplyBuilder reply;
+	std::string out;
+	std::string tokens;
+
+	reply.start(RPL_NAMREPLY, nick).param("=").param(channel.getName()).append(" :", 2);
+	const size_t budget = REPLY_MAX_BODY - reply.length();
+
+	std::vector<std::string> visible;
+	for (std::set<int>::const_iterator it = operators.begin(); it != operators.end(); ++it) {
+		std::map<int, User>::const_iterator member = this->Users.find(*it);
+		if (member != this->Users.end())
+			visible.push_back("@" + member->second.getNickname());
+	}
+	if (channel.isMember(clientFd))
+		visible.push_back(nick);
+
+	for (size_t i = 0; i < visible.size(); i++) {
+		if (!tokens.empty() && tokens.length() + 1 + visible[i].length() > budget) {
+			out.append(reply.data(), reply.length());
+			out += tokens + IRC_CRLF;
+			tokens.clear();
+		}
+		if (!tokens.empty())
+			tokens += " ";
+		tokens += visible[i];
+	}
+	if (!tokens.empty()) {
+		out.append(reply.data(), reply.length());
+		out += tokens + IRC_CRLF;
+	}
+
+	reply.start(RPL_ENDOFNAMES, nick).param(channel.getName()).trailing(MSG_RPL_ENDOFNAMES);
+	reply.finish();
+	out.append(reply.data(), reply.size());
+	sendToClient(clientFd, out);
 }
 
 /*
@@ -102,33 +159,19 @@ void Server::sendRPL_ENDOFNAMES(const int &clientFd, Channel &channel) {
 */
 void Server::handleNames(const int &clientFd, const std::string &line) {
 	std::vector<std::string> requestedChannels = parseNamesCommand(line);
-	
+
 	if (requestedChannels.empty()) {
-		for (std::vector<Channel>::iterator chan = channelList.begin(); 
-		     chan != channelList.end(); ++chan) {
-			sendRPL_NAMREPLY(clientFd, *chan);
-			sendRPL_ENDOFNAMES(clientFd, *chan);
-		}
-	} else {
-		for (size_t i = 0; i < requestedChannels.size(); i++) {
-			bool found = false;
-			for (std::vector<Channel>::iterator chan = channelList.begin(); 
-			     chan != channelList.end(); ++chan) {
-				if (chan->getName() == requestedChannels[i]) {
-					sendRPL_NAMREPLY(clientFd, *chan);
-					sendRPL_ENDOFNAMES(clientFd, *chan);
-					found = true;
-					break;
-				}
-			}
-			if (!found) {
-				std::string response = ":" + std::string(SERVER_NAME);
-				response +=  366  + this->Users[clientFd].getNickname();
-				response +=   + requestedChannels[i];
-				response +=  :End of /NAMES list\r\n;
-				send(clientFd, response.c_str(), response.length(), 0);
-			}
-		}
+		for (std::list<Channel>::iterator chan = channelList.begin();
+		     chan != channelList.end(); ++chan)
+			sendNames(clientFd, *chan);
+		return;
+	}
+	for (size_t i = 0; i < requestedChannels.size(); i++) {
+		std::list<Channel>::iterator chan = findChannel(requestedChannels[i]);
+		if (chan != channelList.end())
+			sendNames(clientFd, *chan);
+		else
+			sendNumericReply(clientFd, RPL_ENDOFNAMES, requestedChannels[i], MSG_RPL_ENDOFNAMES);
 	}
 }
 
@@ -139,8 +182,12 @@ void Server::handleNames(const int &clientFd, const std::string &line) {
 **
 **  Format: NAMES [channel(s)]
 **
-**  Action: Lists nicknames on channels.
+**  Action: Lists nicknames on channels (all of them without argument).
 **  Replies: RPL_NAMREPLY (353), RPL_ENDOFNAMES (366).
+**  Note: The 353 lines come from the channel NAMES cache, pre-chunked
+**        to fit 512 bytes and patched on join, part, nick and op
+**        changes; see NamesCache. A regular member of a +u channel only
+**        gets the operators and itself.
 **
 ** ============================================================================
 */
@@ -6,7 +6,7 @@
 /*   By: hdelacou <hdelacou@student.42.fr>          +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/12/16 04:04:03 by hdelacou          #+#    #+#             */
-/*   Updated: 2025/12/16 06:30:09 by hdelacou         ###   ########.fr       */
+/*   Updated: 2026/10/19 12:04:11 by adrien           ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -50,7 +50,7 @@ void Server::sendPong(const int &clientFd, const std::string &token)
 	response += " PONG " + std::string(SERVER_NAME);
 	response += " :" + token + IRC_CRLF;
 	
-	send(clientFd, response.c_str(), response.length(), 0);
+	sendToClient(clientFd, response);
 }
 
 /*
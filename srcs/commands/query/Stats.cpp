@@ -6,12 +6,135 @@
 /*   By: hdelacou <hdelacou@student.42.fr>          +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/12/16 04:04:26 by hdelacou          #+#    #+#             */
-/*   Updated: 2025/12/16 06:32:34 by hdelacou         ###   ########.fr       */
+/*   Updated: 2026/10/20 11:45:52 by adrien           ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
 #include "../../../includes/Server.hpp"
 #include "../../../includes/Utils.hpp"
+#include <sstream>
+
+/*
+* This function sends the slowest commands table of the watchdog
+* One RPL_STATSDEBUG (249) line per entry, slowest first
+* @param clientFd the client file descriptor
+* @return void
+*/
+void Server::sendStatsSlowest(const int &clientFd) {
+	const std::vector<t_stall> &slowest = this->watchdog.getSlowest();
+	const time_t now = time(NULL);
+
+	std::ostringstream summary;
+	summary << "Stalls: " << this->watchdog.getCommandStalls() << " command, "
+	        << this->watchdog.getLoopStalls() << " loop";
+	sendRPL_STATSDEBUG(clientFd, summary.str());
+
+	for (size_t i = 0; i < slowest.size(); i++) {
+		std::ostringstream oss;
+		oss << "#" << i + 1 << " " << slowest[i].usec << "us fd " << slowest[i].fd
+		    << " " << slowest[i].command;
+		if (!slowest[i].channel.empty())
+			oss << " " << slowest[i].channel;
+		oss << " (" << now - slowest[i].when << "s ago)";
+		sendRPL_STATSDEBUG(clientFd, oss.str());
+	}
+}
+
+/*
+* This function sends RPL_STATSUPTIME (242) and the LUSERS counters
+* @param clientFd the client file descriptor
+* @return void
+*/
+void Server::sendStatsUptime(const int &clientFd) {
+	const long uptime = time(NULL) - this->startTime;
+
+	std::ostringstream oss;
+	oss << "Server Up " << uptime / 86400 << " days " << (uptime / 3600) % 24 << ":"
+	    << ((uptime / 60) % 60 < 10 ? "0" : "") << (uptime / 60) % 60 << ":"
+	    << (uptime % 60 < 10 ? "0" : "") << uptime % 60;
+	sendNumericReply(clientFd, RPL_STATSUPTIME, "", oss.str());
+
+	std::ostringstream counters;
+	counters << "Users: " << this->lusers.registered << " registered, "
+	         << this->lusers.unknown << " unknown, " << this->lusers.invisible
+	         << " invisible, " << this->lusers.opers << " opers, "
+	         << this->lusers.channels << " channels, max " << this->lusers.localMax;
+	sendRPL_STATSDEBUG(clientFd, counters.str());
+}
+
+/*
+* This function sends one heavy-hitter table as RPL_STATSDEBUG (249) lines
+* @param clientFd the client file descriptor
+* @param title the table name
+* @param hitters the sketch to report
+* @param isClient true if the keys are connection ids (shown with the nick
+* of the client, if still connected)
+* @return void
+*/
+void Server::sendStatsHitters(const int &clientFd, const std::string &title,
+                              const HeavyHitters &hitters, bool isClient) {
+	const std::vector<t_hitter> top = hitters.getTop();
+
+	std::ostringstream header;
+	header << title << ": " << hitters.getTotal() << " total";
+	sendRPL_STATSDEBUG(clientFd, header.str());
+
+	for (size_t i = 0; i < top.size(); i++) {
+		std::ostringstream oss;
+		oss << "  #" << i + 1 << " ";
+		if (isClient) {
+			std::map<std::string, int>::const_iterator conn = this->connFds.find(top[i].key);
+			if (conn != this->connFds.end() && !this->Users[conn->second].getNickname().empty())
+				oss << this->Users[conn->second].getNickname() << " ";
+			oss << "(conn " << top[i].key << ")";
+		} else {
+			oss << top[i].key;
+		}
+		oss << " " << top[i].count;
+		sendRPL_STATSDEBUG(clientFd, oss.str());
+	}
+}
+
+/*
+* This function sends the top talkers by client, IP and channel
+* @param clientFd the client file descriptor
+* @return void
+*/
+void Server::sendStatsHeavyHitters(const int &clientFd) {
+	sendStatsHitters(clientFd, "Clients by bytes", this->clientBytes, true);
+	sendStatsHitters(clientFd, "Clients by lines", this->clientLines, true);
+	sendStatsHitters(clientFd, "IPs by bytes", this->ipBytes, false);
+	sendStatsHitters(clientFd, "IPs by lines", this->ipLines, false);
+	sendStatsHitters(clientFd, "Channels by fan-out", this->channelFanout, false);
+}
+
+/*
+* This function sends the accounting of every connection
+* One RPL_STATSLINKINFO (211) line per client: CPU time spent in its
+* handlers, messages it caused, commands run, current fake lag, class
+* and bytes waiting in its SendQ
+* @param clientFd the client file descriptor
+* @return void
+*/
+void Server::sendStatsConnections(const int &clientFd) {
+	const long now = getTimeUsec();
+
+	for (std::map<int, User>::iterator it = this->Users.begin(); it != this->Users.end(); ++it) {
+		std::ostringstream link;
+		link << (it->second.getNickname().empty() ? "*" : it->second.getNickname())
+		     << "[" << it->second.getIp() << "]";
+
+		std::ostringstream info;
+		info << "cpu " << it->second.getCpuUsec() << "us sends " << it->second.getSends()
+		     << " cmds " << it->second.getCommands() << " lag "
+		     << it->second.getLag(now) / 1000 << "ms";
+		info << " class " << getClass(it->second).name << " sendq "
+		     << it->second.getSendQueueSize();
+		if (this->throttled.count(it->first))
+			info << " (throttled)";
+		sendRPL_STATSLINKINFO(clientFd, link.str(), info.str());
+	}
+}
 
 /*
 * this fonction will handle the STATS command
@@ -20,8 +143,52 @@
 * @return void
 */
 void Server::handleStats(const int &clientFd, const std::string &line) {
-	(void)clientFd;
-	(void)line;
+	std::string query = getParam(STATS_CMD_LENGTH, line);
+
+	if (query.empty()) {
+		sendERR_NEEDMOREPARAMS(clientFd, CMD_STATS);
+		return;
+	}
+
+	const char letter = query[0];
+	switch (letter) {
+		case 'h':
+			if (!this->Users[clientFd].isOperator()) {
+				sendERR_NOPRIVILEGES(clientFd);
+				return;
+			}
+			sendStatsHeavyHitters(clientFd);
+			break;
+		case 'd':
+		case 'k':
+			if (!this->Users[clientFd].isOperator()) {
+				sendERR_NOPRIVILEGES(clientFd);
+				return;
+			}
+			sendStatsBans(clientFd, letter == 'k' ? BAN_KLINE : BAN_DLINE);
+			break;
+		case 'l':
+			if (!this->Users[clientFd].isOperator()) {
+				sendERR_NOPRIVILEGES(clientFd);
+				return;
+			}
+			sendStatsConnections(clientFd);
+			break;
+		case 'u':
+			sendStatsUptime(clientFd);
+			break;
+		case 'w':
+			if (!this->Users[clientFd].isOperator()) {
+				sendERR_NOPRIVILEGES(clientFd);
+				return;
+			}
+			sendStatsSlowest(clientFd);
+			break;
+		default:
+			break;
+	}
+
+	sendRPL_ENDOFSTATS(clientFd, std::string(1, letter));
 }
 
 /*
@@ -29,10 +196,17 @@ void Server::handleStats(const int &clientFd, const std::string &line) {
 **                           STATS COMMAND
 ** ============================================================================
 **
-**  Format: STATS [query] [server]
+**  Format: STATS <query> [server]
 **
 **  Action: Query server statistics (uptime, command usage, etc.).
-**  Replies: Varying RPL_STATS* (210-249).
+**  Queries: d (D-lines, operators only)
+**           h (heavy hitters: top clients, IPs and channels, operators only)
+**           k (K-lines, operators only)
+**           l (per-connection CPU, fan-out, fake lag, class and SendQ,
+**              operators only)
+**           u (uptime and user counters)
+**           w (slowest commands seen by the watchdog, operators only)
+**  Replies: Varying RPL_STATS* (210-249), RPL_ENDOFSTATS (219).
 **
 ** ============================================================================
 */
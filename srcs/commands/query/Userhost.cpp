@@ -6,22 +6,55 @@
 /*   By: hdelacou <hdelacou@student.42.fr>          +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/12/16 04:05:25 by hdelacou          #+#    #+#             */
-/*   Updated: 2025/12/16 06:33:12 by hdelacou         ###   ########.fr       */
+/*   Updated: 2026/10/20 11:24:39 by adrien           ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
 #include "../../../includes/Server.hpp"
-#include "../../../includes/Utils.hpp"
+
+// Nicks answered by one USERHOST, the others are ignored
+#define USERHOST_MAX 5
 
 /*
 * this fonction will handle the USERHOST command
+* Answers "nick[*]=<+|->user@host" for each online nick, '*' marking
+* an IRC operator and '-' an away client
 * @param clientFd the client file descriptor
 * @param line the line to parse
 * @return void
 */
 void Server::handleUserhost(const int &clientFd, const std::string &line) {
-	(void)clientFd;
-	(void)line;
+	static const char separators[] = " :";
+	size_t pos = line.find(' ');
+
+	if (pos == std::string::npos || line.find_first_not_of(separators, pos) == std::string::npos) {
+		sendERR_NEEDMOREPARAMS(clientFd, "USERHOST");
+		return;
+	}
+
+	ReplyBuilder reply;
+	reply.start(RPL_USERHOST, this->Users[clientFd].getNickname()).append(separators, 2);
+	const size_t empty = reply.length();
+
+	for (int asked = 0; asked < USERHOST_MAX
+	     && (pos = line.find_first_not_of(separators, pos)) != std::string::npos; asked++) {
+		size_t end = line.find(' ', pos);
+		if (end == std::string::npos)
+			end = line.length();
+		const User *user = findOnlineUser(line.data() + pos, end - pos);
+		pos = end;
+		if (!user)
+			continue;
+
+		if (reply.length() > empty)
+			reply.append(" ", 1);
+		reply.append(user->getNickname());
+		if (user->isOperator())
+			reply.append("*", 1);
+		reply.append(user->isAway() ? "=-" : "=+", 2);
+		reply.append(user->getUsername()).append("@", 1).append(user->getHost());
+	}
+	sendToClient(clientFd, reply);
 }
 
 /*
@@ -33,6 +66,7 @@ void Server::handleUserhost(const int &clientFd, const std::string &line) {
 **
 **  Action: Returns user information for up to 5 nicknames.
 **  Reply: RPL_USERHOST (302).
+**  Cost: penalty_lookup_usec of fake lag per nick asked about.
 **
 ** ============================================================================
 */
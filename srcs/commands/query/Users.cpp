@@ -6,7 +6,7 @@
 /*   By: hdelacou <hdelacou@student.42.fr>          +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/12/16 04:05:29 by hdelacou          #+#    #+#             */
-/*   Updated: 2025/12/16 06:33:16 by hdelacou         ###   ########.fr       */
+/*   Updated: 2026/10/19 10:58:03 by adrien           ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -20,8 +20,8 @@
 * @return void
 */
 void Server::handleUsers(const int &clientFd, const std::string &line) {
-	(void)clientFd;
 	(void)line;
+	sendLocalGlobalUsers(clientFd);
 }
 
 /*
@@ -32,7 +32,7 @@ void Server::handleUsers(const int &clientFd, const std::string &line) {
 **  Format: USERS [server]
 **
 **  Action: Lists users logged into the server host (deprecated).
-**  Reply: Often ERR_USERS_DISABLED (446).
+**  Reply: User counts instead, LOCALUSERS (265) and GLOBALUSERS (266).
 **
 ** ============================================================================
 */
@@ -6,29 +6,19 @@
 /*   By: hdelacou <hdelacou@student.42.fr>          +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/12/16 04:05:35 by hdelacou          #+#    #+#             */
-/*   Updated: 2025/12/16 06:33:21 by hdelacou         ###   ########.fr       */
+/*   Updated: 2026/10/19 19:04:26 by adrien           ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
 #include "../../../includes/Server.hpp"
-#include "../../../includes/Utils.hpp"
-#include "../../../includes/IrcReplies.hpp"
 
 /*
-* This function sends RPL_VERSION (351) to the client
-* @param clientFd the client file descriptor
+* This function renders the RPL_VERSION (351) reply
+* @param reply the reply to fill
 * @return void
 */
-void Server::sendRPL_VERSION(const int &clientFd) {
-	std::string nick = this->Users[clientFd].getNickname();
-	
-	std::string response = ":" + std::string(SERVER_NAME);
-	response +=  351  + nick +  ;
-	response += ft_irc-1.0.0 ;  // Version
-	response += SERVER_NAME;
-	response +=  :Internet Relay Chat Server\r\n;
-	
-	send(clientFd, response.c_str(), response.length(), 0);
+void Server::renderVersion(StaticReply &reply) const {
+	reply.addLine(RPL_VERSION, SERVER_VERSION ". " SERVER_NAME, "Internet Relay Chat Server");
 }
 
 /*
@@ -38,23 +28,8 @@ void Server::sendRPL_VERSION(const int &clientFd) {
 * @return void
 */
 void Server::handleVersion(const int &clientFd, const std::string &line) {
-	std::string targetServer = ;
-	size_t pos = line.find(' ');
-	if (pos != std::string::npos) {
-		targetServer = line.substr(pos + 1);
-		if (!targetServer.empty() && targetServer[targetServer.length() - 1] == '\r')
-			targetServer.erase(targetServer.length() - 1);
-		if (!targetServer.empty() && targetServer[targetServer.length() - 1] == '\n')
-			targetServer.erase(targetServer.length() - 1);
-	}
-	
-	if (targetServer.empty() || targetServer == SERVER_NAME) {
-		sendRPL_VERSION(clientFd);
-	} else {
-		sendERR_NOSUCHSERVER(clientFd, targetServer);
-	}
-	
-	std::cout << VERSION query from  << this->Users[clientFd].getNickname() << std::endl;
+	if (isLocalServerTarget(clientFd, line))
+		sendStaticReply(clientFd, this->versionReply);
 }
 
 /*
@@ -65,7 +40,7 @@ void Server::handleVersion(const int &clientFd, const std::string &line) {
 **  Format: VERSION [server]
 **
 **  Action: Queries the version of the server program.
-**  Reply: RPL_VERSION (351).
+**  Reply: RPL_VERSION (351), rendered once at startup and on REHASH.
 **
 ** ============================================================================
 */
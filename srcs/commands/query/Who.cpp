@@ -6,12 +6,264 @@
 /*   By: hdelacou <hdelacou@student.42.fr>          +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/12/16 04:05:56 by hdelacou          #+#    #+#             */
-/*   Updated: 2025/12/16 06:30:05 by hdelacou         ###   ########.fr       */
+/*   Updated: 2026/10/20 09:58:20 by adrien           ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
 #include "../../../includes/Server.hpp"
-#include "../../../includes/Utils.hpp"
+#include <sstream>
+#include <algorithm>
+#include <cstring>
+
+/*
+* This function reads the flags of a WHO command
+* "o" keeps the IRC operators, "n", "u", "h", "i", "s" and "r" pick the
+* fields the mask is tried on (nick, user, host, ip, server, realname),
+* and "%fields[,token]" asks for a WHOX reply with those columns
+* @param flags the second parameter of WHO
+* @param cursor the query to fill
+* @param oper true if the requester is an IRC operator (ip matching)
+* @return void
+*/
+void Server::parseWhoFlags(const std::string &flags, t_whocursor &cursor, bool oper) const {
+	static const char matchFlags[] = "nuhisr";
+	static const unsigned int matchBits[] = {WHO_MATCH_NICK, WHO_MATCH_USER, WHO_MATCH_HOST,
+	                                         WHO_MATCH_IP, WHO_MATCH_SERVER, WHO_MATCH_REALNAME};
+	unsigned int fields = 0;
+	size_t i = 0;
+
+	for (; i < flags.length() && flags[i] != '%'; i++) {
+		if (flags[i] == 'o')
+			cursor.opersOnly = true;
+		const char *flag = std::strchr(matchFlags, flags[i]);
+		if (flag && *flag && (flags[i] != 'i' || oper))
+			fields |= matchBits[flag - matchFlags];
+	}
+	if (fields)
+		cursor.fields = fields;
+	if (i == flags.length())
+		return;
+
+	// WHOX: the columns come out in "tcuihsnfdlaor" order whatever the
+	// order they were asked in
+	size_t comma = flags.find(',', i);
+	cursor.select = flags.substr(i + 1, comma == std::string::npos ? std::string::npos : comma - i - 1);
+	if (cursor.select.empty())
+		cursor.select = "n";
+	if (comma != std::string::npos)
+		cursor.token = flags.substr(comma + 1, 3);
+	if (cursor.token.empty())
+		cursor.token = "0";
+}
+
+/*
+* This function gathers the clients a WHO may list
+* A channel gives its members, a mask the clients whose indexed fields
+* may match it (see UserIndex), a mask matching the server name or an ip
+* search every client. Visibility and the mask itself are checked as
+* the replies are sent
+* @param clientFd the requester
+* @param cursor the query
+* @return void
+*/
+void Server::collectWho(const int &clientFd, t_whocursor &cursor) const {
+	if (!cursor.channel.empty()) {
+		std::list<Channel>::const_iterator chan = findChannel(cursor.channel);
+		if (chan != channelList.end()) {
+			cursor.member = chan->isMember(clientFd);
+			// Regular members of a +u channel only see the operators
+			if (chan->getAuditorium() && !chan->isOperator(clientFd)) {
+				const std::set<int> &operators = chan->getAudience(clientFd);
+				cursor.fds.assign(operators.begin(), operators.end());
+				if (cursor.member)
+					cursor.fds.push_back(clientFd);
+			} else
+				cursor.fds = chan->getAllMembers();
+		}
+		return;
+	}
+
+	if (cursor.matchAll || (cursor.fields & WHO_MATCH_IP)
+	    || ((cursor.fields & WHO_MATCH_SERVER) && cursor.glob.match(SERVER_NAME)))
+		this->userIndex.all(cursor.fds);
+	else {
+		if (cursor.fields & WHO_MATCH_NICK)
+			this->userIndex.collect(WHO_NICK, cursor.mask, cursor.fds);
+		if (cursor.fields & WHO_MATCH_USER)
+			this->userIndex.collect(WHO_USER, cursor.mask, cursor.fds);
+		if (cursor.fields & WHO_MATCH_HOST)
+			this->userIndex.collect(WHO_HOST, cursor.mask, cursor.fds);
+		if (cursor.fields & WHO_MATCH_REALNAME)
+			this->userIndex.collect(WHO_REALNAME, cursor.mask, cursor.fds);
+		std::sort(cursor.fds.begin(), cursor.fds.end());
+		cursor.fds.erase(std::unique(cursor.fds.begin(), cursor.fds.end()), cursor.fds.end());
+	}
+
+	// Invisible clients are only listed to the clients they share a channel with
+	std::map<int, User>::const_iterator requester = this->Users.find(clientFd);
+	if (requester == this->Users.end() || requester->second.isOperator())
+		return;
+	const std::set<std::string> &joined = requester->second.getChannels();
+	for (std::set<std::string>::const_iterator name = joined.begin(); name != joined.end(); ++name) {
+		std::list<Channel>::const_iterator chan = findChannel(*name);
+		if (chan == channelList.end())
+			continue;
+		const std::set<int> &members = chan->getMemberSet();
+		cursor.neighbours.insert(members.begin(), members.end());
+	}
+}
+
+/*
+* This function checks a candidate against a WHO query
+* @param cursor the query
+* @param requester the client asking
+* @param targetFd the candidate file descriptor
+* @param target the candidate
+* @return true if the candidate is to be listed
+*/
+bool Server::whoMatches(const t_whocursor &cursor, const User &requester, int targetFd, const User &target) const {
+	if (!target.getIsRegister())
+		return false;
+	if (cursor.opersOnly && !target.isOperator())
+		return false;
+	if (target.isInvisible() && !requester.isOperator() && &target != &requester) {
+		if (cursor.channel.empty() ? !cursor.neighbours.count(targetFd) : !cursor.member)
+			return false;
+	}
+	if (!cursor.channel.empty() || cursor.matchAll)
+		return true;
+	return ((cursor.fields & WHO_MATCH_NICK) && cursor.glob.match(target.getNickname()))
+	    || ((cursor.fields & WHO_MATCH_USER) && cursor.glob.match(target.getUsername()))
+	    || ((cursor.fields & WHO_MATCH_HOST) && cursor.glob.match(target.getHost()))
+	    || ((cursor.fields & WHO_MATCH_IP) && cursor.glob.match(target.getIp()))
+	    || ((cursor.fields & WHO_MATCH_SERVER) && cursor.glob.match(SERVER_NAME))
+	    || ((cursor.fields & WHO_MATCH_REALNAME) && cursor.glob.match(target.getRealname()));
+}
+
+/*
+* This function renders the RPL_WHOREPLY (352) or RPL_WHOSPCRPL (354)
+* line of a client
+* @param reply the line to fill
+* @param cursor the query
+* @param requester the client asking
+* @param targetFd the client listed
+* @param target the client listed
+* @param channel the channel asked for, NULL for a mask
+* @return void
+*/
+void Server::renderWho(ReplyBuilder &reply, const t_whocursor &cursor, const User &requester,
+                       int targetFd, const User &target, const Channel *channel) const {
+	const std::string chanName = channel ? channel->getName() : "*";
+	const bool privileged = requester.isOperator() || &requester == &target;
+	std::string flags = target.isAway() ? "G" : "H";
+	if (target.isOperator())
+		flags += '*';
+	if (channel && channel->isOperator(targetFd))
+		flags += '@';
+
+	if (cursor.select.empty()) {
+		reply.start(RPL_WHOREPLY, requester.getNickname()).param(chanName).param(target.getUsername())
+			.param(target.getHost()).param(SERVER_NAME).param(target.getNickname()).param(flags)
+			.trailing("0 " + target.getRealname());
+		return;
+	}
+
+	reply.start(RPL_WHOSPCRPL, requester.getNickname());
+	for (const char *field = "tcuihsnfdlaor"; *field; field++) {
+		if (cursor.select.find(*field) == std::string::npos)
+			continue;
+		switch (*field) {
+			case 't': reply.param(cursor.token); break;
+			case 'c': reply.param(chanName); break;
+			case 'u': reply.param(target.getUsername()); break;
+			case 'i': reply.param(privileged ? target.getIp() : "255.255.255.255"); break;
+			case 'h': reply.param(target.getHost()); break;
+			case 's': reply.param(SERVER_NAME); break;
+			case 'n': reply.param(target.getNickname()); break;
+			case 'f': reply.param(flags); break;
+			case 'd': reply.param("0"); break;
+			case 'l': reply.param(toString(privileged ? time(NULL) - target.getLastActivity() : 0)); break;
+			case 'a': reply.param("0"); break;
+			case 'o': reply.param("n/a"); break;
+			case 'r': reply.trailing(target.getRealname()); break;
+		}
+	}
+}
+
+/*
+* This function sends the next batch of a WHO
+* At most WHO_BATCH lines are sent and WHO_SCAN candidates looked at,
+* the lines of a batch leave in a single write
+* @param clientFd the client file descriptor
+* @param cursor the query
+* @return true once RPL_ENDOFWHO was sent
+*/
+bool Server::continueWho(const int &clientFd, t_whocursor &cursor) {
+	std::map<int, User>::const_iterator requester = this->Users.find(clientFd);
+	if (requester == this->Users.end())
+		return true;
+
+	const Channel *channel = NULL;
+	if (!cursor.channel.empty()) {
+		std::list<Channel>::const_iterator chan = findChannel(cursor.channel);
+		if (chan != channelList.end())
+			channel = &*chan;
+		else
+			cursor.next = cursor.fds.size();
+	}
+
+	std::string batch;
+	ReplyBuilder reply;
+	size_t sent = 0;
+	for (size_t scanned = 0; cursor.next < cursor.fds.size() && sent < WHO_BATCH && scanned < WHO_SCAN; scanned++) {
+		const int targetFd = cursor.fds[cursor.next++];
+		std::map<int, User>::const_iterator target = this->Users.find(targetFd);
+		if (target == this->Users.end() || (channel && !channel->isMember(targetFd)))
+			continue;
+		if (!whoMatches(cursor, requester->second, targetFd, target->second))
+			continue;
+		renderWho(reply, cursor, requester->second, targetFd, target->second, channel);
+		reply.finish();
+		batch.append(reply.data(), reply.size());
+		sent++;
+	}
+	if (!batch.empty())
+		sendToClient(clientFd, batch);
+	if (cursor.next < cursor.fds.size())
+		return false;
+	sendRPL_ENDOFWHO(clientFd, cursor.mask);
+	return true;
+}
+
+/*
+* This function moves every WHO in progress one batch forward
+* A reply waits while its client SendQ holds more than a share of what
+* its class allows
+* @return true if a WHO still has something to send right away
+*/
+bool Server::continueWhos() {
+	bool pending = false;
+	std::map<int, t_whocursor>::iterator it = this->whoCursors.begin();
+
+	while (it != this->whoCursors.end()) {
+		std::map<int, User>::iterator user = this->Users.find(it->first);
+		if (user == this->Users.end() || this->pendingDisconnect.count(it->first)) {
+			this->whoCursors.erase(it++);
+			continue;
+		}
+		if (user->second.getSendQueueSize() >= getClass(user->second).sendq / WHO_SENDQ_SHARE) {
+			++it;
+			continue;
+		}
+		if (continueWho(it->first, it->second))
+			this->whoCursors.erase(it++);
+		else {
+			pending = true;
+			++it;
+		}
+	}
+	return pending;
+}
 
 /*
 * this fonction will handle the WHO command
@@ -20,8 +272,36 @@
 * @return void
 */
 void Server::handleWho(const int &clientFd, const std::string &line) {
-	(void)clientFd;
-	(void)line;
+	std::istringstream iss(line);
+	std::string command;
+	std::string mask;
+	std::string flags;
+
+	iss >> command >> mask >> flags;
+	if (!flags.empty() && flags[0] == ':')
+		flags.erase(0, 1);
+
+	// A new WHO replaces the one still streaming
+	t_whocursor &cursor = this->whoCursors[clientFd];
+	cursor.mask = mask;
+	cursor.glob.compile(mask);
+	cursor.matchAll = mask.empty() || mask == "0" || mask == "*";
+	cursor.channel.clear();
+	if (!mask.empty() && (mask[0] == '#' || mask[0] == '&'))
+		cursor.channel = mask;
+	cursor.member = false;
+	cursor.fields = WHO_MATCH_DEFAULT;
+	cursor.opersOnly = false;
+	cursor.select.clear();
+	cursor.token.clear();
+	cursor.neighbours.clear();
+	cursor.fds.clear();
+	cursor.next = 0;
+
+	parseWhoFlags(flags, cursor, this->Users[clientFd].isOperator());
+	collectWho(clientFd, cursor);
+	if (continueWho(clientFd, cursor))
+		this->whoCursors.erase(clientFd);
 }
 
 /*
@@ -29,11 +309,16 @@ void Server::handleWho(const int &clientFd, const std::string &line) {
 **                           WHO COMMAND
 ** ============================================================================
 **
-**  Format: WHO [<mask> [o]]
+**  Format: WHO [<mask> [<flags>][%<fields>[,<token>]]]
 **
 **  Action: List users matching mask (channel, wildcard, nick).
-**  Flags: 'o' restricts to operators.
-**  Replies: RPL_WHOREPLY (352) -> RPL_ENDOFWHO (315).
+**  Flags: 'o' restricts to operators, n/u/h/i/s/r pick the fields the
+**         mask is tried on (default: all but the ip).
+**  WHOX: '%' followed by t c u i h s n f d l a o r selects the columns
+**        of RPL_WHOSPCRPL (354) instead of RPL_WHOREPLY (352).
+**  Replies: RPL_WHOREPLY (352) / RPL_WHOSPCRPL (354) -> RPL_ENDOFWHO (315).
+**  Note: Candidates come from the channel or from UserIndex, replies
+**        are streamed WHO_BATCH lines at a time from the main loop.
 **
 ** ============================================================================
 */
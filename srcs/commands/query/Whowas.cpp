@@ -6,22 +6,70 @@
 /*   By: hdelacou <hdelacou@student.42.fr>          +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/12/16 04:06:10 by hdelacou          #+#    #+#             */
-/*   Updated: 2025/12/16 06:33:24 by hdelacou         ###   ########.fr       */
+/*   Updated: 2026/10/19 22:13:52 by adrien           ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
 #include "../../../includes/Server.hpp"
-#include "../../../includes/Utils.hpp"
+#include <sstream>
+#include <cstdlib>
 
 /*
 * this fonction will handle the WHOWAS command
+* The records of every nick asked for are looked up in the history hash
+* and their replies gathered in one buffer
 * @param clientFd the client file descriptor
 * @param line the line to parse
 * @return void
 */
 void Server::handleWhowas(const int &clientFd, const std::string &line) {
-	(void)clientFd;
-	(void)line;
+	std::istringstream iss(line);
+	std::string command;
+	std::string nicks;
+	std::string count;
+
+	iss >> command >> nicks >> count;
+	if (!nicks.empty() && nicks[0] == ':')
+		nicks.erase(0, 1);
+	if (nicks.empty()) {
+		sendERR_NONICKNAMEGIVEN(clientFd);
+		return;
+	}
+
+	// No count, or one below 1, asks for everything kept
+	long max = std::atol(count.c_str());
+	if (max < 1 || max > WHOWAS_MAX_REPLIES)
+		max = WHOWAS_MAX_REPLIES;
+
+	const std::string &me = this->Users[clientFd].getNickname();
+	const t_whowas *found[WHOWAS_MAX_REPLIES];
+	ReplyBuilder reply;
+	char signoff[64];
+
+	this->lookupReply.clear();
+	std::istringstream list(nicks);
+	std::string nick;
+	while (std::getline(list, nick, ',')) {
+		if (nick.empty())
+			continue;
+		const size_t records = this->whowas.find(nick, found, max);
+		for (size_t i = 0; i < records; i++) {
+			reply.start(RPL_WHOWASUSER, me).param(found[i]->nick).param(found[i]->user)
+				.param(found[i]->host).param("*").trailing(found[i]->realname).finish();
+			this->lookupReply.append(reply.data(), reply.size());
+
+			strftime(signoff, sizeof(signoff), "%a %b %d %H:%M:%S %Y", gmtime(&found[i]->signoff));
+			reply.start(RPL_WHOISSERVER, me).param(found[i]->nick).param(SERVER_NAME).trailing(signoff).finish();
+			this->lookupReply.append(reply.data(), reply.size());
+		}
+		if (records == 0) {
+			reply.start(ERR_WASNOSUCHNICK, me).param(nick).trailing(MSG_ERR_WASNOSUCHNICK).finish();
+			this->lookupReply.append(reply.data(), reply.size());
+		}
+		reply.start(RPL_ENDOFWHOWAS, me).param(nick).trailing(MSG_RPL_ENDOFWHOWAS).finish();
+		this->lookupReply.append(reply.data(), reply.size());
+	}
+	sendToClient(clientFd, this->lookupReply);
 }
 
 /*
@@ -29,10 +77,13 @@ void Server::handleWhowas(const int &clientFd, const std::string &line) {
 **                           WHOWAS COMMAND
 ** ============================================================================
 **
-**  Format: WHOWAS <nick> [count]
+**  Format: WHOWAS <nick>{,<nick>} [count]
 **
-**  Action: Queries history of used nicknames.
-**  Replies: RPL_WHOWASUSER (314), RPL_ENDOFWHOWAS (369).
+**  Action: Queries history of used nicknames, newest first.
+**  Replies: RPL_WHOWASUSER (314) + RPL_WHOISSERVER (312) per record,
+**           ERR_WASNOSUCHNICK (406) when none, RPL_ENDOFWHOWAS (369).
+**  Note: The history is a ring of whowas_size records (WhowasHistory),
+**        filled on NICK changes and disconnects.
 **
 ** ============================================================================
 */
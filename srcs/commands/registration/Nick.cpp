@@ -6,7 +6,7 @@
 /*   By: adrien <adrien@student.42.fr>              +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/12/16 04:06:15 by hdelacou          #+#    #+#             */
-/*   Updated: 2026/01/15 07:55:05 by adrien           ###   ########.fr       */
+/*   Updated: 2026/10/20 09:41:52 by adrien           ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -14,6 +14,7 @@
 #include "../../../includes/Utils.hpp"
 #include "../../../includes/IrcReplies.hpp"
 #include <strings.h>
+#include <cctype>
 
 /*
 * This function validates if a nickname is valid
@@ -37,6 +38,20 @@ bool Server::isValidNickname(const std::string &nickname) {
 	return true;
 }
 
+/*
+* This function gives the key of a nickname in the nick index
+* Nicknames are case-insensitive
+* @param nickname the nickname
+* @return the lowercase nickname
+*/
+static std::string nickKey(const std::string &nickname) {
+	std::string key = nickname;
+
+	for (size_t i = 0; i < key.length(); i++)
+		key[i] = std::tolower(key[i]);
+	return key;
+}
+
 /*
 * This function checks if a nickname is already taken
 * Uses case-insensitive comparison
@@ -45,14 +60,55 @@ bool Server::isValidNickname(const std::string &nickname) {
 * @return true if taken, false if available
 */
 bool Server::isNicknameTaken(const std::string &nickname, const int &clientFd) {
-	for (std::map<int, User>::iterator it = this->Users.begin();
-	     it != this->Users.end(); ++it) {
-		if (it->first == clientFd)
-			continue;
-		if (strcasecmp(it->second.getNickname().c_str(), nickname.c_str()) == 0)
-			return true;
-	}
-	return false;
+	const int fd = findUserByNickname(nickname);
+	return (fd != -1 && fd != clientFd);
+}
+
+/*
+* This function finds a user by their nickname through the nick index
+* @param nickname the nickname to search for (case-insensitive)
+* @return file descriptor of the user, or -1 if not found
+*/
+int Server::findUserByNickname(const std::string &nickname) const {
+	std::map<std::string, int>::const_iterator it = this->nickIndex.find(nickKey(nickname));
+	return (it == this->nickIndex.end() ? -1 : it->second);
+}
+
+/*
+* This function finds a registered client by nickname for the lookup
+* commands; the key is lowercased into a reused buffer so a lookup does
+* not allocate, and every lookup is charged to the command
+* @param nickname the nickname, not terminated
+* @param length its length
+* @return the client, NULL if no registered client has this nickname
+*/
+const User *Server::findOnlineUser(const char *nickname, size_t length) {
+	this->dispatchLookups++;
+	this->lookupKey.assign(nickname, length);
+	for (size_t i = 0; i < length; i++)
+		this->lookupKey[i] = std::tolower(this->lookupKey[i]);
+
+	std::map<std::string, int>::const_iterator it = this->nickIndex.find(this->lookupKey);
+	if (it == this->nickIndex.end())
+		return NULL;
+	std::map<int, User>::const_iterator user = this->Users.find(it->second);
+	if (user == this->Users.end() || !user->second.getIsRegister())
+		return NULL;
+	return &user->second;
+}
+
+/*
+* This function keeps the nick index in step with a nickname change
+* @param clientFd the client file descriptor
+* @param oldNick the previous nickname ("" if none)
+* @param newNick the new nickname ("" when the client leaves)
+* @return void
+*/
+void Server::indexNickname(const int &clientFd, const std::string &oldNick, const std::string &newNick) {
+	if (!oldNick.empty())
+		this->nickIndex.erase(nickKey(oldNick));
+	if (!newNick.empty())
+		this->nickIndex[nickKey(newNick)] = clientFd;
 }
 
 /*
@@ -79,15 +135,32 @@ void Server::handleNick(const int &clientFd, const std::string &line) {
 		return;
 	}
 
+	if (isNickChangeBanned(clientFd, newNick))
+		return;
+
 	std::string oldNick = this->Users[clientFd].getNickname();
+	const std::string oldPrefix = this->Users[clientFd].getPrefix();
 
+	// WHO finds registered clients under their current nick only
+	const bool indexed = this->Users[clientFd].getWelcomeMessage();
+	if (indexed) {
+		this->userIndex.remove(clientFd, this->Users[clientFd]);
+		this->whowas.record(this->Users[clientFd], time(NULL));
+	}
 	this->Users[clientFd].setNickname(newNick);
+	indexNickname(clientFd, oldNick, newNick);
+	if (indexed)
+		this->userIndex.add(clientFd, this->Users[clientFd]);
 
 	this->Users[clientFd].setHasNickname(true);
 	this->Users[clientFd].tryRegisterUser();
 
 	if (!oldNick.empty()) {
-		broadcastNickChange(clientFd, oldNick, newNick);
+		broadcastNickChange(clientFd, oldPrefix, newNick);
+	}
+	if (indexed && MonitorIndex::key(oldNick) != MonitorIndex::key(newNick)) {
+		notifyMonitors(oldNick, "");
+		notifyMonitors(newNick, this->Users[clientFd].getHostmask());
 	}
 
 	std::cout << "Nickname set: " << oldNick << " -> " << newNick
@@ -96,39 +169,68 @@ void Server::handleNick(const int &clientFd, const std::string &line) {
 	checkUserRegistration(clientFd);
 }
 
+/*
+* This function refuses a nick change on the channels where the user is
+* banned (as now or under the new nick) and not channel operator, then
+* drops the cached ban state of the user on its channels
+* @param clientFd the client file descriptor
+* @param newNick the requested nickname
+* @return true if the change is refused (ERR_BANNICKCHANGE was sent)
+*/
+bool Server::isNickChangeBanned(const int &clientFd, const std::string &newNick) {
+	const User &user = this->Users[clientFd];
+	const std::string newMask = newNick + "!" + user.getUsername() + "@" + user.getHost();
+
+	if (!user.getIsRegister())
+		return false;
+	const std::set<std::string> &joined = user.getChannels();
+	for (std::set<std::string>::const_iterator name = joined.begin(); name != joined.end(); ++name) {
+		std::list<Channel>::iterator chan = findChannel(*name);
+		if (chan == channelList.end() || chan->isOperator(clientFd))
+			continue;
+		if (chan->isBanned(clientFd, user.getHostmask())
+		    || (chan->getMaskList('b')->match(newMask) && !chan->getMaskList('e')->match(newMask))) {
+			sendERR_BANNICKCHANGE(clientFd, newNick, chan->getName());
+			return true;
+		}
+	}
+	for (std::set<std::string>::const_iterator name = joined.begin(); name != joined.end(); ++name) {
+		std::list<Channel>::iterator chan = findChannel(*name);
+		if (chan != channelList.end())
+			chan->forgetBanState(clientFd);
+	}
+	return false;
+}
+
 /*
 * This function broadcasts nickname change to all users in shared channels
 * @param clientFd the client file descriptor
-* @param oldNick the old nickname
+* @param oldPrefix the prefix under the old nickname
 * @param newNick the new nickname
 * @return void
 */
 void Server::broadcastNickChange(const int &clientFd,
-                                  const std::string &oldNick,
+                                  const std::string &oldPrefix,
                                   const std::string &newNick) {
-	std::string message = ":";
-	message += oldNick + "!";
-	message += this->Users[clientFd].getUsername() + "@";
-	message += "localhost NICK :";
-	message += newNick + "\r\n";
+	std::string message = oldPrefix + " NICK :" + newNick + "\r\n";
 
 	// Send to the user themselves
-	send(clientFd, message.c_str(), message.length(), 0);
-
-	// Send to all users in shared channels
-	std::set<int> notified; // Track who we've notified
-	notified.insert(clientFd);
-
-	for (std::vector<Channel>::iterator chan = channelList.begin();
-	     chan != channelList.end(); ++chan) {
-		if (chan->isMember(clientFd)) {
-			const std::vector<int> &members = chan->getAllMembers();
-			for (size_t i = 0; i < members.size(); i++) {
-				if (notified.find(members[i]) == notified.end()) {
-					send(members[i], message.c_str(), message.length(), 0);
-					notified.insert(members[i]);
-				}
-			}
+	sendToClient(clientFd, message);
+
+	// Send to all users in shared channels who can see the user, once each
+	beginBroadcast();
+	firstDelivery(clientFd);
+
+	const std::set<std::string> &joined = this->Users[clientFd].getChannels();
+	for (std::set<std::string>::const_iterator name = joined.begin(); name != joined.end(); ++name) {
+		std::list<Channel>::iterator chan = findChannel(*name);
+		if (chan == channelList.end())
+			continue;
+		chan->renameMember(clientFd, newNick);
+		const std::set<int> &members = chan->getAudience(clientFd);
+		for (std::set<int>::const_iterator it = members.begin(); it != members.end(); ++it) {
+			if (firstDelivery(*it))
+				sendToClient(*it, message);
 		}
 	}
 }
@@ -144,6 +246,7 @@ void Server::broadcastNickChange(const int &clientFd,
 **  Format: NICK <nickname>
 **
 **  Checks: Format (alphanum, max 9 chars) → Collision (in use?)
+**          → Banned on a channel (+b, not +e, not channel operator)?
 **  Action: Updates nickname and broadcasts change to shared channels.
 **
 ** ============================================================================
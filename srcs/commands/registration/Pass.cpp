@@ -6,7 +6,7 @@
 /*   By: hdelacou <hdelacou@student.42.fr>          +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/12/16 04:08:42 by hdelacou          #+#    #+#             */
-/*   Updated: 2025/12/16 06:28:29 by hdelacou         ###   ########.fr       */
+/*   Updated: 2026/10/19 15:52:09 by adrien           ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -35,11 +35,13 @@ void Server::handlePass(const int &clientFd, const std::string &line) {
 	// Validate password
 	if (password.empty() || password != this->password) {
 		sendERR_PASSWDMISMATCH(clientFd);
+		authFailed(clientFd, "");
 		return;
 	}
 
 	// Password is correct - mark as having valid password
 	this->Users[clientFd].setHasPass();
+	authSucceeded(clientFd, "");
 	std::cout << "Password set for user " << clientFd << std::endl;
 }
 
@@ -6,7 +6,7 @@
 /*   By: hdelacou <hdelacou@student.42.fr>          +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/12/16 05:16:05 by hdelacou          #+#    #+#             */
-/*   Updated: 2025/12/16 06:28:35 by hdelacou         ###   ########.fr       */
+/*   Updated: 2026/10/20 09:41:52 by adrien           ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -46,28 +46,22 @@ std::string Server::parseQuitMessage(const std::string &line) {
 void Server::broadcastQuit(const int &clientFd, const std::string &quitMsg) {
 	User &user = this->Users[clientFd];
 	
-	std::string message = ":";
-	message += user.getNickname() + "!";
-	message += user.getUsername() + "@";
-	message += "localhost QUIT :";
-	message += quitMsg + "\r\n";
-
-	// Track who we've notified (avoid duplicates)
-	std::set<int> notified;
-
-	// Send to all users in shared channels
-	for (std::vector<Channel>::iterator chan = channelList.begin(); 
-	     chan != channelList.end(); ++chan) {
-		if (chan->isMember(clientFd)) {
-			const std::vector<int> &members = chan->getMembers();
-			for (size_t i = 0; i < members.size(); i++) {
-				int memberFd = members[i];
-				// Don't send to quitting user or already notified users
-				if (memberFd != clientFd && notified.find(memberFd) == notified.end()) {
-					send(memberFd, message.c_str(), message.length(), 0);
-					notified.insert(memberFd);
-				}
-			}
+	std::string message = user.getPrefix() + " QUIT :" + quitMsg + "\r\n";
+
+	// Send to all users in shared channels who can see the quitting user,
+	// once each and never to the quitting user
+	beginBroadcast();
+	firstDelivery(clientFd);
+
+	const std::set<std::string> &joined = user.getChannels();
+	for (std::set<std::string>::const_iterator name = joined.begin(); name != joined.end(); ++name) {
+		std::list<Channel>::iterator chan = findChannel(*name);
+		if (chan == channelList.end())
+			continue;
+		const std::set<int> &members = chan->getAudience(clientFd);
+		for (std::set<int>::const_iterator it = members.begin(); it != members.end(); ++it) {
+			if (firstDelivery(*it))
+				sendToClient(*it, message);
 		}
 	}
 }
@@ -78,64 +72,97 @@ void Server::broadcastQuit(const int &clientFd, const std::string &quitMsg) {
 * @return void
 */
 void Server::removeFromAllChannels(const int &clientFd) {
-	for (std::vector<Channel>::iterator chan = channelList.begin(); 
-	     chan != channelList.end(); ) {
-		if (chan->isMember(clientFd)) {
-			chan->removeMember(clientFd);
-			
-			// If channel is now empty, remove it
-			if (chan->isEmpty()) {
-				std::cout << "Removing empty channel: " << chan->getName() << std::endl;
-				chan = channelList.erase(chan);
-				continue;
-			}
-		}
-		++chan;
+	User &user = this->Users[clientFd];
+	const std::set<std::string> &joined = user.getChannels();
+
+	for (std::set<std::string>::const_iterator name = joined.begin(); name != joined.end(); ++name) {
+		std::list<Channel>::iterator chan = findChannel(*name);
+		if (chan == channelList.end())
+			continue;
+		chan->removeMember(clientFd);
+
+		// If channel is now empty, remove it
+		if (chan->isEmpty()) {
+			std::cout << "Removing empty channel: " << chan->getName() << std::endl;
+			eraseChannel(chan);
+		} else
+			this->listIndex.update(*chan);
 	}
+	user.leaveAllChannels();
 }
 
 /*
-* this fonction will handle the QUIT command
+* This function disconnects a client and releases everything it holds
+* Used by QUIT, closed sockets and every server-side disconnection
 * @param clientFd the client file descriptor
-* @param line the line to parse
+* @param reason the quit message broadcast to shared channels
 * @return void
 */
-void Server::handleQuit(const int &clientFd, const std::string &line) {
-	std::string quitMsg = parseQuitMessage(line);
-
-	std::cout << "User " << this->Users[clientFd].getNickname() 
-	          << " (fd: " << clientFd << ") quitting: " 
-	          << quitMsg << std::endl;
-
-	broadcastQuit(clientFd, quitMsg);
+void Server::disconnectUser(const int &clientFd, const std::string &reason) {
+	std::map<int, User>::iterator it = this->Users.find(clientFd);
+	if (it == this->Users.end())
+		return;
+
+	// Mode broadcasts still held must not reach the channels after the QUIT
+	if (!this->modeBatches.empty())
+		flushModeBatches();
+
+	const User &user = it->second;
+	indexNickname(clientFd, user.getNickname(), "");
+	this->listCursors.erase(clientFd);
+	this->whoCursors.erase(clientFd);
+	this->monitors.clear(clientFd);
+	if (it->second.getWelcomeMessage()) {
+		this->userIndex.remove(clientFd, it->second);
+		this->whowas.record(it->second, time(NULL));
+		notifyMonitors(it->second.getNickname(), "");
+	}
+	if (user.getIsRegister()) {
+		broadcastQuit(clientFd, reason);
+		this->lusers.registered--;
+		if (user.isInvisible())
+			this->lusers.invisible--;
+	} else {
+		this->lusers.unknown--;
+	}
+	if (user.isOperator())
+		this->lusers.opers--;
 
 	removeFromAllChannels(clientFd);
+	releaseConnection(user);
+	this->throttled.erase(clientFd);
+	this->pendingDisconnect.erase(clientFd);
 
-	std::string errorMsg = "ERROR :Closing Link: localhost (";
-	errorMsg += quitMsg + ")\r\n";
-	send(clientFd, errorMsg.c_str(), errorMsg.length(), 0);
+	// Last chance for the queued output (ERROR line, ...) to leave
+	const std::string &queue = it->second.getSendQueueRef();
+	if (!queue.empty())
+		send(clientFd, queue.c_str(), queue.length(), MSG_NOSIGNAL);
 
+	epoll_ctl(this->epollFd, EPOLL_CTL_DEL, clientFd, NULL);
 	close(clientFd);
-
-	removeFromPollFds(clientFd);
-
 	this->Users.erase(clientFd);
 
 	std::cout << "Connection closed for fd: " << clientFd << std::endl;
 }
 
 /*
-* This function removes file descriptor from poll monitoring array
+* this fonction will handle the QUIT command
 * @param clientFd the client file descriptor
+* @param line the line to parse
 * @return void
 */
-void Server::removeFromPollFds(const int &clientFd) {
-	for (size_t i = 0; i < this->pollFds.size(); i++) {
-		if (this->pollFds[i].fd == clientFd) {
-			this->pollFds.erase(this->pollFds.begin() + i);
-			break;
-		}
-	}
+void Server::handleQuit(const int &clientFd, const std::string &line) {
+	std::string quitMsg = parseQuitMessage(line);
+
+	std::cout << "User " << this->Users[clientFd].getNickname() 
+	          << " (fd: " << clientFd << ") quitting: " 
+	          << quitMsg << std::endl;
+
+	std::string errorMsg = "ERROR :Closing Link: " + this->Users[clientFd].getHost() + " (";
+	errorMsg += quitMsg + ")\r\n";
+	sendToClient(clientFd, errorMsg);
+
+	disconnectUser(clientFd, quitMsg);
 }
 
 /*
@@ -147,6 +174,7 @@ void Server::removeFromPollFds(const int &clientFd) {
 **
 **  Action: Disconnects user, closes fd, removes from channels/server.
 **  Notify: Broadcasts QUIT message to all users in shared channels.
+**  Counters: disconnectUser() keeps the LUSERS counters in sync.
 **
 ** ============================================================================
 */
@@ -6,7 +6,7 @@
 /*   By: hdelacou <hdelacou@student.42.fr>          +#+  +:+       +#+        */
 /*                                                +#+#+#+#+#+   +#+           */
 /*   Created: 2025/12/16 04:00:00 by hdelacou          #+#    #+#             */
-/*   Updated: 2025/12/16 04:57:48 by hdelacou         ###   ########.fr       */
+/*   Updated: 2026/10/19 20:52:30 by adrien           ###   ########.fr       */
 /*                                                                            */
 /* ************************************************************************** */
 
@@ -45,9 +45,12 @@ void Server::handleUsername(const int &clientFd, const std::string &line) {
 		return;
 	}
 
-	// Set username
+	// Set username, the realname is the trailing parameter
 	user.setUsername(username);
 	user.setHasUsername();
+	size_t colonPos = params.find(" :");
+	if (colonPos != std::string::npos)
+		user.setRealname(params.substr(colonPos + 2));
 
 	std::cout << "[IRC] User " << clientFd << " set username: " << username << std::endl;
 